@@ -0,0 +1,62 @@
+"""
+批量结果传输基准：比较 data.query 结果经 ZeroMQ 发送 JSON 与写列式文件后映射读取的耗时
+用法: python bench/bench_bulk.py [行数]
+"""
+import json
+import mmap
+import os
+import struct
+import sys
+import tempfile
+import time
+
+import numpy as np
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from main import COLUMNAR_MAGIC, encode_message, decode_message, query_bulk, query_chunks  # noqa: E402
+
+
+def bench_json(rows: int) -> float:
+    """一次性返回所有行：序列化 + 反序列化（不含网络传输）"""
+    start = time.perf_counter()
+    chunks = list(query_chunks(rows, rows))
+    payload = encode_message({'status': 'success', 'data': {'chunks': chunks}})
+    decoded, _ = decode_message(payload)
+    elapsed = time.perf_counter() - start
+    print(f"json      {len(payload) / 1048576:8.1f} MB  {elapsed * 1000:9.1f} ms  "
+          f"rows={len(decoded['data']['chunks'][0]['rows'])}")
+    return elapsed
+
+
+def bench_bulk(rows: int) -> float:
+    """写列式文件 + 映射读取一列求和（客户端 ColumnarFile 的读取方式）"""
+    with tempfile.TemporaryDirectory() as bulk_dir:
+        start = time.perf_counter()
+        handle = query_bulk(bulk_dir, rows)
+        written = time.perf_counter()
+        
+        with open(handle['path'], 'rb') as f, mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as m:
+            assert m[:8] == COLUMNAR_MAGIC
+            size = struct.unpack_from('<I', m, 8)[0]
+            meta = json.loads(m[12:12 + size])
+            amount = next(c for c in meta['columns'] if c['name'] == 'amount')
+            total = np.frombuffer(m, dtype='<f8', count=meta['rows'], offset=amount['offset']).sum()
+            del total
+        elapsed = time.perf_counter() - start
+    
+    print(f"columnar  {handle['size'] / 1048576:8.1f} MB  {elapsed * 1000:9.1f} ms  "
+          f"(write {(written - start) * 1000:.1f} ms, map+read {(elapsed - (written - start)) * 1000:.1f} ms)")
+    return elapsed
+
+
+def main():
+    rows = int(sys.argv[1]) if len(sys.argv) > 1 else 1000000
+    print(f"rows={rows}")
+    json_time = bench_json(rows)
+    bulk_time = bench_bulk(rows)
+    print(f"speedup   {json_time / bulk_time:.1f}x")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,71 @@
+"""
+消息编码基准：比较 JSON 与 CBOR 的编解码吞吐
+用法: python bench/bench_codec.py [行数] [轮数]
+"""
+import os
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from main import SUPPORTED_ENCODINGS, decode_message, encode_message  # noqa: E402
+
+
+def build_query_reply(rows: int) -> dict:
+    """构造与 data.query 响应形状一致的交易明细"""
+    banks = ['中国工商银行', '中国建设银行', '中国农业银行', '招商银行']
+    records = [
+        {
+            'txn_id': 1000000 + i,
+            'account': f"6222{i % 500:012d}",
+            'counterparty': f"6217{(i * 7) % 2000:012d}",
+            'bank': banks[i % 4],
+            'txn_time': f"2024-{1 + i % 12:02d}-{1 + i % 28:02d} 10:{i % 60:02d}:00",
+            'amount': (i % 1000) * 13.37,
+            'direction': 'out' if i % 2 else 'in',
+            'balance': 50000.0 + i * 0.5,
+            'memo': '转账',
+        }
+        for i in range(rows)
+    ]
+    return {
+        'msg_id': 'bench',
+        'status': 'success',
+        'code': 200,
+        'data': {'records': records, 'total': rows},
+    }
+
+
+def run_case(reply: dict, encoding: str, rounds: int):
+    start = time.perf_counter()
+    for _ in range(rounds):
+        encoded = encode_message(reply, encoding)
+    encode_s = (time.perf_counter() - start) / rounds
+
+    start = time.perf_counter()
+    for _ in range(rounds):
+        decoded, _ = decode_message(encoded)
+    decode_s = (time.perf_counter() - start) / rounds
+
+    mb = len(encoded) / (1024 * 1024)
+    print(f"{encoding:<5} size={len(encoded) / 1024:9.2f} KB  "
+          f"encode={encode_s * 1000:8.2f} ms ({mb / encode_s:7.1f} MB/s)  "
+          f"decode={decode_s * 1000:8.2f} ms ({mb / decode_s:7.1f} MB/s)  "
+          f"rows={len(decoded['data']['records'])}")
+
+
+def main():
+    rows = int(sys.argv[1]) if len(sys.argv) > 1 else 100000
+    rounds = int(sys.argv[2]) if len(sys.argv) > 2 else 5
+
+    reply = build_query_reply(rows)
+    print(f"rows={rows} rounds={rounds}")
+    for encoding in ('json', 'cbor'):
+        if encoding not in SUPPORTED_ENCODINGS:
+            print(f"{encoding:<5} skipped (not installed)")
+            continue
+        run_case(reply, encoding, rounds)
+
+
+if __name__ == '__main__':
+    main()
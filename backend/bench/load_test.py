@@ -0,0 +1,100 @@
+"""
+worker 进程池负载测试：多个客户端并发发送 CPU 密集请求，比较不同 worker 数的吞吐
+用法: python bench/load_test.py [请求数] [客户端数] [worker 数列表，如 0,1,2,4]
+"""
+import hashlib
+import os
+import sys
+import time
+import uuid
+from threading import Thread
+
+import zmq
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from main import ZmqServer, decode_message, encode_message  # noqa: E402
+
+REQ_PORT = 25555
+PUB_PORT = 25556
+WINDOW = 8  # 每个客户端同时在途的请求数
+
+
+def handle_cpu(params: dict) -> dict:
+    """模拟导入解析等 CPU 密集处理：反复计算 SHA-256"""
+    digest = b''
+    for _ in range(params.get('rounds', 20000)):
+        digest = hashlib.sha256(digest).digest()
+    return {'digest': digest.hex()}
+
+
+def run_client(count: int, latencies: list):
+    """单个客户端：保持 WINDOW 个在途请求，直到收齐 count 个响应"""
+    context = zmq.Context.instance()
+    socket = context.socket(zmq.DEALER)
+    socket.connect(f"tcp://127.0.0.1:{REQ_PORT}")
+
+    sent_at = {}
+    sent = received = 0
+    while received < count:
+        while sent < count and len(sent_at) < WINDOW:
+            msg_id = uuid.uuid4().hex
+            request = {'msg_id': msg_id, 'action': 'bench.cpu', 'params': {}}
+            socket.send_multipart([b'', encode_message(request)])
+            sent_at[msg_id] = time.perf_counter()
+            sent += 1
+
+        reply, _ = decode_message(socket.recv_multipart()[-1])
+        if reply['status'] != 'success':
+            raise RuntimeError(reply['message'])
+        latencies.append(time.perf_counter() - sent_at.pop(reply['msg_id']))
+        received += 1
+
+    socket.close()
+
+
+def run_round(workers: int, requests: int, clients: int) -> tuple:
+    """启动指定 worker 数的服务端，返回 (吞吐, p99 延迟毫秒)"""
+    server = ZmqServer(req_port=REQ_PORT, pub_port=PUB_PORT, workers=workers)
+    server.register_handler('bench.cpu', handle_cpu)
+    server.start()
+
+    # 预热：等待 worker 进程启动完毕
+    run_client(max(workers, 1) * 2, [])
+
+    latencies = []
+    per_client = requests // clients
+    threads = [Thread(target=run_client, args=(per_client, latencies)) for _ in range(clients)]
+    start = time.perf_counter()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.perf_counter() - start
+
+    server.stop()
+
+    latencies.sort()
+    p99 = latencies[int(len(latencies) * 0.99) - 1] * 1000
+    return len(latencies) / elapsed, p99
+
+
+def main():
+    requests = int(sys.argv[1]) if len(sys.argv) > 1 else 400
+    clients = int(sys.argv[2]) if len(sys.argv) > 2 else 4
+    if len(sys.argv) > 3:
+        worker_counts = [int(n) for n in sys.argv[3].split(',')]
+    else:
+        worker_counts = sorted({0, 1, 2, min(4, os.cpu_count() or 1)})
+
+    print(f"{requests} requests, {clients} clients, window {WINDOW}")
+    print(f"{'workers':>8} {'req/s':>10} {'p99 ms':>10} {'speedup':>8}")
+    baseline = None
+    for workers in worker_counts:
+        rps, p99 = run_round(workers, requests, clients)
+        baseline = baseline or rps
+        print(f"{workers:>8} {rps:>10.1f} {p99:>10.1f} {rps / baseline:>7.2f}x")
+
+
+if __name__ == '__main__':
+    main()
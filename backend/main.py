@@ -6,9 +6,38 @@ import json
 import logging
 import time
 import hashlib
+import inspect
+import multiprocessing
+import os
 import uuid
-from threading import Thread
-from typing import Callable, Dict, Any
+import argparse
+import contextlib
+import contextvars
+import struct
+import zlib
+from collections import deque
+from threading import Condition, Event, Lock, Thread, get_native_id
+from typing import Callable, Dict, Any, List, NamedTuple, Optional, Tuple
+
+try:
+    import numpy as np
+except ImportError:  # 未安装 numpy 时不提供列式批量结果
+    np = None
+
+try:
+    import cbor2
+except ImportError:  # 未安装 cbor2 时只支持 JSON
+    cbor2 = None
+
+try:
+    import lz4.block
+except ImportError:  # 未安装时不提供 lz4 压缩
+    lz4 = None
+
+try:
+    import zstandard
+except ImportError:  # 未安装时不提供 zstd 压缩
+    zstandard = None
 
 logging.basicConfig(
     level=logging.INFO,
@@ -16,97 +45,633 @@ logging.basicConfig(
 )
 logger = logging.getLogger(__name__)
 
+# 支持的消息编码（按优先级排列）
+SUPPORTED_ENCODINGS = ['cbor', 'json'] if cbor2 else ['json']
+
+
+def decode_message(data: bytes) -> Tuple[Any, str]:
+    """解码消息，按首字节识别压缩与编码（CBOR map 为 0xA0-0xBF，JSON 以 '{' 开头）"""
+    if data and data[0] == COMPRESS_MAGIC:
+        data = decompress_payload(data)
+    if data and (data[0] & 0xE0) == 0xA0 and cbor2:
+        return cbor2.loads(data), 'cbor'
+    return json.loads(data), 'json'
+
+
+def encode_message(message: Any, encoding: str = 'json') -> bytes:
+    """按指定编码序列化消息"""
+    if encoding == 'cbor' and cbor2:
+        return cbor2.dumps(message)
+    return json.dumps(message).encode('utf-8')
+
+
+# 压缩帧：[0xFC][算法][原始长度 uint32 LE][压缩数据]
+# 0xFC 既不是 JSON 的 '{' 也不在 CBOR map 的首字节范围内，解码时可直接识别
+COMPRESS_MAGIC = 0xFC
+COMPRESS_HEADER = struct.Struct('<BBI')
+COMPRESS_IDS = {'zlib': 1, 'lz4': 2, 'zstd': 3}
+COMPRESS_NAMES = {v: k for k, v in COMPRESS_IDS.items()}
+
+# 单条消息解压后的上限（与客户端一致），防止伪造的长度字段或压缩炸弹导致超大分配
+MAX_DECOMPRESSED_SIZE = 1024 * 1024 * 1024
+
+# 支持的压缩算法（按优先级排列），zlib 为标准库，总是可用
+SUPPORTED_COMPRESSIONS = ([name for name, lib in (('zstd', zstandard), ('lz4', lz4)) if lib]
+                          + ['zlib'])
+
+
+def compress_payload(data: bytes, algorithm: str, level: int) -> bytes:
+    """压缩并加上压缩帧头"""
+    if algorithm == 'zstd':
+        body = zstandard.ZstdCompressor(level=level).compress(data)
+    elif algorithm == 'lz4':
+        mode = 'high_compression' if level > 0 else 'default'
+        body = lz4.block.compress(data, mode=mode, compression=max(level, 0), store_size=False)
+    else:
+        body = zlib.compress(data, level)
+    return COMPRESS_HEADER.pack(COMPRESS_MAGIC, COMPRESS_IDS[algorithm], len(data)) + body
 
-class ZmqServer:
-    """ZeroMQ 服务端"""
+
+def decompress_payload(data: bytes) -> bytes:
+    """解压带压缩帧头的消息，输出不超过帧头声明的原始长度"""
+    _, algorithm_id, size = COMPRESS_HEADER.unpack_from(data)
+    if size > MAX_DECOMPRESSED_SIZE:
+        raise ValueError(f"Decompressed size too large: {size}")
+    body = data[COMPRESS_HEADER.size:]
+    algorithm = COMPRESS_NAMES.get(algorithm_id)
+    if algorithm == 'zstd' and zstandard:
+        return zstandard.ZstdDecompressor().decompress(body, max_output_size=size)
+    if algorithm == 'lz4' and lz4:
+        return lz4.block.decompress(body, uncompressed_size=size)
+    if algorithm == 'zlib':
+        # 最多解出 size 字节，还有未消耗的输入说明实际数据比声明的大，拒绝该帧；
+        # max_length 为 0 表示不限制，声明长度为 0 时不调用解压
+        if size == 0:
+            if body:
+                raise ValueError("Decompressed size does not match header")
+            return b''
+        decompressor = zlib.decompressobj()
+        raw = decompressor.decompress(body, size)
+        if decompressor.unconsumed_tail or len(raw) != size:
+            raise ValueError("Decompressed size does not match header")
+        return raw
+    raise ValueError(f"Unsupported compression: {algorithm_id}")
+
+
+class CompressionStats:
+    """按动作统计压缩比与 CPU 耗时，每个动作每 REPORT_EVERY 条消息输出一次"""
     
-    def __init__(self, req_port=5555, pub_port=5556):
-        self.context = zmq.Context()
+    REPORT_EVERY = 100
+    
+    def __init__(self):
+        self.lock = Lock()
+        self.actions: Dict[str, list] = {}  # action -> [消息数, 原始字节, 压缩后字节, 耗时秒]
+    
+    def compress(self, action: str, data: bytes, algorithm: str, level: int) -> bytes:
+        """压缩并记录；压缩后不比原始数据小时原样返回"""
+        start = time.perf_counter()
+        compressed = compress_payload(data, algorithm, level)
+        elapsed = time.perf_counter() - start
         
-        # REP socket（处理请求）
-        self.rep_socket = self.context.socket(zmq.REP)
-        self.rep_socket.bind(f"tcp://*:{req_port}")
+        with self.lock:
+            stats = self.actions.setdefault(action, [0, 0, 0, 0.0])
+            stats[0] += 1
+            stats[1] += len(data)
+            stats[2] += min(len(compressed), len(data))
+            stats[3] += elapsed
+            if stats[0] % self.REPORT_EVERY == 1:
+                logger.info(f"Compression [{action}] {algorithm}: {stats[0]} msgs, "
+                            f"ratio {stats[1] / max(stats[2], 1):.2f}, "
+                            f"{stats[3] / stats[0] * 1e6:.0f} us/msg")
         
-        # PUB socket（推送通知）
-        self.pub_socket = self.context.socket(zmq.PUB)
-        self.pub_socket.bind(f"tcp://*:{pub_port}")
+        return compressed if len(compressed) < len(data) else data
+
+
+# 列式结果文件（同机批量数据通道，客户端内存映射后零拷贝读取）：
+#   [0, 8)    魔数 b'FACOL01\0'
+#   [8, 12)   元数据长度 N（uint32 LE）
+#   [12, 12+N) JSON 元数据 {"rows": R, "columns": [{"name", "type", "offset", "length",
+#             "data_offset", "data_length"}]}
+#   之后各列缓冲区按 64 字节对齐依次存放，数值均为小端：
+#     int64 / float64: R 个定长值
+#     string: R+1 个 int64 偏移（offset/length）+ UTF-8 数据（data_offset/data_length）
+COLUMNAR_MAGIC = b'FACOL01\0'
+COLUMNAR_ALIGN = 64
+
+
+def write_columnar(path: str, columns: Dict[str, Any]) -> dict:
+    """把各列写入列式结果文件，返回发给客户端的句柄
+
+    columns: 列名 -> numpy 数组或列表；整数、浮点以外的列按字符串写出
+    """
+    buffers = []   # (元数据, [缓冲区...])
+    rows = None
+    for name, values in columns.items():
+        array = np.asarray(values)
+        if rows is None:
+            rows = len(array)
+        elif len(array) != rows:
+            raise ValueError(f"Column length mismatch: {name}")
         
+        if array.dtype.kind in 'iub':
+            buffers.append(({'name': name, 'type': 'int64'}, [array.astype('<i8', copy=False)]))
+        elif array.dtype.kind == 'f':
+            buffers.append(({'name': name, 'type': 'float64'}, [array.astype('<f8', copy=False)]))
+        else:
+            encoded = [('' if v is None else str(v)).encode('utf-8') for v in values]
+            offsets = np.zeros(len(encoded) + 1, dtype='<i8')
+            np.cumsum([len(v) for v in encoded], out=offsets[1:])
+            buffers.append(({'name': name, 'type': 'string'}, [offsets, b''.join(encoded)]))
+    
+    # 先算出各缓冲区偏移，元数据长度变化会影响偏移，迭代到稳定
+    def align(n):
+        return (n + COLUMNAR_ALIGN - 1) // COLUMNAR_ALIGN * COLUMNAR_ALIGN
+    
+    meta_size = 0
+    while True:
+        position = align(12 + meta_size)
+        for meta, parts in buffers:
+            keys = ('offset', 'length') if len(parts) == 1 else ('offset', 'length', 'data_offset', 'data_length')
+            for i, part in enumerate(parts):
+                size = memoryview(part).nbytes
+                meta[keys[i * 2]] = position
+                meta[keys[i * 2 + 1]] = size
+                position = align(position + size)
+        metadata = json.dumps({'rows': rows or 0, 'columns': [m for m, _ in buffers]}).encode('utf-8')
+        if len(metadata) == meta_size:
+            break
+        meta_size = len(metadata)
+    
+    # 先写临时文件再改名，客户端不会读到写了一半的文件；写入失败时删除临时文件
+    temp_path = path + '.tmp'
+    try:
+        with open(temp_path, 'wb') as f:
+            f.write(COLUMNAR_MAGIC)
+            f.write(struct.pack('<I', len(metadata)))
+            f.write(metadata)
+            for meta, parts in buffers:
+                keys = ('offset', 'data_offset')
+                for i, part in enumerate(parts):
+                    f.write(b'\0' * (meta[keys[i]] - f.tell()))
+                    f.write(memoryview(part))
+            f.write(b'\0' * (position - f.tell()))
+        os.replace(temp_path, path)
+    except BaseException:
+        with contextlib.suppress(OSError):
+            os.remove(temp_path)
+        raise
+    
+    return {
+        'path': path,
+        'rows': rows or 0,
+        'size': position,
+        'columns': [m['name'] for m, _ in buffers]
+    }
+
+
+# 通知主题：全局通知（缓存失效、系统消息）与单个任务的通知（task:<任务ID>，如进度）
+GLOBAL_TOPIC = 'global'
+
+
+def task_topic(task_id: str) -> str:
+    """任务通知主题，只有打开了该任务工作区的客户端订阅"""
+    return f"task:{task_id}"
+
+
+# 当前请求所在分发器的发布函数，由分发器在调用处理器前设置（worker 中经 broker 转发）
+_publisher: contextvars.ContextVar[Optional[Callable]] = contextvars.ContextVar('publisher', default=None)
+
+
+def publish_task_event(task_id: str, notification_type: str, data: dict):
+    """在任务主题上发布通知（如进度），只有打开了该任务工作区的客户端收到"""
+    publish = _publisher.get()
+    if publish is None or not task_id:
+        return
+    publish(notification_type, dict(data, task_id=task_id), task_topic(task_id))
+
+
+# 请求取消：客户端发送 {"action": "cancel", "msg_id": 目标请求}，服务端不回复
+CANCEL_ACTION = 'cancel'
+
+# 流式响应的消费确认：客户端每处理完一个分块发送 {"action": "stream.ack", "msg_id": 目标请求, "seq": 分块序号}，
+# 服务端不回复；请求带 stream_window 时，已发送未确认的分块不超过该数目，客户端长时间不确认则放弃该流
+STREAM_ACK_ACTION = 'stream.ack'
+STREAM_ACK_TIMEOUT = 30.0
+
+# 当前请求的取消标记，由分发器在调用处理器前设置
+_cancel_event: contextvars.ContextVar[Optional[Event]] = contextvars.ContextVar('cancel_event', default=None)
+
+
+class RequestCancelled(Exception):
+    """请求已被客户端取消"""
+
+
+def is_cancelled() -> bool:
+    """当前请求是否已被客户端取消"""
+    event = _cancel_event.get()
+    return event is not None and event.is_set()
+
+
+def check_cancelled():
+    """长耗时处理器的取消检查点：请求已取消时抛出 RequestCancelled，结束处理"""
+    if is_cancelled():
+        raise RequestCancelled()
+
+
+# 端到端追踪：请求带 trace_id 时记录处理区间（Chrome trace 事件），随响应的 trace 字段带回客户端
+MAX_TRACE_SPANS = 1000
+
+
+class TraceContext:
+    """一个请求内记录的区间；时间戳为系统时钟微秒，与客户端的追踪时间轴一致"""
+
+    def __init__(self, trace_id: str):
+        self.trace_id = trace_id
+        self.start_us = time.time_ns() // 1000
+        self.spans: List[dict] = []
+
+    def add(self, name: str, start_us: int, end_us: int, args: Optional[dict] = None):
+        if len(self.spans) >= MAX_TRACE_SPANS:
+            return
+        span = {
+            'name': name, 'cat': 'backend', 'ph': 'X',
+            'ts': start_us, 'dur': max(end_us - start_us, 0),
+            'pid': os.getpid(), 'tid': get_native_id()
+        }
+        if args:
+            span['args'] = args
+        self.spans.append(span)
+
+    def attach(self, response: dict, action: Optional[str]):
+        """记录整个请求的区间，并把所有区间放入响应"""
+        self.add(f"backend:{action}", self.start_us, time.time_ns() // 1000)
+        response['trace'] = {'trace_id': self.trace_id, 'spans': self.spans}
+
+
+_trace: contextvars.ContextVar[Optional[TraceContext]] = contextvars.ContextVar('trace', default=None)
+
+
+@contextlib.contextmanager
+def trace_span(name: str, **args):
+    """在当前请求的追踪中记录一个区间；请求未开启追踪时不做任何事"""
+    trace = _trace.get()
+    if trace is None:
+        yield
+        return
+    start = time.time_ns() // 1000
+    try:
+        yield
+    finally:
+        trace.add(name, start, time.time_ns() // 1000, args)
+
+
+class WireFormat(NamedTuple):
+    """响应格式：编码与请求一致，压缩算法由请求的 compress 字段指定"""
+    encoding: str = 'json'
+    compression: Optional[str] = None
+    action: Optional[str] = None  # 按动作统计压缩效果
+    lane: str = 'interactive'     # 请求来自哪个通道，响应从同一通道返回
+
+
+class RequestDispatcher:
+    """请求分发：处理器注册表与消息处理逻辑，服务端和各 worker 进程共用"""
+    
+    # 内置动作，由每个分发器自行注册，不随注册表传给 worker
+    BUILTIN_ACTIONS = ('session.hello', 'batch')
+    
+    def __init__(self):
         self.handlers: Dict[str, Callable] = {}
-        self.running = False
+        self.invalidates: Dict[str, List[str]] = {}
+        self.inline = set()
+        
+        # 正在处理的请求：(客户端标识, msg_id) -> 取消标记
+        self.active: Dict[Tuple[bytes, str], Event] = {}
+        self.active_lock = Lock()
+        
+        # 正在发送的流式响应：(客户端标识, msg_id) -> 客户端已确认的分块数
+        self.stream_acks: Dict[Tuple[bytes, str], int] = {}
+        self.stream_credit = Condition()
         
-        logger.info(f"ZeroMQ Server started on ports {req_port} (REP) and {pub_port} (PUB)")
+        # 超过阈值的响应按请求指定的算法压缩，通知固定使用各端都支持的 zlib
+        self.compression_level = 3
+        self.compression_threshold = 4096
+        self.publish_compression = 'zlib'
+        self.compression_stats = CompressionStats()
+        
+        # 内置处理器：连接时协商消息编码、批量请求
+        self.register_handler('session.hello', self._handle_hello, inline=True)
+        self.register_handler('batch', self._handle_batch)
     
-    def register_handler(self, action: str, handler: Callable):
-        """注册消息处理器"""
+    def register_handler(self, action: str, handler: Callable,
+                         invalidates: Optional[List[str]] = None,
+                         inline: bool = False):
+        """注册消息处理器
+        
+        invalidates: 该动作成功后需要客户端缓存失效的只读动作
+        inline: 在服务端主进程中执行（依赖进程内状态的处理器，如会话）；
+                其余处理器在 worker 进程中执行，必须是模块级函数
+        """
         self.handlers[action] = handler
+        if invalidates:
+            self.invalidates[action] = list(invalidates)
+        if inline:
+            self.inline.add(action)
         logger.info(f"Registered handler for action: {action}")
     
-    def start(self):
-        """启动服务"""
-        self.running = True
+    def configure_compression(self, level: int, threshold: int):
+        """设置压缩级别与阈值（字节）"""
+        self.compression_level = level
+        self.compression_threshold = threshold
+    
+    def _send(self, envelope: list, response: dict, fmt: WireFormat):
+        """发送响应（由子类实现）"""
+        raise NotImplementedError
+    
+    def _encode_reply(self, response: dict, fmt: WireFormat) -> bytes:
+        """序列化响应，超过阈值且客户端接受时压缩"""
+        payload = encode_message(response, fmt.encoding)
+        if fmt.compression in COMPRESS_IDS and len(payload) >= self.compression_threshold:
+            payload = self.compression_stats.compress(fmt.action, payload, fmt.compression,
+                                                      self.compression_level)
+        return payload
+    
+    def publish(self, notification_type: str, data: dict, topic: str = GLOBAL_TOPIC):
+        """发布通知（由子类实现）"""
+        raise NotImplementedError
+    
+    def _handle_message(self, envelope: list, message: bytes, lane: str = 'interactive'):
+        """解析请求、调用处理器并发送响应"""
+        try:
+            logger.debug(f"Received message: {message[:100]}...")
+            request, encoding = decode_message(message)
+        except Exception as e:
+            logger.error(f"Server error: {e}", exc_info=True)
+            self._send(envelope, self._build_response(
+                None, 'error',
+                message="Internal server error",
+                code=500
+            ), WireFormat(lane=lane))
+            return
         
-        # 在独立线程中运行
-        thread = Thread(target=self._run_loop, daemon=True)
-        thread.start()
+        if not isinstance(request, dict):
+            self._send(envelope, self._build_invalid_request(), WireFormat(encoding, lane=lane))
+            return
+        self._handle_request(envelope, request, encoding, lane)
+    
+    def _handle_request(self, envelope: list, request: dict, encoding: str,
+                        lane: str = 'interactive'):
+        """调用处理器并发送响应；流式请求的生成器结果逐块发送"""
+        fmt = WireFormat(encoding, request.get('compress'), request.get('action'), lane)
+        key = self._request_key(envelope, request)
+        if fmt.action == CANCEL_ACTION:
+            self._cancel(key, lane)
+            return
+        if fmt.action == STREAM_ACK_ACTION:
+            self._stream_ack(key, request.get('seq'), lane)
+            return
         
-        logger.info("ZeroMQ Server is running...")
+        # 处理期间登记取消标记，处理器通过 check_cancelled() 协作检查
+        event = Event()
+        with self.active_lock:
+            self.active[key] = event
+        token = _cancel_event.set(event)
+        trace = TraceContext(request['trace_id']) if request.get('trace_id') else None
+        trace_token = _trace.set(trace)
+        publisher_token = _publisher.set(self.publish)
+        try:
+            action = request.get('action')
+            params = request.get('params', {})
+            msg_id = request.get('msg_id')
+            
+            response = self._dispatch(msg_id, action, params, stream=bool(request.get('stream')))
+            if inspect.isgenerator(response):
+                window = request.get('stream_window')
+                self._send_stream(envelope, key, response, fmt,
+                                  window if isinstance(window, int) and window > 0 else 0)
+                return
+            
+        except Exception as e:
+            logger.error(f"Server error: {e}", exc_info=True)
+            response = self._build_response(
+                None, 'error',
+                message="Internal server error",
+                code=500
+            )
+        finally:
+            _publisher.reset(publisher_token)
+            _trace.reset(trace_token)
+            _cancel_event.reset(token)
+            with self.active_lock:
+                self.active.pop(key, None)
+        
+        if trace is not None:
+            trace.attach(response, fmt.action)
+        self._send(envelope, response, fmt)
     
-    def _run_loop(self):
-        """消息处理循环"""
-        while self.running:
-            try:
-                # 接收请求
-                message = self.rep_socket.recv_string()
-                logger.debug(f"Received message: {message[:100]}...")
-                
-                # 解析请求
-                request = json.loads(message)
-                action = request.get('action')
-                params = request.get('params', {})
-                msg_id = request.get('msg_id')
+    @staticmethod
+    def _request_key(envelope: list, request: dict) -> Tuple[bytes, str]:
+        """请求标识：客户端路由标识 + msg_id（客户端只能取消自己的请求）"""
+        return (envelope[0] if envelope else b'', request.get('msg_id'))
+    
+    def _cancel(self, key: Tuple[bytes, str], lane: str):
+        """处理 cancel 控制消息"""
+        self.cancel_request(key)
+    
+    def _stream_ack(self, key: Tuple[bytes, str], seq, lane: str):
+        """处理 stream.ack 控制消息"""
+        self.stream_ack(key, seq)
+    
+    def stream_ack(self, key: Tuple[bytes, str], seq):
+        """记录客户端已消费到第 seq 个分块，唤醒等待发送额度的流；不属于本分发器的流直接忽略"""
+        if not isinstance(seq, int):
+            return
+        with self.stream_credit:
+            if key in self.stream_acks:
+                self.stream_acks[key] = max(self.stream_acks[key], seq + 1)
+                self.stream_credit.notify_all()
+    
+    def _wait_stream_credit(self, key: Tuple[bytes, str], seq: int, window: int) -> bool:
+        """等待客户端确认，直到可以发送第 seq 个分块；请求被取消时立即返回，超时返回 False"""
+        deadline = time.monotonic() + STREAM_ACK_TIMEOUT
+        with self.stream_credit:
+            while self.stream_acks.get(key, 0) + window <= seq:
+                remaining = deadline - time.monotonic()
+                if is_cancelled():
+                    return True
+                if remaining <= 0:
+                    return False
+                # 取消只设置事件、不通知条件变量，分段等待以便及时发现
+                self.stream_credit.wait(min(remaining, 0.1))
+        return True
+    
+    def cancel_request(self, key: Tuple[bytes, str]) -> bool:
+        """设置正在处理的请求的取消标记，处理器在下一个检查点退出"""
+        with self.active_lock:
+            event = self.active.get(key)
+        if event is None:
+            return False
+        event.set()
+        logger.info(f"Cancelling request {key[1]}")
+        return True
+    
+    def _dispatch(self, msg_id, action: str, params: dict, stream: bool = False):
+        """调用处理器并构建响应；stream 为真时原样返回生成器结果"""
+        if action not in self.handlers:
+            return self._build_response(
+                msg_id, 'error',
+                message=f"Unknown action: {action}",
+                code=404
+            )
+        
+        start = time.perf_counter()
+        try:
+            check_cancelled()
+            with trace_span(f"handler:{action}"):
+                result = self.handlers[action](params)
+            
+            # 生成器结果：非流式请求合并为一次响应
+            if inspect.isgenerator(result):
+                if stream:
+                    return result
+                result = {'chunks': list(result)}
+            
+            # 写操作成功后通知客户端丢弃相关缓存；响应本身也带上失效列表，
+            # 发起请求的客户端不依赖通知与响应的到达顺序
+            response = self._build_response(msg_id, 'success', result)
+            if action in self.invalidates:
+                self.publish('cache.invalidate', {'actions': self.invalidates[action]})
+                response['invalidates'] = self.invalidates[action]
+        except RequestCancelled:
+            logger.info(f"Handler cancelled: {action}")
+            response = self._build_cancelled(msg_id)
+        except Exception as e:
+            logger.error(f"Handler error: {e}", exc_info=True)
+            response = self._build_response(
+                msg_id, 'error', 
+                message=str(e), 
+                code=500
+            )
+        
+        # 处理器耗时随响应返回，客户端据此区分后端处理与网络等待
+        response['handler_us'] = int((time.perf_counter() - start) * 1e6)
+        return response
+    
+    def _send_stream(self, envelope: list, key: Tuple[bytes, str], chunks, fmt: WireFormat,
+                     window: int = 0):
+        """逐块发送生成器产出的结果，最后发送结束标记（带各分块生成耗时之和）
+        
+        window 大于 0 时按客户端的 stream.ack 控制发送：已发送未确认的分块达到 window 就暂停生成，
+        慢消费者只拖慢自己的流，不会让分块堆积在 broker 或 socket 队列中
+        """
+        msg_id = key[1]
+        seq = 0
+        handler_time = 0.0
+        exhausted = object()
+        with self.stream_credit:
+            self.stream_acks[key] = 0
+        try:
+            while True:
+                if window and not self._wait_stream_credit(key, seq, window):
+                    logger.warning(f"Stream abandoned after {seq} chunks: no acknowledgement from client")
+                    chunks.close()
+                    return
                 
-                # 调用处理器
-                if action in self.handlers:
-                    try:
-                        result = self.handlers[action](params)
-                        response = self._build_response(msg_id, 'success', result)
-                    except Exception as e:
-                        logger.error(f"Handler error: {e}", exc_info=True)
-                        response = self._build_response(
-                            msg_id, 'error', 
-                            message=str(e), 
-                            code=500
-                        )
-                else:
-                    response = self._build_response(
-                        msg_id, 'error',
-                        message=f"Unknown action: {action}",
-                        code=404
-                    )
+                # 每个分块之间检查取消，关闭生成器以释放查询游标等资源
+                if is_cancelled():
+                    chunks.close()
+                    raise RequestCancelled()
                 
-                # 发送响应
-                self.rep_socket.send_string(json.dumps(response))
+                start = time.perf_counter()
+                chunk = next(chunks, exhausted)
+                handler_time += time.perf_counter() - start
+                if chunk is exhausted:
+                    break
                 
-            except Exception as e:
-                logger.error(f"Server error: {e}", exc_info=True)
-                error_response = self._build_response(
+                response = self._build_response(msg_id, 'success', chunk)
+                response['stream'] = {'seq': seq, 'final': False}
+                self._send(envelope, response, fmt)
+                seq += 1
+            end = self._build_response(msg_id, 'success', {'chunks': seq})
+        except zmq.ZMQError as e:
+            # 客户端断开或长时间不读取，放弃剩余分块
+            logger.warning(f"Stream aborted after {seq} chunks: {e}")
+            chunks.close()
+            return
+        except RequestCancelled:
+            logger.info(f"Stream cancelled after {seq} chunks")
+            end = self._build_cancelled(msg_id)
+        except Exception as e:
+            logger.error(f"Handler error: {e}", exc_info=True)
+            end = self._build_response(msg_id, 'error', message=str(e), code=500)
+        finally:
+            with self.stream_credit:
+                self.stream_acks.pop(key, None)
+        
+        end['stream'] = {'seq': seq, 'final': True}
+        end['handler_us'] = int(handler_time * 1e6)
+        trace = _trace.get()
+        if trace is not None:
+            trace.attach(end, fmt.action)
+        self._send(envelope, end, fmt)
+    
+    def _handle_hello(self, params: dict) -> dict:
+        """编码协商：选出客户端与服务端都支持的首选编码和压缩算法"""
+        offered = params.get('encodings', ['json'])
+        encoding = next((e for e in offered if e in SUPPORTED_ENCODINGS), 'json')
+        compression = next((c for c in params.get('compression', [])
+                            if c in SUPPORTED_COMPRESSIONS), None)
+        logger.info(f"Client negotiated encoding: {encoding}, compression: {compression}")
+        return {
+            'encoding': encoding,
+            'encodings': SUPPORTED_ENCODINGS,
+            'compression': compression,
+            'compressions': SUPPORTED_COMPRESSIONS
+        }
+    
+    def _is_batchable(self, action: str) -> bool:
+        """批量请求中允许出现的动作"""
+        return action != 'batch'
+    
+    def _handle_batch(self, params: dict) -> dict:
+        """批量请求：依次执行各子请求，结果按顺序返回且各带独立状态"""
+        results = []
+        for item in params.get('requests', []):
+            check_cancelled()
+            action = item.get('action')
+            if not self._is_batchable(action):
+                results.append(self._build_response(
                     None, 'error',
-                    message="Internal server error",
-                    code=500
-                )
-                self.rep_socket.send_string(json.dumps(error_response))
+                    message=f"Action cannot be batched: {action}",
+                    code=400
+                ))
+                continue
+            results.append(self._dispatch(None, action, item.get('params', {})))
+        
+        return {'results': results}
     
-    def publish(self, notification_type: str, data: dict, topic: str = ""):
-        """发布通知"""
+    def _format_notification(self, notification_type: str, data: dict, topic: str) -> List[bytes]:
+        """序列化通知消息为 [主题帧, 正文帧]，正文超过阈值时压缩"""
         notification = {
             'type': notification_type,
             'data': data,
             'timestamp': int(time.time())
         }
         
-        message = f"{topic}:{json.dumps(notification)}" if topic else json.dumps(notification)
-        self.pub_socket.send_string(message)
-        logger.debug(f"Published notification: {notification_type}")
+        payload = encode_message(notification)
+        if len(payload) >= self.compression_threshold:
+            payload = self.compression_stats.compress(f"notify:{notification_type}", payload,
+                                                      self.publish_compression,
+                                                      self.compression_level)
+        
+        return [topic.encode('utf-8'), payload]
+    
+    def _build_invalid_request(self):
+        """请求正文不是对象（如数组、字符串、数字）时的响应"""
+        return self._build_response(None, 'error', message="Invalid request: expected an object", code=400)
+    
+    def _build_cancelled(self, msg_id):
+        """已取消请求的响应（客户端已放弃该请求，通常直接丢弃）"""
+        return self._build_response(msg_id, 'error', message="Request cancelled", code=499)
     
     def _build_response(self, msg_id, status, data=None, message="", code=200):
         """构建响应消息"""
@@ -119,16 +684,506 @@ class ZmqServer:
             'message': message,
             'error': None if status == 'success' else message
         }
+
+
+# broker 与 worker 之间的控制帧
+WORKER_READY = b'\x01'
+WORKER_REPLY = b'\x02'
+
+# broker 广播给 worker 的控制消息：[类型, 客户端标识, msg_id, 参数]
+CONTROL_CANCEL = b'C'
+CONTROL_ACK = b'A'      # 参数为已确认的分块序号
+
+
+class ZmqServer(RequestDispatcher):
+    """ZeroMQ 服务端
+    
+    请求分两个通道：interactive（req_port）与 bulk（bulk_port），各自有 ROUTER 前端、
+    请求队列和 worker 进程池，批量导入等耗时请求不会占用交互请求的 worker。
+    有 worker 的通道作为 broker 按 LRU 分发；没有 worker 的通道与 inline 处理器在本进程处理。
+    """
+    
+    # 每个客户端在 socket 中最多积压的响应帧数
+    STREAM_SNDHWM = 16
+    # 检查 worker 进程是否存活的间隔（秒）
+    WORKER_CHECK_INTERVAL = 1.0
+    # socket 发送队列满后在 broker 中继续排队的帧数上限与最长等待（秒），
+    # 超出时只放弃该客户端积压的响应，不影响其他客户端和通道
+    MAX_CLIENT_BACKLOG = 256
+    SEND_TIMEOUT = 30.0
+    
+    def __init__(self, req_port=5555, pub_port=5556, workers=0, bulk_port=None, bulk_workers=0):
+        super().__init__()
+        self.context = zmq.Context()
+        
+        # 每个通道一个 ROUTER socket（客户端 DEALER 可同时发送多个请求）
+        self.frontends = {'interactive': self._bind_frontend(req_port)}
+        self.lane_workers = {'interactive': workers}
+        if bulk_port:
+            self.frontends['bulk'] = self._bind_frontend(bulk_port)
+            self.lane_workers['bulk'] = bulk_workers
+        
+        # XPUB socket（推送通知）：只由消息循环线程使用，同时接收订阅变化，
+        # 没有订阅者的主题在服务端就被丢弃
+        self.pub_socket = self.context.socket(zmq.XPUB)
+        self.pub_socket.bind(f"tcp://*:{pub_port}")
+        self.subscriptions = frozenset()  # 当前有订阅者的主题前缀，由消息循环整体替换
+        
+        # 各线程与 worker 发布的通知都先进入 relay PULL，再由消息循环转发到 XPUB
+        self.relay_socket = self.context.socket(zmq.PULL)
+        self.relay_socket.bind("inproc://notify")
+        self.notify_socket = self.context.socket(zmq.PUSH)
+        self.notify_socket.connect("inproc://notify")
+        self.pub_lock = Lock()  # 请求循环与通知线程都会发布
+        
+        # worker 进程池：ROUTER 后端分发请求
+        self.workers = sum(self.lane_workers.values())
+        self.worker_processes = {}                              # worker 标识 -> (进程, 通道, 序号)
+        self.worker_lanes = {}                                  # worker 标识 -> 通道
+        self.worker_busy = {}                                   # worker 标识 -> 正在处理的请求 (信封, 请求标识, 格式)
+        self.worker_generation = 0                              # 重启的 worker 使用新标识，迟到的消息不会认错
+        self.next_worker_check = 0.0
+        self.idle_workers = {lane: deque() for lane in self.frontends}
+        self.backlog = {lane: deque() for lane in self.frontends}  # deque[(请求标识, 帧, 格式)]
+        # 客户端暂时收不下的响应：(通道, 客户端标识) -> deque[(入队时间, 帧)]，由消息循环非阻塞重发
+        self.outbound: Dict[Tuple[str, bytes], deque] = {}
+        # 本进程内的流式响应等待确认时由消息循环继续收发，期间到达的本进程请求推迟到流结束后处理
+        self.in_process_streams = 0
+        self.deferred: deque = deque()
+        if self.workers > 0:
+            self.worker_socket = self.context.socket(zmq.ROUTER)
+            self.worker_socket.setsockopt(zmq.ROUTER_MANDATORY, 1)
+            port = self.worker_socket.bind_to_random_port("tcp://127.0.0.1")
+            self.worker_endpoint = f"tcp://127.0.0.1:{port}"
+            
+            port = self.relay_socket.bind_to_random_port("tcp://127.0.0.1")
+            self.relay_endpoint = f"tcp://127.0.0.1:{port}"
+            
+            # 取消与流确认广播：worker 执行处理器时不读取请求 socket，由其监听线程接收
+            self.control_socket = self.context.socket(zmq.PUB)
+            port = self.control_socket.bind_to_random_port("tcp://127.0.0.1")
+            self.control_endpoint = f"tcp://127.0.0.1:{port}"
+        
+        self.running = False
+        self.thread = None
+        
+        logger.info(f"ZeroMQ Server started on ports {req_port} (ROUTER), {pub_port} (PUB)"
+                    + (f", {bulk_port} (bulk ROUTER)" if bulk_port else "")
+                    + f", workers {self.lane_workers}")
+    
+    def _bind_frontend(self, port: int):
+        """创建客户端前端 ROUTER socket"""
+        socket = self.context.socket(zmq.ROUTER)
+        # 发送队列满或客户端已断开时报错而不是静默丢弃；响应以 NOBLOCK 发送，
+        # 发不出去的进入该客户端的 outbound 队列，消息循环永远不会阻塞在某个客户端上
+        socket.setsockopt(zmq.ROUTER_MANDATORY, 1)
+        socket.setsockopt(zmq.SNDHWM, self.STREAM_SNDHWM)
+        socket.bind(f"tcp://*:{port}")
+        return socket
+    
+    def start(self):
+        """启动服务"""
+        self.running = True
+        
+        if self.workers > 0:
+            self._start_workers()
+        
+        # 在独立线程中运行
+        self.thread = Thread(target=self._run_loop, daemon=True)
+        self.thread.start()
+        
+        logger.info("ZeroMQ Server is running...")
+    
+    def _start_workers(self):
+        """启动各通道的 worker 进程"""
+        for lane, count in self.lane_workers.items():
+            for index in range(count):
+                self._spawn_worker(lane, index)
+    
+    def _spawn_worker(self, lane: str, index: int):
+        """启动一个 worker 进程，注册表中除内置与 inline 外的处理器随进程参数传入"""
+        handlers = {
+            action: handler for action, handler in self.handlers.items()
+            if action not in self.inline and action not in self.BUILTIN_ACTIONS
+        }
+        
+        # spawn 在各平台行为一致，也避免 fork 继承本进程的 zmq 上下文
+        name = f"{lane}-{index}.{self.worker_generation}"
+        self.worker_generation += 1
+        process = multiprocessing.get_context('spawn').Process(
+            target=run_worker,
+            args=(name, lane, self.worker_endpoint, self.relay_endpoint,
+                  self.control_endpoint, handlers, self.invalidates, sorted(self.inline),
+                  (self.compression_level, self.compression_threshold)),
+            daemon=True
+        )
+        process.start()
+        self.worker_processes[name.encode('utf-8')] = (process, lane, index)
+    
+    def _check_workers(self):
+        """发现退出的 worker：其正在处理的请求以错误结束，并在原位置启动新的 worker"""
+        for worker_id, (process, lane, index) in list(self.worker_processes.items()):
+            if process.is_alive():
+                continue
+            
+            logger.error(f"Worker {worker_id.decode('utf-8')} exited (code {process.exitcode}), restarting")
+            del self.worker_processes[worker_id]
+            self.worker_lanes.pop(worker_id, None)
+            if worker_id in self.idle_workers[lane]:
+                self.idle_workers[lane].remove(worker_id)
+            
+            busy = self.worker_busy.pop(worker_id, None)
+            if busy is not None:
+                envelope, key, fmt = busy
+                try:
+                    self._send(envelope, self._build_response(
+                        key[1], 'error',
+                        message="Worker exited while handling the request",
+                        code=503
+                    ), fmt)
+                except zmq.ZMQError as e:
+                    logger.warning(f"Reply dropped: {e}")
+            
+            if self.running:
+                self._spawn_worker(lane, index)
+    
+    def _run_loop(self):
+        """消息处理循环"""
+        self.poller = zmq.Poller()
+        for frontend in self.frontends.values():
+            self.poller.register(frontend, zmq.POLLIN)
+        self.poller.register(self.pub_socket, zmq.POLLIN)
+        self.poller.register(self.relay_socket, zmq.POLLIN)
+        if self.workers > 0:
+            self.poller.register(self.worker_socket, zmq.POLLIN)
+        
+        while self.running:
+            # 有积压的响应时缩短等待，尽快重发（ROUTER_MANDATORY 下 POLLOUT 总是就绪，不能用来等待）
+            self._poll_once(10 if self.outbound else 1000)
+    
+    def _poll_once(self, timeout: int):
+        """等待并处理一轮 socket 事件；本进程的流式响应等待确认时也由它驱动"""
+        try:
+            events = dict(self.poller.poll(timeout))
+        except zmq.ZMQError:
+            if self.running:
+                logger.error("Poll failed", exc_info=True)
+            return
+        
+        try:
+            if self.pub_socket in events:
+                self._on_subscription()
+            if self.relay_socket in events:
+                self._on_relay_message()
+            if self.workers > 0 and self.worker_socket in events:
+                self._on_worker_message()
+            for lane, frontend in self.frontends.items():
+                if frontend in events:
+                    self._on_client_message(lane)
+            self._dispatch_to_workers()
+            self._flush_outbound()
+            if self.workers > 0 and time.monotonic() >= self.next_worker_check:
+                self.next_worker_check = time.monotonic() + self.WORKER_CHECK_INTERVAL
+                self._check_workers()
+        except zmq.ZMQError as e:
+            logger.warning(f"Reply dropped: {e}")
+        except Exception as e:
+            # 单个请求的意外错误不能结束消息循环
+            logger.error(f"Server error: {e}", exc_info=True)
+        
+        # 推迟的请求在最外层（没有进行中的本进程流）依次处理
+        while self.deferred and not self.in_process_streams:
+            envelope, request, encoding, lane = self.deferred.popleft()
+            try:
+                self._handle_request(envelope, request, encoding, lane)
+            except zmq.ZMQError as e:
+                logger.warning(f"Reply dropped: {e}")
+            except Exception as e:
+                logger.error(f"Server error: {e}", exc_info=True)
+    
+    def _on_client_message(self, lane: str):
+        """接收请求：[客户端标识, 空分隔帧, 请求正文]"""
+        frames = self.frontends[lane].recv_multipart()
+        envelope, message = frames[:-1], frames[-1]
+        
+        # 取消与流确认立即处理；没有 worker 的通道与 inline 动作就地执行，其余排队等待本通道的空闲 worker
+        try:
+            request, encoding = decode_message(message)
+        except Exception:
+            self._handle_message(envelope, message, lane)  # 由统一路径返回错误响应
+            return
+        
+        if not isinstance(request, dict):
+            self._send(envelope, self._build_invalid_request(), WireFormat(encoding, lane=lane))
+            return
+        
+        action = request.get('action')
+        if action == CANCEL_ACTION:
+            self._cancel(self._request_key(envelope, request), lane)
+        elif action == STREAM_ACK_ACTION:
+            self._stream_ack(self._request_key(envelope, request), request.get('seq'), lane)
+        elif self.lane_workers[lane] == 0 or action in self.inline:
+            if self.in_process_streams:
+                self.deferred.append((envelope, request, encoding, lane))
+            else:
+                self._handle_request(envelope, request, encoding, lane)
+        else:
+            fmt = WireFormat(encoding, request.get('compress'), action, lane)
+            self.backlog[lane].append((self._request_key(envelope, request), frames, fmt))
+    
+    def _on_worker_message(self):
+        """worker 消息：[worker 标识, READY, 通道] 或 [worker 标识, REPLY, 客户端信封..., 响应正文]"""
+        frames = self.worker_socket.recv_multipart()
+        worker_id, kind = frames[0], frames[1]
+        if worker_id not in self.worker_processes:
+            return  # 已判定退出的 worker 迟到的消息
+        
+        if kind == WORKER_READY:
+            lane = frames[2].decode('utf-8')
+            self.worker_lanes[worker_id] = lane
+            self.worker_busy.pop(worker_id, None)
+            self.idle_workers[lane].append(worker_id)
+        elif kind == WORKER_REPLY:
+            # worker 只处理所属通道的请求，响应从该通道的前端返回
+            self._send_to_client(self.worker_lanes[worker_id], frames[2:])
+    
+    def _send_to_client(self, lane: str, frames: list) -> bool:
+        """非阻塞发送 [客户端标识, ..., 正文]；发不出去时排队，返回 False 表示该客户端的积压已被放弃"""
+        key = (lane, frames[0])
+        queue = self.outbound.get(key)
+        if queue is not None:
+            self._flush_client(key, queue)  # 先发送更早的响应，保持顺序
+        if key not in self.outbound:
+            try:
+                self.frontends[lane].send_multipart(frames, zmq.NOBLOCK)
+                return True
+            except zmq.Again:
+                queue = self.outbound[key] = deque()
+            except zmq.ZMQError as e:
+                logger.warning(f"Reply dropped: {e}")  # 客户端已断开
+                return False
+        
+        queue = self.outbound[key]
+        if len(queue) >= self.MAX_CLIENT_BACKLOG:
+            self._drop_client(key, "backlog full")
+            return False
+        queue.append((time.monotonic(), frames))
+        return True
+    
+    def _flush_client(self, key: Tuple[str, bytes], queue: deque):
+        """按顺序重发一个客户端积压的响应，直到 socket 再次满或队列清空"""
+        frontend = self.frontends[key[0]]
+        while queue:
+            try:
+                frontend.send_multipart(queue[0][1], zmq.NOBLOCK)
+            except zmq.Again:
+                if time.monotonic() - queue[0][0] > self.SEND_TIMEOUT:
+                    self._drop_client(key, "client not reading")
+                return
+            except zmq.ZMQError as e:
+                self._drop_client(key, str(e))
+                return
+            queue.popleft()
+        del self.outbound[key]
+    
+    def _flush_outbound(self):
+        """重发所有客户端积压的响应"""
+        for key, queue in list(self.outbound.items()):
+            self._flush_client(key, queue)
+    
+    def _drop_client(self, key: Tuple[str, bytes], reason: str):
+        """放弃一个客户端积压的全部响应（客户端按超时处理这些请求）"""
+        queue = self.outbound.pop(key, None)
+        logger.warning(f"Dropped {len(queue) if queue else 0} queued replies for a {key[0]} client: {reason}")
+    
+    def _on_subscription(self):
+        """XPUB 订阅变化：首字节 1 为订阅、0 为取消，其后为主题（重复订阅只上报第一次与最后一次）"""
+        message = self.pub_socket.recv()
+        if not message:
+            return
+        topic = message[1:]
+        if message[0] == 1:
+            self.subscriptions = self.subscriptions | {topic}
+        else:
+            self.subscriptions = self.subscriptions - {topic}
+        logger.debug(f"{'Subscribed' if message[0] == 1 else 'Unsubscribed'}: {topic.decode('utf-8', 'replace')!r}")
+    
+    def _has_subscriber(self, topic: bytes) -> bool:
+        """是否有客户端订阅了该主题（SUB 按前缀匹配）"""
+        return any(topic.startswith(prefix) for prefix in self.subscriptions)
+    
+    def _on_relay_message(self):
+        """转发本进程与 worker 发布的通知，没有订阅者的主题直接丢弃"""
+        frames = self.relay_socket.recv_multipart()
+        if self._has_subscriber(frames[0]):
+            self.pub_socket.send_multipart(frames)
+    
+    def _dispatch_to_workers(self):
+        """把各通道排队的请求交给该通道最久未使用的空闲 worker"""
+        for lane, backlog in self.backlog.items():
+            idle = self.idle_workers[lane]
+            while backlog and idle:
+                worker_id = idle.popleft()
+                key, frames, fmt = backlog[0]
+                try:
+                    self.worker_socket.send_multipart([worker_id] + frames)
+                except zmq.ZMQError as e:
+                    # worker 已断开（尚未被 _check_workers 发现），请求留在队首交给下一个 worker
+                    logger.warning(f"Worker {worker_id.decode('utf-8')} unreachable: {e}")
+                    continue
+                backlog.popleft()
+                self.worker_busy[worker_id] = (frames[:-1], key, fmt)
+    
+    def _cancel(self, key: Tuple[bytes, str], lane: str):
+        """排队中的请求直接移除；已交给 worker 的请求广播取消，由正在执行它的 worker 处理"""
+        if self.lane_workers[lane] == 0:
+            super()._cancel(key, lane)
+            return
+        
+        backlog = self.backlog[lane]
+        for entry in backlog:
+            if entry[0] == key:
+                backlog.remove(entry)
+                logger.info(f"Dropped queued request {key[1]}")
+                return
+        
+        self.control_socket.send_multipart([CONTROL_CANCEL, key[0], str(key[1]).encode('utf-8'), b''])
+    
+    def _stream_ack(self, key: Tuple[bytes, str], seq, lane: str):
+        """worker 通道的确认广播给 worker，由正在发送该流的 worker 处理"""
+        if self.lane_workers[lane] == 0:
+            super()._stream_ack(key, seq, lane)
+        elif isinstance(seq, int):
+            self.control_socket.send_multipart([CONTROL_ACK, key[0], str(key[1]).encode('utf-8'),
+                                                str(seq).encode('utf-8')])
+    
+    def _send_stream(self, envelope: list, key: Tuple[bytes, str], chunks, fmt: WireFormat,
+                     window: int = 0):
+        self.in_process_streams += 1
+        try:
+            super()._send_stream(envelope, key, chunks, fmt, window)
+        finally:
+            self.in_process_streams -= 1
+    
+    def _wait_stream_credit(self, key: Tuple[bytes, str], seq: int, window: int) -> bool:
+        """本进程的流在消息循环线程上执行：等待期间继续处理 socket 事件，确认由 _on_client_message 记录"""
+        deadline = time.monotonic() + STREAM_ACK_TIMEOUT
+        while self.stream_acks.get(key, 0) + window <= seq:
+            if is_cancelled():
+                return True
+            if not self.running or time.monotonic() > deadline:
+                return False
+            self._poll_once(100)
+        return True
+    
+    def _send(self, envelope: list, response: dict, fmt: WireFormat):
+        """发送响应（带回原路由信封，编码与请求一致）；客户端的积压被放弃时抛出 ZMQError，流式响应据此中止"""
+        if not self._send_to_client(fmt.lane, envelope + [self._encode_reply(response, fmt)]):
+            raise zmq.ZMQError(zmq.EHOSTUNREACH, "Client backlog dropped")
+    
+    def publish(self, notification_type: str, data: dict, topic: str = GLOBAL_TOPIC):
+        """发布通知（任意线程可调用）；没有订阅者的主题不序列化"""
+        if not self._has_subscriber(topic.encode('utf-8')):
+            return
+        frames = self._format_notification(notification_type, data, topic)
+        with self.pub_lock:
+            self.notify_socket.send_multipart(frames)
+        logger.debug(f"Published notification: {notification_type} ({topic})")
     
     def stop(self):
         """停止服务"""
         self.running = False
-        self.rep_socket.close()
-        self.pub_socket.close()
-        self.context.term()
+        if self.thread:
+            self.thread.join()
+        
+        for process, _, _ in self.worker_processes.values():
+            process.terminate()
+        for process, _, _ in self.worker_processes.values():
+            process.join()
+        
+        self.context.destroy(linger=0)
         logger.info("ZeroMQ Server stopped")
 
 
+class ZmqWorker(RequestDispatcher):
+    """worker 进程：从 broker 领取请求并执行处理器"""
+    
+    def __init__(self, name: str, lane: str, worker_endpoint: str, relay_endpoint: str, control_endpoint: str,
+                 inline_actions: List[str]):
+        super().__init__()
+        self.lane = lane
+        self.inline_actions = set(inline_actions)
+        
+        # 以进程名为路由标识，broker 据此把进程退出与它正在处理的请求对应起来
+        self.context = zmq.Context()
+        self.socket = self.context.socket(zmq.DEALER)
+        self.socket.setsockopt(zmq.IDENTITY, name.encode('utf-8'))
+        self.socket.connect(worker_endpoint)
+        self.relay_socket = self.context.socket(zmq.PUSH)
+        self.relay_socket.connect(relay_endpoint)
+        
+        # 处理器占用主线程，取消与流确认由独立线程接收
+        self.control_endpoint = control_endpoint
+        Thread(target=self._listen_control, daemon=True).start()
+    
+    def _listen_control(self):
+        """接收 broker 广播的控制消息：[类型, 客户端标识, msg_id, 参数]，只有正在处理该请求的 worker 会命中"""
+        socket = self.context.socket(zmq.SUB)
+        socket.setsockopt(zmq.SUBSCRIBE, b'')
+        socket.connect(self.control_endpoint)
+        while True:
+            kind, identity, msg_id, argument = socket.recv_multipart()
+            key = (identity, msg_id.decode('utf-8'))
+            if kind == CONTROL_CANCEL:
+                self.cancel_request(key)
+            elif kind == CONTROL_ACK:
+                self.stream_ack(key, int(argument))
+    
+    def run(self):
+        """处理循环：每处理完一个请求报告一次空闲"""
+        ready = [WORKER_READY, self.lane.encode('utf-8')]
+        self.socket.send_multipart(ready)
+        while True:
+            frames = self.socket.recv_multipart()
+            envelope, message = frames[:-1], frames[-1]
+            try:
+                self._handle_message(envelope, message)
+            except zmq.ZMQError as e:
+                logger.warning(f"Reply dropped: {e}")
+            except Exception as e:
+                # 意外错误只影响当前请求，worker 继续报告空闲
+                logger.error(f"Worker error: {e}", exc_info=True)
+            self.socket.send_multipart(ready)
+    
+    def _is_batchable(self, action: str) -> bool:
+        # inline 动作依赖主进程状态，不能在 worker 中执行
+        return action != 'batch' and action not in self.inline_actions
+    
+    def _send(self, envelope: list, response: dict, fmt: WireFormat):
+        """响应经 broker 转发给客户端"""
+        self.socket.send_multipart([WORKER_REPLY] + envelope + [self._encode_reply(response, fmt)])
+    
+    def publish(self, notification_type: str, data: dict, topic: str = GLOBAL_TOPIC):
+        """通知经 broker 转发到 XPUB socket（broker 按订阅过滤）"""
+        self.relay_socket.send_multipart(self._format_notification(notification_type, data, topic))
+
+
+def run_worker(name: str, lane: str, worker_endpoint: str, relay_endpoint: str, control_endpoint: str,
+               handlers: Dict[str, Callable], invalidates: Dict[str, List[str]],
+               inline_actions: List[str], compression: Tuple[int, int]):
+    """worker 进程入口"""
+    worker = ZmqWorker(name, lane, worker_endpoint, relay_endpoint, control_endpoint, inline_actions)
+    worker.handlers.update(handlers)
+    worker.invalidates.update(invalidates)
+    worker.configure_compression(*compression)
+    
+    logger.info(f"Worker {name} started (pid {os.getpid()}), {len(handlers)} handler(s)")
+    try:
+        worker.run()
+    except KeyboardInterrupt:
+        pass
+
+
 # 测试处理器
 def handle_ping(params: dict) -> dict:
     """测试Ping处理器"""
@@ -180,6 +1235,78 @@ def handle_task_list(params: dict) -> dict:
     }
 
 
+# 模拟的任务交易数据行数
+DEMO_TRANSACTION_ROWS = 20000
+
+
+def handle_data_query(params: dict):
+    """数据查询处理器
+
+    请求带 bulk_dir 时把结果写成列式文件，只返回句柄；否则按 chunk_size 分块产出结果
+    limit 为 0（或不传）表示不限行数；结果带 total（任务的总行数）与 truncated（是否被 limit 截断），
+    批量结果在顶层，分块结果在每个分块中
+    """
+    task_id = params.get('task_id', '')
+    chunk_size = int(params.get('chunk_size', 5000))
+    limit = int(params.get('limit', 0))
+    logger.info(f"Querying data for task: {task_id}")
+    
+    total = DEMO_TRANSACTION_ROWS
+    count = min(limit, total) if limit > 0 else total
+    
+    if params.get('bulk_dir') and np is not None:
+        bulk = query_bulk(params['bulk_dir'], count)
+        publish_task_event(task_id, 'progress', {'current': count, 'total': count, 'message': '交易数据已查询'})
+        return {'bulk': bulk, 'total': total, 'truncated': count < total}
+    
+    return query_chunks(task_id, count, chunk_size, total)
+
+
+def query_bulk(bulk_dir: str, total: int) -> dict:
+    """查询结果（示例数据）写入列式文件"""
+    with trace_span('query', rows=total):
+        ids = np.arange(total, dtype=np.int64)
+        columns = {
+            'txn_id': ids,
+            'txn_time': int(time.time()) - ids * 60,
+            'amount': np.round((ids % 1000) * 13.37, 2),
+            'direction': np.where(ids % 2 == 1, 'out', 'in'),
+            'account': [f"6222{i % 500:012d}" for i in range(total)],
+            'counterparty': [f"6217{(i * 7) % 2000:012d}" for i in range(total)],
+            'balance': 50000.0 + ids * 0.5,
+            'memo': ['转账'] * total
+        }
+    check_cancelled()  # 已取消时不再写文件
+    
+    os.makedirs(bulk_dir, exist_ok=True)
+    with trace_span('write_columnar', rows=total):
+        return write_columnar(os.path.join(bulk_dir, f"{uuid.uuid4().hex}.col"), columns)
+
+
+def query_chunks(task_id: str, count: int, chunk_size: int, total: int):
+    """查询结果（示例数据）的前 count 行按块产出（生成器），total 为总行数"""
+    for start in range(0, count, chunk_size):
+        check_cancelled()  # 非流式请求一次取完所有分块，在块之间检查取消
+        with trace_span('query', offset=start):
+            rows = [
+                {
+                    'txn_id': i,
+                    'txn_time': int(time.time()) - i * 60,
+                    'amount': round((i % 1000) * 13.37, 2),
+                    'direction': 'out' if i % 2 else 'in',
+                    'account': f"6222{i % 500:012d}",
+                    'counterparty': f"6217{(i * 7) % 2000:012d}",
+                    'balance': 50000.0 + i * 0.5,
+                    'memo': '转账'
+                }
+                for i in range(start, min(start + chunk_size, count))
+            ]
+        publish_task_event(task_id, 'progress', {
+            'current': start + len(rows), 'total': count, 'message': '查询交易数据'
+        })
+        yield {'offset': start, 'rows': rows, 'total': total, 'truncated': count < total}
+
+
 # 用户认证处理器
 
 # 模拟用户数据库（实际应用中应该使用数据库）
@@ -293,25 +1420,41 @@ def main():
     print("  Version: 1.0.0")
     print("=" * 60)
     
+    parser = argparse.ArgumentParser(description="资金分析系统后端服务")
+    parser.add_argument('--workers', type=int, default=min(4, os.cpu_count() or 1),
+                        help="交互通道 worker 进程数，0 表示交互请求在主进程处理")
+    parser.add_argument('--bulk-workers', type=int, default=1,
+                        help="批量通道（导入、查询等）worker 进程数，0 表示在主进程处理")
+    parser.add_argument('--compression-level', type=int, default=3,
+                        help="响应/通知压缩级别")
+    parser.add_argument('--compression-threshold', type=int, default=4096,
+                        help="超过该字节数的响应/通知才压缩")
+    args = parser.parse_args()
+    
     # 创建服务器
-    server = ZmqServer(req_port=5555, pub_port=5556)
+    server = ZmqServer(req_port=5555, pub_port=5556, workers=args.workers,
+                       bulk_port=5557, bulk_workers=args.bulk_workers)
+    server.configure_compression(args.compression_level, args.compression_threshold)
     
     # 注册处理器
     server.register_handler('test.ping', handle_ping)
-    server.register_handler('task.create', handle_task_create)
+    server.register_handler('task.create', handle_task_create, invalidates=['task.list'])
     server.register_handler('task.list', handle_task_list)
+    server.register_handler('data.query', handle_data_query)
     
-    # 注册认证处理器
-    server.register_handler('auth.login', handle_auth_login)
-    server.register_handler('auth.logout', handle_auth_logout)
-    server.register_handler('auth.verify', handle_auth_verify)
+    # 注册认证处理器（会话保存在主进程内存中）
+    server.register_handler('auth.login', handle_auth_login, inline=True)
+    server.register_handler('auth.logout', handle_auth_logout, inline=True)
+    server.register_handler('auth.verify', handle_auth_verify, inline=True)
     
     # 启动服务
     server.start()
     
     print("\n服务已启动:")
-    print("  REQ-REP: tcp://*:5555")
+    print("  ROUTER:  tcp://*:5555")
     print("  PUB-SUB: tcp://*:5556")
+    print("  BULK:    tcp://*:5557")
+    print(f"  Workers: {args.workers} interactive, {args.bulk_workers} bulk")
     print("\n按 Ctrl+C 停止服务\n")
     
     # 测试：定期发送通知
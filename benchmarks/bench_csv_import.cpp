@@ -0,0 +1,199 @@
+// CSV 导入基准：生成银行流水格式的测试文件（UTF-8 与 GBK 各一份），
+// 测量 CsvImporter 在不同线程数下的吞吐（MB/s、行/秒），并以逐行读取 + QString::split 作为对照
+// 用法: bench_csv_import [文件大小 MB，默认 1024] [块大小 MB，默认 8]
+//
+// 每种编码先完整导入一次使文件进入页缓存，之后的结果不含磁盘读取
+// 结果以 JSON Lines 输出到 stdout，可读的表格输出到 stderr
+
+#include "import/CsvImporter.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+#include <QStringEncoder>
+#include <QTemporaryDir>
+#include <QThread>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const char* const kNames[] = {"张三", "李四有限公司", "王五", "某某科技股份有限公司"};
+const char* const kMemos[] = {"转账", "工资", "消费", "跨行汇款", "\"网上支付,手续费\"", "\"他说\"\"已到账\"\"\""};
+
+// 交易流水号,交易时间,账号,对方账号,对方户名,借贷标志,交易金额,余额,摘要,序号
+QByteArray makeRow(qint64 i)
+{
+    QByteArray row;
+    row.reserve(192);
+    row += QByteArray::number(202400000000000000LL + i);
+    row += QString(",2024-%1-%2 %3:%4:%5")
+               .arg(i % 12 + 1, 2, 10, QChar('0')).arg(i % 28 + 1, 2, 10, QChar('0'))
+               .arg(i % 24, 2, 10, QChar('0')).arg(i % 60, 2, 10, QChar('0')).arg((i * 7) % 60, 2, 10, QChar('0'))
+               .toLatin1();
+    row += QString(",=\"6222%1\"").arg(i % 500, 12, 10, QChar('0')).toLatin1();
+    row += QString(",\t6217%1,").arg((i * 7) % 2000, 12, 10, QChar('0')).toLatin1();
+    row += kNames[i % 4];
+    row += i % 2 ? ",借," : ",贷,";
+    const double amount = (i % 100000) * 13.37;
+    // 超过 1000 的金额带千位分隔符并加引号
+    row += amount >= 1000 ? "\"" + QLocale(QLocale::English).toString(amount, 'f', 2).toLatin1() + "\""
+                          : QByteArray::number(amount, 'f', 2);
+    row += ',';
+    row += QByteArray::number(50000.0 + i * 0.5, 'f', 2);
+    row += ',';
+    row += kMemos[i % 6];
+    row += ',';
+    row += QByteArray::number(i + 1);
+    row += "\r\n";
+    return row;
+}
+
+// 返回写入的数据行数；GBK 时整行经 GB18030 编码
+qint64 generate(const QString& path, qint64 bytes, bool gbk)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return -1;
+    }
+    QStringEncoder encoder("GB18030");
+    auto encode = [&](const QByteArray& utf8) -> QByteArray {
+        return gbk ? QByteArray(encoder.encode(QString::fromUtf8(utf8))) : utf8;
+    };
+
+    file.write(encode("交易流水号,交易时间,账号,对方账号,对方户名,借贷标志,交易金额,余额,摘要,序号\r\n"));
+    qint64 rows = 0;
+    QByteArray block;
+    while (file.size() + block.size() < bytes) {
+        block += encode(makeRow(rows++));
+        if (block.size() >= 4 * 1024 * 1024) {
+            file.write(block);
+            block.clear();
+        }
+    }
+    file.write(block);
+    return rows;
+}
+
+struct RunResult {
+    double seconds = 0;
+    qint64 rows = 0;
+    bool ok = false;
+};
+
+RunResult runImporter(const QString& path, int threads, qint64 chunkBytes)
+{
+    CsvImporter::Options options;
+    options.threads = threads;
+    options.chunkBytes = chunkBytes;
+    CsvImporter importer(options);
+
+    qint64 rows = 0;
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = importer.import(path, [&rows](const ImportBatch& batch) {
+        rows += batch.rowCount;
+        return true;
+    });
+
+    RunResult result;
+    result.seconds = timer.nsecsElapsed() / 1e9;
+    result.rows = rows;
+    result.ok = ok;
+    if (!ok) {
+        std::fprintf(stderr, "import failed: %s\n", qPrintable(importer.errorString()));
+    }
+    return result;
+}
+
+// 对照：单线程逐行读取、解码并按分隔符拆分（不处理引号）
+RunResult runReadLineSplit(const QString& path)
+{
+    QFile file(path);
+    RunResult result;
+    if (!file.open(QIODevice::ReadOnly)) {
+        return result;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    qint64 fields = 0;
+    while (!file.atEnd()) {
+        const QString line = QString::fromUtf8(file.readLine());
+        fields += line.split(',').size();
+        ++result.rows;
+    }
+    result.seconds = timer.nsecsElapsed() / 1e9;
+    result.ok = fields > 0;
+    return result;
+}
+
+void report(const char* encoding, const char* mode, int threads, qint64 bytes, const RunResult& result)
+{
+    const double mb = bytes / 1048576.0;
+
+    QJsonObject line;
+    line["bench"] = "csv_import";
+    line["encoding"] = encoding;
+    line["mode"] = mode;
+    line["threads"] = threads;
+    line["mb"] = mb;
+    line["rows"] = result.rows;
+    line["seconds"] = result.seconds;
+    line["mb_per_sec"] = mb / result.seconds;
+    line["rows_per_sec"] = result.rows / result.seconds;
+    std::printf("%s\n", QJsonDocument(line).toJson(QJsonDocument::Compact).constData());
+    std::fflush(stdout);
+
+    std::fprintf(stderr, "%-6s %-10s %8d %12.0f %14.0f\n", encoding, mode, threads, mb / result.seconds,
+                 result.rows / result.seconds);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const qint64 bytes = (argc > 1 ? qMax(1, atoi(argv[1])) : 1024) * 1048576LL;
+    const qint64 chunkBytes = (argc > 2 ? qMax(1, atoi(argv[2])) : 8) * 1048576LL;
+
+    qInstallMessageHandler([](QtMsgType, const QMessageLogContext&, const QString&) {});
+
+    std::vector<int> threadCounts;
+    const int ideal = QThread::idealThreadCount();
+    for (int threads = 1; threads < ideal; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(ideal);
+
+    QTemporaryDir dir;
+    std::fprintf(stderr, "%.0f MB per file, %.0f MB chunks\n", bytes / 1048576.0, chunkBytes / 1048576.0);
+    std::fprintf(stderr, "%-6s %-10s %8s %12s %14s\n", "enc", "mode", "threads", "MB/s", "rows/s");
+
+    const bool gbkAvailable = QStringEncoder("GB18030").isValid();
+    for (bool gbk : {false, true}) {
+        if (gbk && !gbkAvailable) {
+            std::fprintf(stderr, "GB18030 codec not available, skipping GBK\n");
+            continue;
+        }
+        const char* encoding = gbk ? "gbk" : "utf8";
+        const QString path = dir.filePath(QString("statement-%1.csv").arg(encoding));
+        if (generate(path, bytes, gbk) < 0) {
+            std::fprintf(stderr, "failed to write %s\n", qPrintable(path));
+            return 1;
+        }
+        const qint64 size = QFileInfo(path).size();
+
+        runImporter(path, ideal, chunkBytes);  // 预热页缓存
+        for (int threads : threadCounts) {
+            report(encoding, "importer", threads, size, runImporter(path, threads, chunkBytes));
+        }
+        if (!gbk) {
+            report(encoding, "readline", 1, size, runReadLineSplit(path));
+        }
+    }
+
+    return 0;
+}
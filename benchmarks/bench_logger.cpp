@@ -0,0 +1,107 @@
+// 日志吞吐基准：同步模式（调用线程加锁、格式化、逐行刷新）与异步模式（无锁入队、后台批量写入）
+// 在 1–16 个生产者线程下的每秒消息数
+// 用法: bench_logger [消息总数] [异步缓冲区容量]
+//
+// 控制台输出被替换为空的消息处理器，只测量格式化、文件写入与入队本身；
+// 异步模式分别给出生产者完成入队的吞吐与 flush() 写完文件的端到端吞吐，以及缓冲区满时的丢弃数
+// 结果以 JSON Lines 输出到 stdout，可读的表格输出到 stderr
+
+#include "core/Logger.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int kProducerCounts[] = {1, 2, 4, 8, 16};
+
+struct RunResult {
+    double producerSeconds = 0;
+    double totalSeconds = 0;
+    quint64 dropped = 0;
+};
+
+RunResult runCase(int producers, int messages)
+{
+    Logger* logger = Logger::instance();
+    const quint64 droppedBefore = logger->droppedCount();
+    const int perProducer = messages / producers;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([logger, p, perProducer]() {
+            for (int i = 0; i < perProducer; ++i) {
+                logger->info(QString("Request completed: action=query.transactions producer=%1 seq=%2")
+                                 .arg(p).arg(i));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    RunResult result;
+    result.producerSeconds = timer.nsecsElapsed() / 1e9;
+    logger->flush();
+    result.totalSeconds = timer.nsecsElapsed() / 1e9;
+    result.dropped = logger->droppedCount() - droppedBefore;
+    return result;
+}
+
+void report(const char* mode, int producers, int messages, const RunResult& result)
+{
+    const int sent = messages / producers * producers;
+
+    QJsonObject line;
+    line["bench"] = "logger";
+    line["mode"] = mode;
+    line["producers"] = producers;
+    line["messages"] = sent;
+    line["dropped"] = qint64(result.dropped);
+    line["producer_msgs_per_sec"] = sent / result.producerSeconds;
+    line["total_msgs_per_sec"] = sent / result.totalSeconds;
+    std::printf("%s\n", QJsonDocument(line).toJson(QJsonDocument::Compact).constData());
+    std::fflush(stdout);
+
+    std::fprintf(stderr, "%-6s %9d %16.0f %16.0f %10llu\n", mode, producers,
+                 sent / result.producerSeconds, sent / result.totalSeconds,
+                 static_cast<unsigned long long>(result.dropped));
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int messages = argc > 1 ? qMax(16, atoi(argv[1])) : 400000;
+    const int capacity = argc > 2 ? atoi(argv[2]) : 65536;
+
+    qInstallMessageHandler([](QtMsgType, const QMessageLogContext&, const QString&) {});
+
+    QTemporaryDir dir;
+    Logger* logger = Logger::instance();
+    logger->setLogFile(dir.filePath("bench.log"));
+
+    std::fprintf(stderr, "%d messages per run, async capacity %d\n", messages, capacity);
+    std::fprintf(stderr, "%-6s %9s %16s %16s %10s\n", "mode", "producers", "producer msg/s", "total msg/s", "dropped");
+
+    for (int producers : kProducerCounts) {
+        report("sync", producers, messages, runCase(producers, messages));
+    }
+
+    logger->setAsync(true, capacity);
+    for (int producers : kProducerCounts) {
+        report("async", producers, messages, runCase(producers, messages));
+    }
+    logger->shutdown();
+
+    return 0;
+}
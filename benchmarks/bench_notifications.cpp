@@ -0,0 +1,112 @@
+// 通知接收基准：比较旧的复制路径与共享消息缓冲区路径的持续吞吐
+// 用法: bench_notifications [消息数] [负载字节数]
+//
+// legacy: message_t -> std::string -> QString -> 排队信号 -> toUtf8 -> fromJson
+// shared: shared_ptr<message_t> -> 排队信号 -> 直接从缓冲区解析
+
+#include "network/WireCodec.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QTimer>
+#include <zmq.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+namespace {
+
+QByteArray buildNotification(int payloadBytes)
+{
+    QJsonObject data;
+    data["task_id"] = "task_001";
+    data["current"] = 42;
+    data["total"] = 100;
+    data["message"] = QString(qMax(0, payloadBytes - 96), QChar('x'));
+    
+    QJsonObject notification;
+    notification["type"] = "progress";
+    notification["data"] = data;
+    notification["timestamp"] = 1700000000;
+    return QJsonDocument(notification).toJson(QJsonDocument::Compact);
+}
+
+double runCase(bool shared, int count, const QByteArray& payload)
+{
+    zmq::context_t context(1);
+    std::string endpoint = shared ? "inproc://bench-shared" : "inproc://bench-legacy";
+    
+    zmq::socket_t pub(context, zmq::socket_type::pub);
+    pub.set(zmq::sockopt::sndhwm, 0);
+    pub.bind(endpoint);
+    
+    zmq::socket_t sub(context, zmq::socket_type::sub);
+    sub.set(zmq::sockopt::rcvhwm, 0);
+    sub.set(zmq::sockopt::subscribe, "");
+    sub.connect(endpoint);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));  // 避免 slow joiner 丢消息
+    
+    QObject sink;
+    std::atomic<int> parsed(0);
+    QElapsedTimer timer;
+    
+    auto onParsed = [&](const QJsonObject& notification) {
+        if (!notification.isEmpty() && ++parsed == count) {
+            QCoreApplication::quit();
+        }
+    };
+    
+    std::thread receiver([&]() {
+        for (int i = 0; i < count; ++i) {
+            if (shared) {
+                auto msg = std::make_shared<zmq::message_t>();
+                (void)sub.recv(*msg, zmq::recv_flags::none);
+                QMetaObject::invokeMethod(&sink, [msg, &onParsed]() {
+                    onParsed(WireCodec::decode(static_cast<const char*>(msg->data()), qsizetype(msg->size())));
+                }, Qt::QueuedConnection);
+            } else {
+                zmq::message_t msg;
+                (void)sub.recv(msg, zmq::recv_flags::none);
+                QString text = QString::fromStdString(msg.to_string());
+                QMetaObject::invokeMethod(&sink, [text, &onParsed]() {
+                    onParsed(QJsonDocument::fromJson(text.toUtf8()).object());
+                }, Qt::QueuedConnection);
+            }
+        }
+    });
+    
+    timer.start();
+    std::thread publisher([&]() {
+        for (int i = 0; i < count; ++i) {
+            pub.send(zmq::buffer(payload.constData(), payload.size()), zmq::send_flags::none);
+        }
+    });
+    
+    QCoreApplication::exec();
+    double seconds = timer.nsecsElapsed() / 1e9;
+    
+    publisher.join();
+    receiver.join();
+    return count / seconds;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    int count = argc > 1 ? QString(argv[1]).toInt() : 200000;
+    int payloadBytes = argc > 2 ? QString(argv[2]).toInt() : 256;
+    QByteArray payload = buildNotification(payloadBytes);
+    
+    std::printf("messages=%d payload=%lld bytes\n", count, static_cast<long long>(payload.size()));
+    std::printf("legacy: %10.0f msg/s\n", runCase(false, count, payload));
+    std::printf("shared: %10.0f msg/s\n", runCase(true, count, payload));
+    
+    return 0;
+}
@@ -0,0 +1,130 @@
+// 消息编码基准：比较 JSON 与 CBOR 的编解码吞吐，以及各压缩算法的压缩比与速度
+// 用法: bench_wire_codec [行数] [轮数]
+
+#include "network/WireCodec.h"
+#include "network/Compression.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QString>
+#include <cstdio>
+
+namespace {
+
+// 构造与 data.query 响应形状一致的交易明细
+QJsonObject buildQueryReply(int rows)
+{
+    static const char* banks[] = {"中国工商银行", "中国建设银行", "中国农业银行", "招商银行"};
+    
+    QJsonArray records;
+    for (int i = 0; i < rows; ++i) {
+        QJsonObject row;
+        row["txn_id"] = qint64(1000000 + i);
+        row["account"] = QString("6222%1").arg(i % 500, 12, 10, QChar('0'));
+        row["counterparty"] = QString("6217%1").arg((i * 7) % 2000, 12, 10, QChar('0'));
+        row["bank"] = banks[i % 4];
+        row["txn_time"] = QString("2024-%1-%2 10:%3:00")
+                              .arg(1 + i % 12, 2, 10, QChar('0'))
+                              .arg(1 + i % 28, 2, 10, QChar('0'))
+                              .arg(i % 60, 2, 10, QChar('0'));
+        row["amount"] = (i % 1000) * 13.37;
+        row["direction"] = (i % 2) ? "out" : "in";
+        row["balance"] = 50000.0 + i * 0.5;
+        row["memo"] = "转账";
+        records.append(row);
+    }
+    
+    QJsonObject data;
+    data["records"] = records;
+    data["total"] = rows;
+    
+    QJsonObject reply;
+    reply["msg_id"] = "bench";
+    reply["status"] = "success";
+    reply["code"] = 200;
+    reply["data"] = data;
+    return reply;
+}
+
+void runCase(const QJsonObject& reply, WireCodec::Encoding encoding, int rounds)
+{
+    QByteArray encoded;
+    QElapsedTimer timer;
+    
+    timer.start();
+    for (int i = 0; i < rounds; ++i) {
+        encoded = WireCodec::encode(reply, encoding);
+    }
+    double encodeMs = timer.nsecsElapsed() / 1e6 / rounds;
+    
+    qsizetype rows = 0;
+    timer.restart();
+    for (int i = 0; i < rounds; ++i) {
+        QJsonObject decoded = WireCodec::decode(encoded);
+        rows += decoded["data"].toObject()["records"].toArray().size();
+    }
+    double decodeMs = timer.nsecsElapsed() / 1e6 / rounds;
+    
+    double mb = encoded.size() / (1024.0 * 1024.0);
+    std::printf("%-5s size=%9.2f KB  encode=%8.2f ms (%7.1f MB/s)  decode=%8.2f ms (%7.1f MB/s)  rows=%lld\n",
+                qPrintable(WireCodec::encodingName(encoding)),
+                encoded.size() / 1024.0,
+                encodeMs, mb / (encodeMs / 1000.0),
+                decodeMs, mb / (decodeMs / 1000.0),
+                static_cast<long long>(rows / rounds));
+}
+
+void runCompression(const QByteArray& payload, Compression::Algorithm algorithm, int level, int rounds)
+{
+    QByteArray compressed;
+    QElapsedTimer timer;
+    
+    timer.start();
+    for (int i = 0; i < rounds; ++i) {
+        compressed = Compression::compress(payload, algorithm, level);
+    }
+    double compressMs = timer.nsecsElapsed() / 1e6 / rounds;
+    
+    qsizetype size = 0;
+    timer.restart();
+    for (int i = 0; i < rounds; ++i) {
+        size += Compression::decompress(compressed.constData(), compressed.size()).size();
+    }
+    double decompressMs = timer.nsecsElapsed() / 1e6 / rounds;
+    
+    double mb = payload.size() / (1024.0 * 1024.0);
+    std::printf("%-5s level=%-2d size=%9.2f KB  ratio=%6.2f  compress=%8.2f ms (%7.1f MB/s)  decompress=%8.2f ms (%7.1f MB/s)%s\n",
+                qPrintable(Compression::algorithmName(algorithm)),
+                level,
+                compressed.size() / 1024.0,
+                double(payload.size()) / double(qMax<qsizetype>(compressed.size(), 1)),
+                compressMs, mb / (compressMs / 1000.0),
+                decompressMs, mb / (decompressMs / 1000.0),
+                size == payload.size() * rounds ? "" : "  MISMATCH");
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    int rows = argc > 1 ? QString(argv[1]).toInt() : 100000;
+    int rounds = argc > 2 ? QString(argv[2]).toInt() : 5;
+    
+    QJsonObject reply = buildQueryReply(rows);
+    
+    std::printf("rows=%d rounds=%d\n", rows, rounds);
+    runCase(reply, WireCodec::Json, rounds);
+    runCase(reply, WireCodec::Cbor, rounds);
+    
+    // 压缩 JSON 编码后的消息
+    QByteArray payload = WireCodec::encode(reply, WireCodec::Json);
+    for (const QString& name : Compression::supportedAlgorithms()) {
+        Compression::Algorithm algorithm = Compression::algorithmFromName(name);
+        runCompression(payload, algorithm, 1, rounds);
+        runCompression(payload, algorithm, 3, rounds);
+    }
+    
+    return 0;
+}
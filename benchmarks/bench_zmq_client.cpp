@@ -0,0 +1,369 @@
+// ZmqClient 网络层基准：进程内替身后端（ROUTER + XPUB，信封与 backend/main.py 一致），
+// 测量不同负载大小与并发数下的请求吞吐、p50/p99 延迟，以及通知接收吞吐
+// 用法: bench_zmq_client [每组请求数] [通知数] [编码 json|cbor]
+//
+// 结果以 JSON Lines 输出到 stdout（每组一行，便于在版本之间对比），可读的表格输出到 stderr
+
+#include "network/ZmqClient.h"
+#include "network/WireCodec.h"
+#include "network/LatencyStats.h"
+#include "core/Logger.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+#include <zmq.hpp>
+#include <zmq_addon.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef BENCH_VERSION
+#define BENCH_VERSION "dev"
+#endif
+
+namespace {
+
+// 替身后端：session.hello 协商编码，bench.notify 在指定主题上发布通知，其余动作原样回显参数
+class StandInServer
+{
+public:
+    explicit StandInServer(WireCodec::Encoding encoding)
+        : m_encoding(encoding)
+        , m_router(m_context, zmq::socket_type::router)
+        , m_pub(m_context, zmq::socket_type::xpub)
+        , m_running(true)
+    {
+        m_router.set(zmq::sockopt::linger, 0);
+        m_router.bind("tcp://127.0.0.1:*");
+        m_pub.set(zmq::sockopt::linger, 0);
+        m_pub.set(zmq::sockopt::sndhwm, 0);  // 通知不因 HWM 丢弃，由 TCP 反压
+        m_pub.bind("tcp://127.0.0.1:*");
+
+        m_reqEndpoint = QString::fromStdString(m_router.get(zmq::sockopt::last_endpoint));
+        m_subEndpoint = QString::fromStdString(m_pub.get(zmq::sockopt::last_endpoint));
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    ~StandInServer()
+    {
+        m_running = false;
+        m_thread.join();
+    }
+
+    QString reqEndpoint() const { return m_reqEndpoint; }
+    QString subEndpoint() const { return m_subEndpoint; }
+
+private:
+    void run()
+    {
+        while (m_running) {
+            zmq::pollitem_t items[] = {
+                { m_router.handle(), 0, ZMQ_POLLIN, 0 },
+                { m_pub.handle(), 0, ZMQ_POLLIN, 0 }
+            };
+            zmq::poll(items, 2, std::chrono::milliseconds(100));
+
+            if (items[1].revents & ZMQ_POLLIN) {
+                handleSubscription();
+            }
+            if (items[0].revents & ZMQ_POLLIN) {
+                handleRequest();
+            }
+        }
+    }
+
+    void handleSubscription()
+    {
+        zmq::message_t message;
+        while (m_pub.recv(message, zmq::recv_flags::dontwait)) {
+            if (message.size() == 0) {
+                continue;
+            }
+            const char* data = static_cast<const char*>(message.data());
+            std::string topic(data + 1, message.size() - 1);
+            if (data[0] == 1) {
+                m_subscriptions.insert(topic);
+            } else {
+                m_subscriptions.erase(topic);
+            }
+        }
+    }
+
+    void handleRequest()
+    {
+        // [客户端标识, 空分隔帧, 请求正文]
+        std::vector<zmq::message_t> frames;
+        if (!zmq::recv_multipart(m_router, std::back_inserter(frames), zmq::recv_flags::dontwait)) {
+            return;
+        }
+
+        const zmq::message_t& body = frames.back();
+        const char* data = static_cast<const char*>(body.data());
+        const qsizetype size = qsizetype(body.size());
+        const WireCodec::Encoding encoding = WireCodec::detect(data, size);
+        const QJsonObject request = WireCodec::decode(data, size);
+        const QString action = request["action"].toString();
+        if (action == "cancel") {
+            return;  // 控制消息不回复
+        }
+
+        QJsonObject reply;
+        reply["msg_id"] = request["msg_id"];
+        reply["timestamp"] = QDateTime::currentSecsSinceEpoch();
+        reply["status"] = "success";
+        reply["code"] = 200;
+        reply["message"] = "";
+        reply["handler_us"] = 0;
+
+        const QJsonObject params = request["params"].toObject();
+        if (action == "session.hello") {
+            const QString name = WireCodec::encodingName(m_encoding);
+            const bool offered = params["encodings"].toArray().contains(name);
+            reply["data"] = QJsonObject{
+                {"encoding", offered ? name : QString("json")},
+                {"encodings", QJsonArray::fromStringList(WireCodec::supportedEncodings())},
+                {"compression", QJsonValue::Null}
+            };
+        } else if (action == "bench.notify") {
+            reply["data"] = QJsonObject{{"published", publish(params)}};
+        } else {
+            reply["data"] = params;
+        }
+
+        QByteArray encoded = WireCodec::encode(reply, encoding);
+        frames.back() = zmq::message_t(encoded.constData(), size_t(encoded.size()));
+        zmq::send_multipart(m_router, frames);
+    }
+
+    int publish(const QJsonObject& params)
+    {
+        const int count = params["count"].toInt();
+        const std::string topic = params["topic"].toString().toStdString();
+
+        // 等待客户端订阅到达（XPUB 上报），避免 slow joiner 丢消息
+        QElapsedTimer timer;
+        timer.start();
+        while (!m_subscriptions.count(topic) && timer.elapsed() < 2000) {
+            zmq::pollitem_t item = { m_pub.handle(), 0, ZMQ_POLLIN, 0 };
+            zmq::poll(&item, 1, std::chrono::milliseconds(50));
+            handleSubscription();
+        }
+
+        QJsonObject notification;
+        notification["type"] = "bench";
+        notification["data"] = QJsonObject{
+            {"task_id", "bench"},
+            {"message", QString(qMax(0, params["size"].toInt() - 96), QChar('x'))}
+        };
+        notification["timestamp"] = QDateTime::currentSecsSinceEpoch();
+        const QByteArray payload = WireCodec::encode(notification, m_encoding);
+
+        for (int i = 0; i < count; ++i) {
+            m_pub.send(zmq::buffer(topic), zmq::send_flags::sndmore);
+            m_pub.send(zmq::buffer(payload.constData(), size_t(payload.size())), zmq::send_flags::none);
+        }
+        return count;
+    }
+
+private:
+    WireCodec::Encoding m_encoding;
+    zmq::context_t m_context;
+    zmq::socket_t m_router;
+    zmq::socket_t m_pub;
+    std::set<std::string> m_subscriptions;
+    QString m_reqEndpoint;
+    QString m_subEndpoint;
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+};
+
+struct RequestResult {
+    int requests = 0;
+    int errors = 0;
+    double seconds = 0.0;
+    LatencyHistogram latency;
+};
+
+// 保持 concurrency 个请求在途，直到完成 total 个
+RequestResult runRequests(ZmqClient& client, int payloadBytes, int concurrency, int total)
+{
+    const QJsonObject params{{"blob", QString(payloadBytes, QChar('x'))}};
+
+    RequestResult result;
+    QEventLoop loop;
+    QElapsedTimer clock;
+    int sent = 0;
+
+    std::function<void()> sendNext = [&]() {
+        const qint64 start = clock.nsecsElapsed();
+        ++sent;
+        client.requestAsync("bench.echo", params).then(&loop, [&, start](const QJsonObject& response) {
+            result.latency.record(clock.nsecsElapsed() - start);
+            if (response["status"].toString() != "success") {
+                ++result.errors;
+            }
+            if (++result.requests == total) {
+                loop.quit();
+            } else if (sent < total) {
+                sendNext();
+            }
+        });
+    };
+
+    clock.start();
+    for (int i = 0; i < concurrency && sent < total; ++i) {
+        sendNext();
+    }
+    loop.exec();
+    result.seconds = clock.nsecsElapsed() / 1e9;
+    return result;
+}
+
+struct NotificationResult {
+    int received = 0;
+    double seconds = 0.0;
+};
+
+// 后端连续发布 count 条通知，从收到第一条开始计时
+NotificationResult runNotifications(ZmqClient& client, int count, int payloadBytes)
+{
+    const QString topic = ZmqClient::taskTopic("bench");
+
+    NotificationResult result;
+    QEventLoop loop;
+    QElapsedTimer clock;
+
+    auto connection = QObject::connect(&client, &ZmqClient::notificationReceived, &loop,
+        [&](const QString& type, const QJsonObject&, const QString&) {
+            if (type != "bench") {
+                return;
+            }
+            if (result.received++ == 0) {
+                clock.start();
+            }
+            if (result.received == count) {
+                result.seconds = clock.nsecsElapsed() / 1e9;
+                loop.quit();
+            }
+        });
+
+    client.subscribe(topic);
+    client.requestAsync("bench.notify", QJsonObject{
+        {"count", count},
+        {"size", payloadBytes},
+        {"topic", topic}
+    }, 120000);
+
+    // 有通知丢失时不会收齐，超时后按已收到的数量计算
+    QTimer::singleShot(60000, &loop, [&]() {
+        result.seconds = clock.isValid() ? clock.nsecsElapsed() / 1e9 : 0.0;
+        loop.quit();
+    });
+    loop.exec();
+
+    QObject::disconnect(connection);
+    client.unsubscribe(topic);
+    return result;
+}
+
+void emitRecord(const QJsonObject& record)
+{
+    std::printf("%s\n", QJsonDocument(record).toJson(QJsonDocument::Compact).constData());
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    Logger::instance()->setLogLevel(Logger::WARNING);
+
+    const int requestsPerCase = argc > 1 ? QString(argv[1]).toInt() : 20000;
+    const int notifications = argc > 2 ? QString(argv[2]).toInt() : 100000;
+    const WireCodec::Encoding encoding = WireCodec::encodingFromName(argc > 3 ? QString(argv[3]) : "cbor",
+                                                                     WireCodec::Cbor);
+
+    StandInServer server(encoding);
+    ZmqClient client;
+    client.setCompression(Compression::None, 0, 0);
+    if (!client.connectToServer(server.reqEndpoint(), server.subEndpoint())) {
+        std::fprintf(stderr, "failed to connect to stand-in server\n");
+        return 1;
+    }
+
+    // 预热：等待编码协商完成、TCP 连接建立
+    runRequests(client, 64, 8, 1000);
+
+    const QJsonObject common{
+        {"version", BENCH_VERSION},
+        {"encoding", WireCodec::encodingName(client.encoding())}
+    };
+    std::fprintf(stderr, "version=%s encoding=%s requests/case=%d notifications=%d\n",
+                 BENCH_VERSION, qPrintable(WireCodec::encodingName(client.encoding())),
+                 requestsPerCase, notifications);
+    std::fprintf(stderr, "%10s %6s %8s %12s %10s %10s %10s %7s\n",
+                 "payload", "conc", "requests", "req/s", "p50 us", "p99 us", "max us", "errors");
+
+    const int payloadSizes[] = {64, 1024, 16 * 1024, 128 * 1024};
+    const int concurrencyLevels[] = {1, 8, 64};
+    for (int payload : payloadSizes) {
+        // 大负载按总字节数限制请求数，每组耗时大致相当
+        const int total = qMax(200, qMin(requestsPerCase, int((256LL << 20) / payload)));
+        for (int concurrency : concurrencyLevels) {
+            RequestResult result = runRequests(client, payload, concurrency, total);
+            const double rps = result.requests / result.seconds;
+
+            QJsonObject record = common;
+            record["bench"] = "request";
+            record["payload_bytes"] = payload;
+            record["concurrency"] = concurrency;
+            record["requests"] = result.requests;
+            record["errors"] = result.errors;
+            record["rps"] = rps;
+            record["p50_us"] = result.latency.percentile(0.50) / 1000.0;
+            record["p99_us"] = result.latency.percentile(0.99) / 1000.0;
+            record["max_us"] = result.latency.max() / 1000.0;
+            emitRecord(record);
+
+            std::fprintf(stderr, "%10d %6d %8d %12.0f %10.1f %10.1f %10.1f %7d\n",
+                         payload, concurrency, result.requests, rps,
+                         result.latency.percentile(0.50) / 1000.0,
+                         result.latency.percentile(0.99) / 1000.0,
+                         result.latency.max() / 1000.0, result.errors);
+        }
+    }
+
+    std::fprintf(stderr, "%10s %10s %10s %12s %10s\n", "payload", "sent", "received", "msg/s", "MB/s");
+    const int notificationSizes[] = {256, 4096};
+    for (int payload : notificationSizes) {
+        NotificationResult result = runNotifications(client, notifications, payload);
+        const double rate = result.seconds > 0 ? result.received / result.seconds : 0.0;
+
+        QJsonObject record = common;
+        record["bench"] = "notification";
+        record["payload_bytes"] = payload;
+        record["sent"] = notifications;
+        record["received"] = result.received;
+        record["msgs_per_sec"] = rate;
+        record["mb_per_sec"] = rate * payload / 1e6;
+        emitRecord(record);
+
+        std::fprintf(stderr, "%10d %10d %10d %12.0f %10.1f\n",
+                     payload, notifications, result.received, rate, rate * payload / 1e6);
+    }
+
+    client.disconnect();
+    return 0;
+}
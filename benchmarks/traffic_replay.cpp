@@ -0,0 +1,279 @@
+// 流量重放：把 TrafficRecorder 录制的请求按原始时间间隔（或加速）发送到后端，
+// 按动作比较录制时与重放时的响应延迟，用于复现现场的负载峰值、在相同流量下对比后端版本
+// 用法: traffic_replay <日志文件> [请求端点] [速度 1|10|max] [批量端点]
+//
+// 请求按录制时的原始字节发送（编码与压缩不变），按录制时的通道发往对应端点；通知只统计不重放
+// 结果以 JSON Lines 输出到 stdout（每个动作一行，另有一行汇总），可读的表格输出到 stderr
+
+#include "network/TrafficRecorder.h"
+#include "network/WireCodec.h"
+#include "network/LatencyStats.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <zmq.hpp>
+#include <zmq_addon.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr int kLaneCount = 2;          // 与 ZmqClient::LaneCount 一致
+constexpr int kMaxInFlight = 256;      // max 速度下的在途请求上限
+constexpr qint64 kIdleTimeoutMs = 30000;
+
+struct ReplayRequest {
+    qint64 offsetNsecs = 0;
+    int lane = 0;
+    QString msgId;
+    QString action;
+    QByteArray payload;
+};
+
+struct ActionStats {
+    LatencyHistogram recorded;
+    LatencyHistogram replayed;
+    int sent = 0;
+    int errors = 0;
+};
+
+// 中间流式分块不算完成
+bool isFinalReply(const QJsonObject& reply)
+{
+    const QJsonObject stream = reply["stream"].toObject();
+    return stream.isEmpty() || stream["final"].toBool();
+}
+
+void emitRecord(const QJsonObject& record)
+{
+    std::printf("%s\n", QJsonDocument(record).toJson(QJsonDocument::Compact).constData());
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: traffic_replay <log> [req-endpoint] [speed 1|10|max] [bulk-endpoint]\n");
+        return 2;
+    }
+    const QString path = QString::fromLocal8Bit(argv[1]);
+    const QString endpoints[kLaneCount] = {
+        argc > 2 ? QString(argv[2]) : QString("tcp://localhost:5555"),
+        argc > 4 ? QString(argv[4]) : QString("tcp://localhost:5557")
+    };
+    const QString speedArg = argc > 3 ? QString(argv[3]) : QString("1");
+    const double speed = speedArg == "max" ? 0.0 : qMax(0.01, speedArg.toDouble());
+
+    // 读取日志：请求按录制顺序排队，录制时的延迟按动作统计
+    TrafficLogReader reader;
+    if (!reader.open(path)) {
+        std::fprintf(stderr, "failed to open %s: %s\n", qPrintable(path), qPrintable(reader.errorString()));
+        return 1;
+    }
+
+    std::vector<ReplayRequest> requests;
+    QHash<QString, qsizetype> recordedIndex;   // msg_id -> requests 下标
+    QMap<QString, ActionStats> stats;
+    int notifications = 0;
+    TrafficRecorder::Record record;
+    while (reader.next(&record)) {
+        if (record.kind == TrafficRecorder::Notification) {
+            ++notifications;
+            continue;
+        }
+
+        const QString msgId = QString::fromUtf8(record.key);
+        if (record.kind == TrafficRecorder::Request) {
+            ReplayRequest request;
+            request.offsetNsecs = record.offsetNsecs;
+            request.lane = qBound(0, int(record.lane), kLaneCount - 1);
+            request.msgId = msgId;
+            request.action = WireCodec::decode(record.payload).value("action").toString();
+            request.payload = record.payload;
+            if (request.action != "cancel") {  // cancel 消息与目标请求使用同一 msg_id
+                recordedIndex.insert(msgId, qsizetype(requests.size()));
+            }
+            requests.push_back(std::move(request));
+        } else if (record.kind == TrafficRecorder::Reply) {
+            auto it = recordedIndex.constFind(msgId);
+            if (it != recordedIndex.cend() && isFinalReply(WireCodec::decode(record.payload))) {
+                const ReplayRequest& request = requests[size_t(it.value())];
+                stats[request.action].recorded.record(record.offsetNsecs - request.offsetNsecs);
+            }
+        }
+    }
+    if (!reader.errorString().isEmpty()) {
+        std::fprintf(stderr, "warning: %s, replaying records read so far\n", qPrintable(reader.errorString()));
+    }
+    if (requests.empty()) {
+        std::fprintf(stderr, "no requests in %s\n", qPrintable(path));
+        return 1;
+    }
+
+    const double recordedSeconds = (requests.back().offsetNsecs - requests.front().offsetNsecs) / 1e9;
+    std::fprintf(stderr, "%zu requests, %d notifications over %.1f s, replay speed %s\n",
+                 requests.size(), notifications, recordedSeconds, qPrintable(speedArg));
+
+    // 每个通道一个 DEALER，与 ZmqClient 的连接方式一致
+    zmq::context_t context(1);
+    std::vector<std::unique_ptr<zmq::socket_t>> dealers;
+    for (const QString& endpoint : endpoints) {
+        auto dealer = std::make_unique<zmq::socket_t>(context, zmq::socket_type::dealer);
+        dealer->set(zmq::sockopt::linger, 0);
+        dealer->connect(endpoint.toStdString());
+        dealers.push_back(std::move(dealer));
+    }
+
+    struct InFlight {
+        QString action;
+        qint64 sentNsecs = 0;
+    };
+    QHash<QString, InFlight> inFlight;
+
+    QElapsedTimer clock;
+    clock.start();
+    const qint64 origin = requests.front().offsetNsecs;
+    qint64 lastActivity = 0;
+    size_t next = 0;
+    int completed = 0;
+
+    while (next < requests.size() || !inFlight.isEmpty()) {
+        // 发送所有已到时间的请求（max 速度下受在途上限约束）
+        const qint64 now = clock.nsecsElapsed();
+        while (next < requests.size()) {
+            const ReplayRequest& request = requests[next];
+            if (speed > 0 ? (request.offsetNsecs - origin) / speed > now : inFlight.size() >= kMaxInFlight) {
+                break;
+            }
+
+            zmq::socket_t& dealer = *dealers[size_t(request.lane)];
+            dealer.send(zmq::message_t(), zmq::send_flags::sndmore);
+            dealer.send(zmq::buffer(request.payload.constData(), size_t(request.payload.size())),
+                        zmq::send_flags::none);
+
+            // cancel 控制消息没有响应，被取消的请求也不再等待（排队中被取消的请求后端不回复）
+            if (request.action == "cancel") {
+                inFlight.remove(request.msgId);
+            } else {
+                inFlight.insert(request.msgId, InFlight{request.action, clock.nsecsElapsed()});
+            }
+            ++stats[request.action].sent;
+            lastActivity = clock.nsecsElapsed();
+            ++next;
+        }
+
+        // 等到下一个请求的发送时间，或有响应到达
+        long timeoutMs = 1000;
+        if (next < requests.size() && speed > 0) {
+            const qint64 due = qint64((requests[next].offsetNsecs - origin) / speed);
+            timeoutMs = long(qBound<qint64>(0, (due - clock.nsecsElapsed()) / 1000000, 1000));
+        } else if (next < requests.size() && inFlight.size() < kMaxInFlight) {
+            timeoutMs = 0;
+        }
+
+        zmq::pollitem_t items[kLaneCount];
+        for (int lane = 0; lane < kLaneCount; ++lane) {
+            items[lane] = { dealers[size_t(lane)]->handle(), 0, ZMQ_POLLIN, 0 };
+        }
+        zmq::poll(items, kLaneCount, std::chrono::milliseconds(timeoutMs));
+
+        for (int lane = 0; lane < kLaneCount; ++lane) {
+            if (!(items[lane].revents & ZMQ_POLLIN)) {
+                continue;
+            }
+            while (true) {
+                std::vector<zmq::message_t> frames;
+                if (!zmq::recv_multipart(*dealers[size_t(lane)], std::back_inserter(frames),
+                                         zmq::recv_flags::dontwait)) {
+                    break;
+                }
+                lastActivity = clock.nsecsElapsed();
+
+                const zmq::message_t& body = frames.back();
+                const QJsonObject reply = WireCodec::decode(static_cast<const char*>(body.data()),
+                                                            qsizetype(body.size()));
+                if (!isFinalReply(reply)) {
+                    // 流式分块收到即确认，否则带 stream_window 的请求会在后端等待确认
+                    const QByteArray ack = WireCodec::encode(QJsonObject{
+                        {"action", "stream.ack"},
+                        {"msg_id", reply["msg_id"]},
+                        {"seq", reply["stream"].toObject()["seq"]}
+                    }, WireCodec::Json);
+                    zmq::socket_t& dealer = *dealers[size_t(lane)];
+                    dealer.send(zmq::message_t(), zmq::send_flags::sndmore);
+                    dealer.send(zmq::buffer(ack.constData(), size_t(ack.size())), zmq::send_flags::none);
+                    continue;
+                }
+
+                auto it = inFlight.find(reply["msg_id"].toString());
+                if (it == inFlight.end()) {
+                    continue;
+                }
+                ActionStats& action = stats[it->action];
+                action.replayed.record(clock.nsecsElapsed() - it->sentNsecs);
+                if (reply["status"].toString() != "success") {
+                    ++action.errors;
+                }
+                inFlight.erase(it);
+                ++completed;
+            }
+        }
+
+        // 最后一次收发之后长时间没有响应，视为后端丢弃了剩余请求
+        if (next == requests.size() && (clock.nsecsElapsed() - lastActivity) / 1000000 > kIdleTimeoutMs) {
+            std::fprintf(stderr, "timed out waiting for %lld replies\n", static_cast<long long>(inFlight.size()));
+            break;
+        }
+    }
+
+    const double seconds = clock.nsecsElapsed() / 1e9;
+
+    std::fprintf(stderr, "%-24s %7s %7s %12s %12s %12s %12s\n", "action", "sent", "errors",
+                 "rec p50 ms", "rec p99 ms", "p50 ms", "p99 ms");
+    for (auto it = stats.cbegin(); it != stats.cend(); ++it) {
+        const ActionStats& action = it.value();
+        QJsonObject line;
+        line["bench"] = "replay_action";
+        line["action"] = it.key();
+        line["sent"] = action.sent;
+        line["completed"] = qint64(action.replayed.count());
+        line["errors"] = action.errors;
+        line["recorded_p50_ms"] = action.recorded.percentile(0.50) / 1e6;
+        line["recorded_p99_ms"] = action.recorded.percentile(0.99) / 1e6;
+        line["p50_ms"] = action.replayed.percentile(0.50) / 1e6;
+        line["p99_ms"] = action.replayed.percentile(0.99) / 1e6;
+        line["max_ms"] = action.replayed.max() / 1e6;
+        emitRecord(line);
+
+        std::fprintf(stderr, "%-24s %7d %7d %12.2f %12.2f %12.2f %12.2f\n", qPrintable(it.key()),
+                     action.sent, action.errors,
+                     action.recorded.percentile(0.50) / 1e6, action.recorded.percentile(0.99) / 1e6,
+                     action.replayed.percentile(0.50) / 1e6, action.replayed.percentile(0.99) / 1e6);
+    }
+
+    QJsonObject summary;
+    summary["bench"] = "replay";
+    summary["log"] = path;
+    summary["speed"] = speedArg;
+    summary["requests"] = qint64(requests.size());
+    summary["completed"] = completed;
+    summary["seconds"] = seconds;
+    summary["recorded_seconds"] = recordedSeconds;
+    summary["rps"] = completed / seconds;
+    emitRecord(summary);
+
+    std::fprintf(stderr, "completed %d/%zu in %.2f s (%.0f req/s, recorded span %.2f s)\n",
+                 completed, requests.size(), seconds, completed / seconds, recordedSeconds);
+    return inFlight.isEmpty() ? 0 : 1;
+}
@@ -173,7 +173,7 @@ void AuthManager::refreshSession()
     m_userInfo["session_token"] = m_sessionToken;
     m_userInfo["refresh_time"] = QDateTime::currentDateTime().toString(Qt::ISODate);
     
-    Logger::instance()->debug("Session refreshed for user: " + m_currentUser);
+    LOG_DEBUG("Session refreshed for user: %1", m_currentUser);
 }
 
 QString AuthManager::hashPassword(const QString& password) const
@@ -1,6 +1,214 @@
 #include "core/Logger.h"
+#include "core/MpscRingBuffer.h"
 #include <QDebug>
 #include <QDir>
+#include <QThread>
+#include <QTimer>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#if defined(Q_OS_WIN)
+#include <qt_windows.h>
+#undef ERROR  // wingdi.h 的 ERROR 宏与 Logger::ERROR 冲突
+#elif defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+// 写入线程空闲时的唤醒间隔（时间边界）与单批内的刷新阈值（大小边界）
+constexpr int kFlushIntervalMs = 100;
+constexpr qsizetype kFlushChars = 64 * 1024;
+
+// 每个刷新周期最多投递给界面的记录数（WARNING 及以上另有同样多的余量）
+constexpr qsizetype kMaxBatchLines = 2000;
+
+// 写入文件的 UTF-8 字节数（代理对的两个单元各计 2 字节，合计 4 字节）
+qint64 utf8Length(const QString& text)
+{
+    qint64 bytes = text.size();
+    for (const QChar c : text) {
+        const char16_t u = c.unicode();
+        bytes += u >= 0x80 ? (u >= 0x800 && !c.isSurrogate() ? 2 : 1) : 0;
+    }
+    return bytes;
+}
+
+// 以下函数只在崩溃处理中调用：不分配内存、不加锁，只使用 write(2) / WriteFile。
+// handle 在 Unix 上是文件描述符，在 Windows 上是 HANDLE
+void crashWrite(qintptr handle, const char* data, size_t size)
+{
+#if defined(Q_OS_WIN)
+    const HANDLE file = reinterpret_cast<HANDLE>(handle);
+    while (size > 0) {
+        DWORD written = 0;
+        if (!::WriteFile(file, data, DWORD(qMin<size_t>(size, 1u << 30)), &written, nullptr) || written == 0) {
+            return;
+        }
+        data += written;
+        size -= size_t(written);
+    }
+#elif defined(Q_OS_UNIX)
+    while (size > 0) {
+        const ssize_t n = ::write(int(handle), data, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return;
+        }
+        data += n;
+        size -= size_t(n);
+    }
+#else
+    Q_UNUSED(handle);
+    Q_UNUSED(data);
+    Q_UNUSED(size);
+#endif
+}
+
+void crashWrite(qintptr handle, const char* text)
+{
+    crashWrite(handle, text, std::strlen(text));
+}
+
+void crashWriteNumber(qintptr handle, qint64 value, int base = 10)
+{
+    char digits[24];
+    char* p = digits + sizeof(digits);
+    const bool negative = base == 10 && value < 0;
+    quint64 v = negative ? 0 - quint64(value) : quint64(value);
+    do {
+        *--p = "0123456789ABCDEF"[v % quint64(base)];
+        v /= quint64(base);
+    } while (v > 0);
+    if (negative) {
+        *--p = '-';
+    }
+    crashWrite(handle, p, size_t(digits + sizeof(digits) - p));
+}
+
+// UTF-16 转 UTF-8，经栈上缓冲区分段写出
+void crashWriteText(qintptr handle, const QChar* text, qsizetype size)
+{
+    char buffer[512];
+    size_t used = 0;
+    for (qsizetype i = 0; i < size; ++i) {
+        if (used > sizeof(buffer) - 4) {
+            crashWrite(handle, buffer, used);
+            used = 0;
+        }
+        char32_t u = text[i].unicode();
+        if (QChar::isHighSurrogate(u) && i + 1 < size && text[i + 1].isLowSurrogate()) {
+            u = QChar::surrogateToUcs4(char16_t(u), text[++i].unicode());
+        } else if (QChar::isSurrogate(u)) {
+            u = 0xFFFD;
+        }
+        if (u < 0x80) {
+            buffer[used++] = char(u);
+        } else if (u < 0x800) {
+            buffer[used++] = char(0xC0 | (u >> 6));
+            buffer[used++] = char(0x80 | (u & 0x3F));
+        } else if (u < 0x10000) {
+            buffer[used++] = char(0xE0 | (u >> 12));
+            buffer[used++] = char(0x80 | ((u >> 6) & 0x3F));
+            buffer[used++] = char(0x80 | (u & 0x3F));
+        } else {
+            buffer[used++] = char(0xF0 | (u >> 18));
+            buffer[used++] = char(0x80 | ((u >> 12) & 0x3F));
+            buffer[used++] = char(0x80 | ((u >> 6) & 0x3F));
+            buffer[used++] = char(0x80 | (u & 0x3F));
+        }
+    }
+    crashWrite(handle, buffer, used);
+}
+
+#ifdef HAS_ZLIB
+// 压缩为 gzip 格式（可直接用 zcat / 7-Zip 打开）
+bool gzipFile(const QString& sourcePath, const QString& targetPath)
+{
+    constexpr qsizetype kChunk = 256 * 1024;
+
+    QFile source(sourcePath);
+    QFile target(targetPath);
+    if (!source.open(QIODevice::ReadOnly) || !target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+
+    QByteArray in(kChunk, Qt::Uninitialized);
+    QByteArray out(kChunk, Qt::Uninitialized);
+    bool ok = true;
+    int mode = Z_NO_FLUSH;
+    while (ok && mode != Z_FINISH) {
+        const qint64 read = source.read(in.data(), in.size());
+        if (read < 0) {
+            ok = false;
+            break;
+        }
+        mode = source.atEnd() ? Z_FINISH : Z_NO_FLUSH;
+        stream.next_in = reinterpret_cast<Bytef*>(in.data());
+        stream.avail_in = uInt(read);
+        do {
+            stream.next_out = reinterpret_cast<Bytef*>(out.data());
+            stream.avail_out = uInt(out.size());
+            deflate(&stream, mode);
+            const qint64 produced = out.size() - qint64(stream.avail_out);
+            if (target.write(out.constData(), produced) != produced) {
+                ok = false;
+                break;
+            }
+        } while (stream.avail_out == 0);
+    }
+    deflateEnd(&stream);
+    return ok && target.flush();
+}
+#endif
+
+// 后台维护：压缩已完成的分段（<名称>-<时间>.log），并只保留最近 maxFiles 个分段
+void maintainSegments(const QString& logFilePath, const LogRotationPolicy& policy)
+{
+    const QFileInfo info(logFilePath);
+    const QDir dir = info.absoluteDir();
+    const QString suffix = info.suffix().isEmpty() ? QString() : "." + info.suffix();
+    const QString pattern = info.completeBaseName() + "-*" + suffix;
+
+#ifdef HAS_ZLIB
+    if (policy.compress) {
+        for (const QFileInfo& segment : dir.entryInfoList({pattern}, QDir::Files)) {
+            const QString path = segment.absoluteFilePath();
+            if (path.endsWith(".gz")) {
+                continue;
+            }
+            if (gzipFile(path, path + ".gz")) {
+                QFile::remove(path);
+            } else {
+                qWarning() << "Failed to compress log segment:" << path;
+                QFile::remove(path + ".gz");
+            }
+        }
+    }
+#endif
+
+    if (policy.maxFiles > 0) {
+        const QFileInfoList segments = dir.entryInfoList({pattern, pattern + ".gz"}, QDir::Files, QDir::Time);
+        for (qsizetype i = policy.maxFiles; i < segments.size(); ++i) {
+            QFile::remove(segments[i].absoluteFilePath());
+        }
+    }
+}
+
+} // namespace
 
 Logger* Logger::s_instance = nullptr;
 
@@ -9,17 +217,14 @@ Logger::Logger()
     , m_logFile(nullptr)
     , m_logStream(nullptr)
 {
+    // 压缩与清理串行执行，不与写入线程竞争 CPU
+    m_compressor.setMaxThreadCount(1);
 }
 
 Logger::~Logger()
 {
-    if (m_logStream) {
-        delete m_logStream;
-    }
-    if (m_logFile) {
-        m_logFile->close();
-        delete m_logFile;
-    }
+    shutdown();
+    closeFileLocked();
 }
 
 Logger* Logger::instance()
@@ -30,20 +235,12 @@ Logger* Logger::instance()
     return s_instance;
 }
 
-void Logger::setLogFile(const QString& filePath)
+void Logger::setLogFile(const QString& filePath, const LogRotationPolicy& rotation)
 {
     QMutexLocker locker(&m_mutex);
     
     // 关闭旧文件
-    if (m_logStream) {
-        delete m_logStream;
-        m_logStream = nullptr;
-    }
-    if (m_logFile) {
-        m_logFile->close();
-        delete m_logFile;
-        m_logFile = nullptr;
-    }
+    closeFileLocked();
     
     // 创建日志目录
     QFileInfo fileInfo(filePath);
@@ -52,15 +249,125 @@ void Logger::setLogFile(const QString& filePath)
         dir.mkpath(".");
     }
     
-    // 打开新文件
-    m_logFile = new QFile(filePath);
-    if (m_logFile->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-        m_logStream = new QTextStream(m_logFile);
-        m_logStream->setEncoding(QStringConverter::Utf8);
-    } else {
-        qWarning() << "Failed to open log file:" << filePath;
+    // 打开新文件，并在后台处理上次运行留下的未压缩分段
+    m_logFilePath = filePath;
+    m_rotation = rotation;
+    openFileLocked();
+    scheduleMaintenance();
+}
+
+void Logger::setRotationPolicy(const LogRotationPolicy& rotation)
+{
+    QMutexLocker locker(&m_mutex);
+    m_rotation = rotation;
+    if (m_logFile) {
+        scheduleMaintenance();
+    }
+}
+
+void Logger::openFileLocked()
+{
+    m_logFile = new QFile(m_logFilePath);
+    if (!m_logFile->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Failed to open log file:" << m_logFilePath;
         delete m_logFile;
         m_logFile = nullptr;
+        return;
+    }
+
+    m_logStream = new QTextStream(m_logFile);
+    m_logStream->setEncoding(QStringConverter::Utf8);
+    m_fileBytes = m_logFile->size();
+
+    // 崩溃处理不能使用 QFile，预先准备一个独立的追加写句柄（打开失败时为 -1，即 INVALID_HANDLE_VALUE）
+#if defined(Q_OS_WIN)
+    const HANDLE crashHandle = ::CreateFileW(reinterpret_cast<LPCWSTR>(m_logFilePath.utf16()), FILE_APPEND_DATA,
+                                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    m_crashHandle.store(reinterpret_cast<qintptr>(crashHandle), std::memory_order_release);
+#elif defined(Q_OS_UNIX)
+    m_crashHandle.store(::open(QFile::encodeName(m_logFilePath).constData(), O_WRONLY | O_APPEND | O_CLOEXEC),
+                        std::memory_order_release);
+#endif
+
+    // 追加到已有文件时以最后修改时间作为分段开始时间，跨天后的第一次写入即轮转
+    m_segmentStarted = m_fileBytes > 0 ? QFileInfo(m_logFilePath).lastModified() : QDateTime::currentDateTime();
+    m_nextRolloverMsecs = m_segmentStarted.date().addDays(1).startOfDay().toMSecsSinceEpoch();
+}
+
+void Logger::closeFileLocked()
+{
+    const qintptr crashHandle = m_crashHandle.exchange(-1, std::memory_order_acq_rel);
+    if (crashHandle != -1) {
+#if defined(Q_OS_WIN)
+        ::CloseHandle(reinterpret_cast<HANDLE>(crashHandle));
+#elif defined(Q_OS_UNIX)
+        ::close(int(crashHandle));
+#endif
+    }
+    if (m_logStream) {
+        m_logStream->flush();
+        delete m_logStream;
+        m_logStream = nullptr;
+    }
+    if (m_logFile) {
+        m_logFile->close();
+        delete m_logFile;
+        m_logFile = nullptr;
+    }
+}
+
+void Logger::rotateIfNeededLocked(qint64 pendingBytes)
+{
+    if (!m_logFile) {
+        return;
+    }
+
+    const bool bySize = m_rotation.maxBytes > 0 && m_fileBytes > 0
+                        && m_fileBytes + pendingBytes > m_rotation.maxBytes;
+    const bool byDay = m_rotation.daily && QDateTime::currentMSecsSinceEpoch() >= m_nextRolloverMsecs;
+    if (!bySize && !byDay) {
+        return;
+    }
+
+    // 改名与重新打开都很快，压缩与清理交给后台线程
+    closeFileLocked();
+
+    const QFileInfo info(m_logFilePath);
+    const QString stem = info.absolutePath() + "/" + info.completeBaseName() + "-"
+                         + m_segmentStarted.toString("yyyyMMdd-hhmmss");
+    const QString suffix = info.suffix().isEmpty() ? QString() : "." + info.suffix();
+    QString segment = stem + suffix;
+    for (int i = 1; QFile::exists(segment) || QFile::exists(segment + ".gz"); ++i) {
+        segment = stem + "-" + QString::number(i) + suffix;
+    }
+
+    const bool renamed = QFile::rename(m_logFilePath, segment);
+    openFileLocked();
+    if (!renamed) {
+        // 文件被其他进程占用（Windows）时继续写原文件，下一个周期再试，避免每行都尝试轮转
+        qWarning() << "Failed to rotate log file:" << m_logFilePath;
+        m_fileBytes = 0;
+        m_segmentStarted = QDateTime::currentDateTime();
+        m_nextRolloverMsecs = m_segmentStarted.date().addDays(1).startOfDay().toMSecsSinceEpoch();
+        return;
+    }
+    scheduleMaintenance();
+}
+
+void Logger::scheduleMaintenance()
+{
+    const QString logFilePath = m_logFilePath;
+    const LogRotationPolicy policy = m_rotation;
+    m_compressor.start([logFilePath, policy]() {
+        maintainSegments(logFilePath, policy);
+    });
+}
+
+void Logger::flushFileLocked()
+{
+    if (m_logStream) {
+        m_logStream->flush();
     }
 }
 
@@ -94,11 +401,79 @@ void Logger::log(LogLevel level, const QString& message)
     if (level < m_logLevel) {
         return;
     }
-    
+
+    Record record;
+    record.level = level;
+    record.message = message;
+    submit(std::move(record));
+}
+
+void Logger::logRecord(LogLevel level, const char* format, QVariantList args)
+{
+    if (level < m_logLevel) {
+        return;
+    }
+
+    Record record;
+    record.level = level;
+    record.format = format;
+    record.args = std::move(args);
+    submit(std::move(record));
+}
+
+void Logger::submit(Record&& record)
+{
+    // 异步模式：只入队，不加锁、不格式化、不做 I/O。
+    // 先登记再判断标志（均为 seq_cst），shutdown() 据此等到所有已通过判断的生产者入队完毕
+    m_producers.fetch_add(1);
+    if (m_async.load()) {
+        record.timestamp = QDateTime::currentMSecsSinceEpoch();
+        size_t position = 0;
+        if (!m_queue->tryPush(std::move(record), &position)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            m_wakeup.release();
+        } else if ((position & (m_wakeupInterval - 1)) == 0) {
+            // 大量写入时不必等到时间边界，每写满四分之一缓冲区唤醒一次写入线程
+            m_wakeup.release();
+        }
+        m_producers.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+    m_producers.fetch_sub(1, std::memory_order_relaxed);
+
+    const QString message = record.format ? expandFormat(record.format, record.args) : record.message;
     QMutexLocker locker(&m_mutex);
-    
-    QString formattedMessage = formatMessage(level, message);
-    
+    writeLocked(record.level, formatMessage(record.level, message));
+    flushFileLocked();
+}
+
+QString Logger::expandFormat(const char* format, const QVariantList& args)
+{
+    const QString pattern = QString::fromUtf8(format);
+    if (args.isEmpty()) {
+        return pattern;
+    }
+
+    // 单次扫描替换 %1..%9，参数中出现的 %N 不会被再次替换
+    QString result;
+    result.reserve(pattern.size() + 16 * args.size());
+    for (qsizetype i = 0; i < pattern.size(); ++i) {
+        const QChar c = pattern.at(i);
+        if (c == QLatin1Char('%') && i + 1 < pattern.size()) {
+            const int index = pattern.at(i + 1).digitValue() - 1;
+            if (index >= 0 && index < args.size()) {
+                result += args.at(index).toString();
+                ++i;
+                continue;
+            }
+        }
+        result += c;
+    }
+    return result;
+}
+
+void Logger::writeLocked(LogLevel level, const QString& formattedMessage)
+{
     // 输出到控制台
     switch (level) {
         case DEBUG:
@@ -115,15 +490,231 @@ void Logger::log(LogLevel level, const QString& message)
             qCritical().noquote() << formattedMessage;
             break;
     }
-    
-    // 写入文件
+
+    // 写入文件（必要时先轮转）
+    const qint64 bytes = utf8Length(formattedMessage) + 1;
+    rotateIfNeededLocked(bytes);
     if (m_logStream) {
         (*m_logStream) << formattedMessage << "\n";
-        m_logStream->flush();
+        m_fileBytes += bytes;
+    }
+
+    // 交给界面批量投递（独立的锁，GUI 线程取批次时不必等待文件写入）
+    if (m_batchEnabled.load(std::memory_order_relaxed)) {
+        QMutexLocker batchLocker(&m_batchMutex);
+        if (m_batchPending.size() < kMaxBatchLines
+            || (level >= WARNING && m_batchPending.size() < 2 * kMaxBatchLines)) {
+            m_batchPending.append(LogLine{formattedMessage, level});
+        } else {
+            ++m_batchDropped;
+        }
+    }
+}
+
+void Logger::enableBatchDelivery(int intervalMs)
+{
+    if (!m_batchTimer) {
+        m_batchTimer = new QTimer(this);
+        connect(m_batchTimer, &QTimer::timeout, this, &Logger::deliverBatch);
+    }
+    m_batchTimer->start(intervalMs);
+    m_batchEnabled.store(true, std::memory_order_relaxed);
+}
+
+void Logger::deliverBatch()
+{
+    QVector<LogLine> lines;
+    int dropped = 0;
+    {
+        QMutexLocker batchLocker(&m_batchMutex);
+        lines.swap(m_batchPending);
+        dropped = m_batchDropped;
+        m_batchDropped = 0;
+    }
+
+    if (!lines.isEmpty() || dropped > 0) {
+        emit logBatchReady(lines, dropped);
     }
-    
-    // 发送信号
-    emit logMessageGenerated(formattedMessage, level);
+}
+
+void Logger::setAsync(bool enabled, int capacity)
+{
+    if (!enabled) {
+        shutdown();
+        return;
+    }
+    if (m_writer) {
+        return;
+    }
+
+    // 缓冲区只创建一次：关闭异步模式后仍可能有生产者持有入队前的判断结果
+    if (!m_queue) {
+        m_queue = std::make_unique<MpscRingBuffer<Record>>(size_t(qMax(capacity, 1024)));
+        m_wakeupInterval = m_queue->capacity() / 4;
+    }
+
+    m_writerRunning.store(true, std::memory_order_release);
+    m_writer = QThread::create([this]() { writerLoop(); });
+    m_writer->setObjectName("LoggerWriter");
+    m_writer->start();
+    m_async.store(true, std::memory_order_release);
+}
+
+void Logger::flush()
+{
+    if (!m_writer || QThread::currentThread() == m_writer) {
+        QMutexLocker locker(&m_mutex);
+        flushFileLocked();
+        return;
+    }
+
+    // 等待写入线程处理完调用前已入队的记录
+    const size_t target = m_queue->pushed();
+    QMutexLocker locker(&m_flushMutex);
+    while (m_written.load(std::memory_order_acquire) < target
+           && m_writerRunning.load(std::memory_order_acquire)) {
+        m_wakeup.release();
+        m_flushed.wait(&m_flushMutex, kFlushIntervalMs);
+    }
+}
+
+void Logger::shutdown()
+{
+    if (m_writer) {
+        m_async.store(false);
+        m_writerRunning.store(false, std::memory_order_release);
+        m_wakeup.release();
+        m_writer->wait();
+        delete m_writer;
+        m_writer = nullptr;
+
+        // 关闭异步模式前已通过判断的生产者可能在写入线程退出后才入队：等它们入队完毕再由当前线程补写，
+        // 之后的生产者都会看到 m_async == false 走同步路径
+        while (m_producers.load(std::memory_order_acquire) > 0) {
+            QThread::yieldCurrentThread();
+        }
+        drainQueue();
+    }
+
+    // 等待进行中的分段压缩，避免退出时留下不完整的 .gz
+    m_compressor.waitForDone();
+}
+
+void Logger::writerLoop()
+{
+    while (true) {
+        // 空闲时按时间边界醒来；批量写入、缓冲区满或 flush() 时由生产者提前唤醒
+        m_wakeup.tryAcquire(1, kFlushIntervalMs);
+        const int pending = m_wakeup.available();
+        if (pending > 0) {
+            m_wakeup.tryAcquire(pending);
+        }
+
+        const bool running = m_writerRunning.load(std::memory_order_acquire);
+        drainQueue();
+        if (!running) {
+            break;
+        }
+    }
+}
+
+void Logger::drainQueue()
+{
+    QMutexLocker locker(&m_mutex);
+
+    Record record;
+    qsizetype pendingChars = 0;
+    bool wrote = false;
+    while (m_queue->tryPop(record)) {
+        const QString formattedMessage = formatRecord(record);
+        writeLocked(record.level, formattedMessage);
+        wrote = true;
+
+        pendingChars += formattedMessage.size();
+        if (pendingChars >= kFlushChars) {
+            flushFileLocked();
+            pendingChars = 0;
+        }
+    }
+
+    const quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDropped) {
+        writeLocked(WARNING, formatMessage(WARNING, QString("Log queue full, %1 messages dropped")
+                                                        .arg(dropped - m_reportedDropped)));
+        m_reportedDropped = dropped;
+        wrote = true;
+    }
+
+    if (wrote) {
+        flushFileLocked();
+    }
+    locker.unlock();
+
+    m_written.store(m_queue->popped(), std::memory_order_release);
+    QMutexLocker flushLocker(&m_flushMutex);
+    m_flushed.wakeAll();
+}
+
+void Logger::installCrashHandler()
+{
+#if defined(Q_OS_WIN)
+    // Windows 上访问冲突等结构化异常不经过信号，由未处理异常过滤器处理；
+    // 返回 EXCEPTION_CONTINUE_SEARCH 交回系统，保留 WER 错误报告与转储。abort() 仍走 SIGABRT
+    ::SetUnhandledExceptionFilter([](EXCEPTION_POINTERS* info) -> LONG {
+        if (s_instance && info && info->ExceptionRecord) {
+            s_instance->flushOnCrash("exception 0x", qint64(quint32(info->ExceptionRecord->ExceptionCode)), 16);
+        }
+        return EXCEPTION_CONTINUE_SEARCH;
+    });
+    std::signal(SIGABRT, &Logger::crashSignalHandler);
+#else
+    for (int sig : {SIGSEGV, SIGABRT, SIGFPE, SIGILL}) {
+        std::signal(sig, &Logger::crashSignalHandler);
+    }
+#endif
+}
+
+void Logger::crashSignalHandler(int sig)
+{
+    if (s_instance) {
+        s_instance->flushOnCrash("signal ", sig, 10);
+    }
+    // 恢复默认处理并重新触发，保留原有的崩溃行为（core dump / 错误报告）
+    std::signal(sig, SIG_DFL);
+    std::raise(sig);
+}
+
+void Logger::flushOnCrash(const char* cause, qint64 code, int base)
+{
+    // 只读遍历环形缓冲区，把未出队的记录直接写入日志文件；写入线程已取出但尚未刷新的记录会丢失，
+    // 写入线程仍在运行时可能与其输出交错。带参数的延迟格式化记录无法安全展开，只写出格式串
+    const qintptr handle = m_crashHandle.load(std::memory_order_acquire);
+    const MpscRingBuffer<Record>* queue = m_queue.get();
+    if (handle == -1 || !queue) {
+        return;
+    }
+
+    static const char* const kLevels[] = {"DEBUG", "INFO ", "WARN ", "ERROR", "CRIT "};
+    crashWrite(handle, "[CRASH] ");
+    crashWrite(handle, cause);
+    crashWriteNumber(handle, code, base);
+    crashWrite(handle, ", unwritten log records follow (timestamps in ms since epoch)\n");
+    queue->visitPending([handle](const Record& record) {
+        crashWrite(handle, "[");
+        crashWriteNumber(handle, record.timestamp);
+        crashWrite(handle, "] [");
+        crashWrite(handle, record.level >= DEBUG && record.level <= CRITICAL ? kLevels[record.level] : "UNKN ");
+        crashWrite(handle, "] ");
+        if (record.format) {
+            crashWrite(handle, record.format);
+            if (!record.args.isEmpty()) {
+                crashWrite(handle, " [arguments not expanded]");
+            }
+        } else {
+            crashWriteText(handle, record.message.constData(), record.message.size());
+        }
+        crashWrite(handle, "\n");
+    });
 }
 
 QString Logger::formatMessage(LogLevel level, const QString& message)
@@ -133,6 +724,20 @@ QString Logger::formatMessage(LogLevel level, const QString& message)
     return QString("[%1] [%2] %3").arg(timestamp, levelStr, message);
 }
 
+QString Logger::formatRecord(const Record& record)
+{
+    // 同一秒内的记录复用已格式化的日期时间，只拼接毫秒
+    const qint64 second = record.timestamp / 1000;
+    if (second != m_cachedSecond) {
+        m_cachedSecond = second;
+        m_cachedPrefix = QDateTime::fromMSecsSinceEpoch(second * 1000).toString("yyyy-MM-dd hh:mm:ss.");
+    }
+
+    const QString millis = QString::number(record.timestamp % 1000).rightJustified(3, '0');
+    const QString message = record.format ? expandFormat(record.format, record.args) : record.message;
+    return QString("[%1%2] [%3] %4").arg(m_cachedPrefix, millis, levelToString(record.level), message);
+}
+
 QString Logger::levelToString(LogLevel level)
 {
     switch (level) {
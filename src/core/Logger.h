@@ -6,7 +6,29 @@
 #include <QFile>
 #include <QTextStream>
 #include <QMutex>
+#include <QWaitCondition>
+#include <QSemaphore>
+#include <QThreadPool>
 #include <QDateTime>
+#include <QVariant>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+class QThread;
+class QTimer;
+template <typename T> class MpscRingBuffer;
+
+// 日志文件轮转：当前文件超过 maxBytes 或跨天时改名为 <名称>-<开始时间>.log 并新建文件，
+// 完成的分段在后台线程压缩为 .gz（需要 zlib），只保留最近 maxFiles 个分段
+struct LogRotationPolicy {
+    qint64 maxBytes = 64 * 1024 * 1024;   // 0 表示不按大小轮转（按写入的 UTF-8 字节数累计，为软上限）
+    bool daily = true;
+    int maxFiles = 14;                    // 0 表示不清理旧分段
+    bool compress = true;
+};
 
 class Logger : public QObject
 {
@@ -22,36 +44,191 @@ public:
     };
 
     static Logger* instance();
-    
+
     void setLogLevel(LogLevel level) { m_logLevel = level; }
-    void setLogFile(const QString& filePath);
-    
+    bool isEnabled(LogLevel level) const { return level >= m_logLevel; }
+    void setLogFile(const QString& filePath, const LogRotationPolicy& rotation = LogRotationPolicy());
+    void setRotationPolicy(const LogRotationPolicy& rotation);
+
+    // 异步模式：调用线程只把记录放入无锁环形缓冲区，由后台写入线程批量格式化、输出，
+    // 并按大小或时间批量刷新文件。缓冲区满时丢弃记录并计数，不阻塞调用线程
+    void setAsync(bool enabled, int capacity = 65536);
+    bool isAsync() const { return m_async.load(std::memory_order_acquire); }
+
+    // 阻塞直到调用前提交的记录全部写入并刷新（同步模式下只刷新文件）
+    void flush();
+    // 写完剩余记录并停止写入线程，之后回到同步模式（程序退出前调用）
+    void shutdown();
+    // 异步模式下因缓冲区满而丢弃的记录数
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // 进程崩溃（SIGSEGV / SIGABRT，Windows 上为未处理的结构化异常）时尽力把缓冲区中尚未写出的记录追加到日志文件：
+    // 崩溃处理中只通过预先打开的文件句柄调用 write(2) / WriteFile，不加锁、不分配内存
+    static void installCrashHandler();
+
     void debug(const QString& message);
     void info(const QString& message);
     void warning(const QString& message);
     void error(const QString& message);
     void critical(const QString& message);
-    
+
     void log(LogLevel level, const QString& message);
 
+    struct LogLine {
+        QString text;
+        int level = INFO;
+    };
+
+    // 界面投递：格式化后的记录进入有界的待投递队列，由所在线程（GUI 线程）的定时器每个周期
+    // 发出一次 logBatchReady。界面跟不上时队列满后丢弃 WARNING 以下的记录并计数，
+    // 日志再多也不会在事件循环中堆积。须在 GUI 线程调用
+    void enableBatchDelivery(int intervalMs = 100);
+
+    // 延迟格式化（供 LOG_* 宏使用）：只保存格式串指针并按值捕获参数，
+    // 异步模式下由写入线程替换 %1..%9，调用线程不拼接字符串。格式串必须是字符串字面量
+    template <size_t N, typename... Args>
+    void logFormat(LogLevel level, const char (&format)[N], Args&&... args)
+    {
+        logRecord(level, format, QVariantList{toLogArg(std::forward<Args>(args))...});
+    }
+
 signals:
-    void logMessageGenerated(const QString& message, int level);
+    // 每个刷新周期一次；dropped 为本周期因队列满而丢弃的记录数
+    void logBatchReady(const QVector<Logger::LogLine>& lines, int dropped);
+
+private slots:
+    void deliverBatch();
 
 private:
     Logger();
     ~Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
-    
+
+    // 时间戳由调用线程采集，格式化推迟到写入线程；format 非空时 message 由 format 与 args 生成
+    struct Record {
+        LogLevel level = INFO;
+        qint64 timestamp = 0;
+        QString message;
+        const char* format = nullptr;
+        QVariantList args;
+    };
+
+    template <typename T>
+    static QVariant toLogArg(T&& value) { return QVariant::fromValue(std::decay_t<T>(std::forward<T>(value))); }
+    // C 字符串（如 e.what()）的生命周期不确定，立即复制
+    static QVariant toLogArg(const char* value) { return QString::fromUtf8(value); }
+
+    void logRecord(LogLevel level, const char* format, QVariantList args);
+    void submit(Record&& record);
+    static QString expandFormat(const char* format, const QVariantList& args);
+
     QString formatMessage(LogLevel level, const QString& message);
+    QString formatRecord(const Record& record);
     QString levelToString(LogLevel level);
-    
+    void writeLocked(LogLevel level, const QString& formattedMessage);
+    void flushFileLocked();
+
+    // 轮转（持有 m_mutex 时调用，压缩与清理在 m_compressor 中执行）
+    void openFileLocked();
+    void closeFileLocked();
+    void rotateIfNeededLocked(qint64 pendingBytes);
+    void scheduleMaintenance();
+
+    void writerLoop();
+    void drainQueue();
+    void flushOnCrash(const char* cause, qint64 code, int base);
+    static void crashSignalHandler(int sig);
+
 private:
     static Logger* s_instance;
     LogLevel m_logLevel;
     QFile* m_logFile;
     QTextStream* m_logStream;
     QMutex m_mutex;
+
+    // 轮转
+    QString m_logFilePath;
+    LogRotationPolicy m_rotation;
+    qint64 m_fileBytes = 0;                      // 当前分段已写入的字节数（不逐行查询文件大小）
+    QDateTime m_segmentStarted;
+    qint64 m_nextRolloverMsecs = 0;
+    QThreadPool m_compressor;
+
+    // 异步模式
+    std::atomic<bool> m_async{false};
+    std::atomic<bool> m_writerRunning{false};
+    std::unique_ptr<MpscRingBuffer<Record>> m_queue;
+    QThread* m_writer = nullptr;
+    QSemaphore m_wakeup;
+    size_t m_wakeupInterval = 0;
+    std::atomic<quint64> m_dropped{0};
+    quint64 m_reportedDropped = 0;
+    std::atomic<size_t> m_written{0};
+    std::atomic<int> m_producers{0};             // 已登记、尚未完成入队的异步生产者数
+    std::atomic<qintptr> m_crashHandle{-1};      // 崩溃处理专用的日志文件句柄（Unix 为描述符，Windows 为 HANDLE），随文件打开 / 轮转更新
+    QMutex m_flushMutex;
+    QWaitCondition m_flushed;
+
+    // 界面批量投递
+    std::atomic<bool> m_batchEnabled{false};
+    QMutex m_batchMutex;
+    QVector<LogLine> m_batchPending;
+    int m_batchDropped = 0;
+    QTimer* m_batchTimer = nullptr;
+
+    // 写入线程的时间戳缓存（同一秒内只格式化毫秒部分）
+    qint64 m_cachedSecond = -1;
+    QString m_cachedPrefix;
 };
 
+// 编译期最低日志级别（Logger::LogLevel 的值）：低于该级别的 LOG_* 调用在运行时不会执行，
+// 由编译器整体消除。Release 构建（定义了 NDEBUG）默认去掉 DEBUG，可用 -DLOG_MIN_LEVEL=<0..4> 覆盖
+#ifndef LOG_MIN_LEVEL
+#  ifdef NDEBUG
+#    define LOG_MIN_LEVEL 1
+#  else
+#    define LOG_MIN_LEVEL 0
+#  endif
+#endif
+
+// 先检查运行时级别再求值参数：被过滤的日志不构造任何字符串
+// 用法: LOG_DEBUG("Sending request: %1", action);
+#define LOG_AT(level, ...) \
+    do { \
+        if (Logger::instance()->isEnabled(level)) { \
+            Logger::instance()->logFormat(level, __VA_ARGS__); \
+        } \
+    } while (0)
+
+// 编译期去掉的级别仍保留类型检查，避免只在日志中使用的变量产生未使用警告
+#define LOG_DISABLED(level, ...) \
+    do { \
+        if (false) { \
+            Logger::instance()->logFormat(level, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#if LOG_MIN_LEVEL <= 0
+#  define LOG_DEBUG(...) LOG_AT(Logger::DEBUG, __VA_ARGS__)
+#else
+#  define LOG_DEBUG(...) LOG_DISABLED(Logger::DEBUG, __VA_ARGS__)
+#endif
+#if LOG_MIN_LEVEL <= 1
+#  define LOG_INFO(...) LOG_AT(Logger::INFO, __VA_ARGS__)
+#else
+#  define LOG_INFO(...) LOG_DISABLED(Logger::INFO, __VA_ARGS__)
+#endif
+#if LOG_MIN_LEVEL <= 2
+#  define LOG_WARNING(...) LOG_AT(Logger::WARNING, __VA_ARGS__)
+#else
+#  define LOG_WARNING(...) LOG_DISABLED(Logger::WARNING, __VA_ARGS__)
+#endif
+#if LOG_MIN_LEVEL <= 3
+#  define LOG_ERROR(...) LOG_AT(Logger::ERROR, __VA_ARGS__)
+#else
+#  define LOG_ERROR(...) LOG_DISABLED(Logger::ERROR, __VA_ARGS__)
+#endif
+#define LOG_CRITICAL(...) LOG_AT(Logger::CRITICAL, __VA_ARGS__)
+
 #endif // LOGGER_H
@@ -0,0 +1,108 @@
+#ifndef MPSCRINGBUFFER_H
+#define MPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// 有界无锁多生产者单消费者环形缓冲区（每个槽位带序号，生产者只在写入位置上 CAS）
+// 容量向上取整为 2 的幂；满时 tryPush 立即返回 false，由调用方决定丢弃或重试
+template <typename T>
+class MpscRingBuffer
+{
+public:
+    explicit MpscRingBuffer(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    // 任意线程调用；成功时 position（可选）返回该元素的入队序号
+    bool tryPush(T&& value, size_t* position = nullptr)
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 已满
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        if (position) {
+            *position = pos;
+        }
+        return true;
+    }
+
+    // 只能由唯一的消费者线程调用
+    bool tryPop(T& value)
+    {
+        const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[pos & m_mask];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;  // 为空，或生产者尚未写完
+        }
+
+        value = std::move(cell.value);
+        cell.value = T();
+        cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_dequeuePos.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只读遍历已写完但尚未出队的元素，不修改任何状态、不加锁也不分配内存（供崩溃信号处理使用）；
+    // 与消费者并发时可能看到正在被取走的元素，只适合尽力而为的场合
+    template <typename Visitor>
+    void visitPending(Visitor&& visit) const
+    {
+        const size_t begin = m_dequeuePos.load(std::memory_order_acquire);
+        const size_t end = m_enqueuePos.load(std::memory_order_acquire);
+        for (size_t pos = begin; pos != end && pos - begin <= m_mask; ++pos) {
+            const Cell& cell = m_cells[pos & m_mask];
+            if (cell.sequence.load(std::memory_order_acquire) == pos + 1) {
+                visit(cell.value);
+            }
+        }
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+    // 已入队 / 已出队的累计数量（任意线程可读）
+    size_t pushed() const { return m_enqueuePos.load(std::memory_order_acquire); }
+    size_t popped() const { return m_dequeuePos.load(std::memory_order_acquire); }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence{0};
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_dequeuePos{0};
+};
+
+#endif // MPSCRINGBUFFER_H
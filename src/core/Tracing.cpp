@@ -0,0 +1,305 @@
+#include "core/Tracing.h"
+#include "core/Logger.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QMutex>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QThread>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// 单个线程缓冲区的区间上限，超过后丢弃新区间并计数（长时间开启追踪时限制内存）
+constexpr int kMaxEventsPerThread = 200000;
+constexpr int kMaxRemoteSpans = 200000;
+
+struct ThreadBuffer {
+    QMutex mutex;                  // 只与导出 / 清空竞争
+    QVector<Tracing::Event> events;
+    int tid = 0;
+    QString threadName;
+};
+
+struct Registry {
+    QMutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;   // 线程退出后缓冲区仍保留到导出
+    QVector<QJsonObject> remoteSpans;
+    int nextTid = 1;
+    std::atomic<quint64> dropped{0};
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+thread_local QString t_traceId;
+
+QString currentThreadName()
+{
+    QThread* thread = QThread::currentThread();
+    if (!thread->objectName().isEmpty()) {
+        return thread->objectName();
+    }
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+        return QStringLiteral("main");
+    }
+    return QString::fromLatin1(thread->metaObject()->className());
+}
+
+ThreadBuffer* threadBuffer()
+{
+    if (!t_buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->threadName = currentThreadName();
+
+        Registry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        buffer->tid = reg.nextTid++;
+        reg.buffers.push_back(buffer);
+        t_buffer = std::move(buffer);
+    }
+    return t_buffer.get();
+}
+
+QJsonObject metadataEvent(const char* name, qint64 pid, qint64 tid, const QString& value)
+{
+    return QJsonObject{
+        {"name", name},
+        {"ph", "M"},
+        {"pid", pid},
+        {"tid", tid},
+        {"args", QJsonObject{{"name", value}}}
+    };
+}
+
+} // namespace
+
+std::atomic<bool> Tracing::s_enabled{false};
+
+void Tracing::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+qint64 Tracing::nowUs()
+{
+    using namespace std::chrono;
+
+    // 首次调用时把单调时钟对齐到系统时钟，之后不受系统时间调整影响
+    struct Anchor {
+        qint64 epochUs = duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+        steady_clock::time_point start = steady_clock::now();
+    };
+    static const Anchor anchor;
+    return anchor.epochUs + duration_cast<microseconds>(steady_clock::now() - anchor.start).count();
+}
+
+QString Tracing::newTraceId()
+{
+    return QString::number(QRandomGenerator::global()->generate64(), 16).rightJustified(16, QLatin1Char('0'));
+}
+
+QString Tracing::currentTraceId()
+{
+    return t_traceId;
+}
+
+void Tracing::setCurrentTraceId(const QString& traceId)
+{
+    t_traceId = traceId;
+}
+
+void Tracing::record(const char* name, const char* category, qint64 startUs, qint64 endUs,
+                     const QString& traceId, const QJsonObject& args)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    append(Event{name, category, QString(), traceId, startUs, qMax<qint64>(endUs - startUs, 0), args});
+}
+
+void Tracing::record(const QString& name, const char* category, qint64 startUs, qint64 endUs,
+                     const QString& traceId, const QJsonObject& args)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    append(Event{nullptr, category, name, traceId, startUs, qMax<qint64>(endUs - startUs, 0), args});
+}
+
+void Tracing::append(Event&& event)
+{
+    ThreadBuffer* buffer = threadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    if (buffer->events.size() >= kMaxEventsPerThread) {
+        registry().dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events.append(std::move(event));
+}
+
+void Tracing::addRemoteSpans(const QJsonObject& trace)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    const QString traceId = trace["trace_id"].toString();
+    const QJsonArray spans = trace["spans"].toArray();
+
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    for (const QJsonValue& value : spans) {
+        if (reg.remoteSpans.size() >= kMaxRemoteSpans) {
+            reg.dropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        QJsonObject span = value.toObject();
+        if (!traceId.isEmpty()) {
+            QJsonObject args = span["args"].toObject();
+            args["trace_id"] = traceId;
+            span["args"] = args;
+        }
+        reg.remoteSpans.append(span);
+    }
+}
+
+bool Tracing::exportChromeTrace(const QString& filePath)
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray events;
+    events.append(metadataEvent("process_name", pid, 0, QStringLiteral("FundAnalysis")));
+
+    Registry& reg = registry();
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    QSet<qint64> remotePids;
+    {
+        QMutexLocker locker(&reg.mutex);
+        buffers = reg.buffers;
+        for (const QJsonObject& span : std::as_const(reg.remoteSpans)) {
+            events.append(span);
+            remotePids.insert(span["pid"].toInteger());
+        }
+    }
+
+    for (qint64 remotePid : std::as_const(remotePids)) {
+        if (remotePid != pid) {
+            events.append(metadataEvent("process_name", remotePid, 0, QString("backend %1").arg(remotePid)));
+        }
+    }
+
+    for (const auto& buffer : buffers) {
+        QMutexLocker locker(&buffer->mutex);
+        events.append(metadataEvent("thread_name", pid, buffer->tid, buffer->threadName));
+        for (const Event& event : std::as_const(buffer->events)) {
+            QJsonObject args = event.args;
+            if (!event.traceId.isEmpty()) {
+                args["trace_id"] = event.traceId;
+            }
+            QJsonObject object{
+                {"name", event.name ? QString::fromLatin1(event.name) : event.dynamicName},
+                {"cat", event.category},
+                {"ph", "X"},
+                {"ts", event.startUs},
+                {"dur", event.durationUs},
+                {"pid", pid},
+                {"tid", buffer->tid}
+            };
+            if (!args.isEmpty()) {
+                object["args"] = args;
+            }
+            events.append(object);
+        }
+    }
+
+    QJsonObject root{
+        {"traceEvents", events},
+        {"displayTimeUnit", "ms"}
+    };
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        Logger::instance()->error(QString("Failed to write trace file: %1").arg(filePath));
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    file.close();
+
+    Logger::instance()->info(QString("Trace exported: %1 (%2 events, %3 dropped)")
+        .arg(filePath).arg(events.size()).arg(droppedCount()));
+    return true;
+}
+
+void Tracing::clear()
+{
+    Registry& reg = registry();
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        QMutexLocker locker(&reg.mutex);
+        buffers = reg.buffers;
+        reg.remoteSpans.clear();
+        reg.dropped.store(0, std::memory_order_relaxed);
+    }
+    for (const auto& buffer : buffers) {
+        QMutexLocker locker(&buffer->mutex);
+        buffer->events.clear();
+    }
+}
+
+quint64 Tracing::droppedCount()
+{
+    return registry().dropped.load(std::memory_order_relaxed);
+}
+
+// ==================== TraceSpan ====================
+
+TraceSpan::TraceSpan(const char* name, const char* category, const QString& traceId)
+    : m_name(name)
+    , m_category(category)
+    , m_startUs(0)
+    , m_active(Tracing::isEnabled())
+    , m_ownsTraceId(false)
+{
+    if (!m_active) {
+        return;
+    }
+
+    m_previousTraceId = Tracing::currentTraceId();
+    if (!traceId.isEmpty()) {
+        m_traceId = traceId;
+        m_ownsTraceId = true;
+        Tracing::setCurrentTraceId(traceId);
+    } else {
+        m_traceId = m_previousTraceId;
+    }
+    m_startUs = Tracing::nowUs();
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (!m_active) {
+        return;
+    }
+
+    Tracing::record(m_name, m_category, m_startUs, Tracing::nowUs(), m_traceId, m_args);
+    if (m_ownsTraceId) {
+        Tracing::setCurrentTraceId(m_previousTraceId);
+    }
+}
+
+void TraceSpan::setArg(const QString& key, const QJsonValue& value)
+{
+    if (m_active) {
+        m_args.insert(key, value);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <QString>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QVector>
+#include <atomic>
+
+// 端到端追踪：按 Chrome trace-event 格式（chrome://tracing / Perfetto）记录耗时区间
+// 每个线程写自己的缓冲区，记录时只取本线程的锁；时间戳为单调时钟，
+// 起点对齐到系统时钟的微秒数，后端用墙钟记录的区间可以直接合并到同一时间轴
+// 一次用户操作分配一个 trace_id，随请求发往后端，后端区间随响应带回
+class Tracing
+{
+public:
+    struct Event {
+        const char* name;
+        const char* category;
+        QString dynamicName;       // 非空时代替 name（例如带动作名的区间）
+        QString traceId;
+        qint64 startUs = 0;
+        qint64 durationUs = 0;
+        QJsonObject args;
+    };
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // 当前时刻（微秒，单调递增，与系统时钟同一起点）
+    static qint64 nowUs();
+
+    // 新的 trace_id（16 位十六进制）；当前线程正在进行的 trace_id 由 TraceSpan 设置
+    static QString newTraceId();
+    static QString currentTraceId();
+
+    // 记录一个已结束的区间（任意线程）
+    static void record(const char* name, const char* category, qint64 startUs, qint64 endUs,
+                       const QString& traceId = QString(), const QJsonObject& args = QJsonObject());
+    static void record(const QString& name, const char* category, qint64 startUs, qint64 endUs,
+                       const QString& traceId = QString(), const QJsonObject& args = QJsonObject());
+
+    // 合并后端随响应带回的区间：{"trace_id": ..., "spans": [Chrome 事件...]}
+    static void addRemoteSpans(const QJsonObject& trace);
+
+    // 导出所有线程的区间与后端区间，成功返回 true
+    static bool exportChromeTrace(const QString& filePath);
+    static void clear();
+
+    // 超过上限后丢弃的区间数
+    static quint64 droppedCount();
+
+private:
+    friend class TraceSpan;
+    static void setCurrentTraceId(const QString& traceId);
+    static void append(Event&& event);
+
+    static std::atomic<bool> s_enabled;
+};
+
+// 作用域区间：构造时记下开始时刻，析构时记录
+// 传入 traceId 时在作用域内设为当前线程的 trace_id（同线程发出的请求会带上它），析构时恢复
+class TraceSpan
+{
+public:
+    TraceSpan(const char* name, const char* category, const QString& traceId = QString());
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    void setArg(const QString& key, const QJsonValue& value);
+    const QString& traceId() const { return m_traceId; }
+
+private:
+    const char* m_name;
+    const char* m_category;
+    QString m_traceId;
+    QString m_previousTraceId;
+    QJsonObject m_args;
+    qint64 m_startUs;
+    bool m_active;
+    bool m_ownsTraceId;
+};
+
+#endif // TRACING_H
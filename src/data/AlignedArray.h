@@ -0,0 +1,112 @@
+#ifndef ALIGNEDARRAY_H
+#define ALIGNEDARRAY_H
+
+#include <QtGlobal>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 按 64 字节（缓存行）对齐的列缓冲区，供列式数据做顺序扫描与 SIMD 向量化
+// 容量向上取整到整个缓存行，尾部多出的空间清零，扫描循环可以按整行读取而不越界
+template <typename T>
+class AlignedArray
+{
+    static_assert(std::is_trivially_copyable_v<T>, "AlignedArray only holds trivially copyable types");
+
+public:
+    static constexpr size_t kAlignment = 64;
+
+    AlignedArray() = default;
+    explicit AlignedArray(qsizetype size) { resize(size); }
+    ~AlignedArray() { release(); }
+
+    AlignedArray(const AlignedArray&) = delete;
+    AlignedArray& operator=(const AlignedArray&) = delete;
+
+    AlignedArray(AlignedArray&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+        , m_capacity(std::exchange(other.m_capacity, 0))
+    {
+    }
+
+    AlignedArray& operator=(AlignedArray&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_capacity = std::exchange(other.m_capacity, 0);
+        }
+        return *this;
+    }
+
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+    qsizetype size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    qsizetype capacity() const { return m_capacity; }
+    qint64 allocatedBytes() const { return qint64(m_capacity) * qint64(sizeof(T)); }
+
+    T& operator[](qsizetype i) { return m_data[i]; }
+    const T& operator[](qsizetype i) const { return m_data[i]; }
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+
+    // 新增的元素清零
+    void resize(qsizetype size)
+    {
+        reserve(size);
+        if (size > m_size) {
+            std::memset(static_cast<void*>(m_data + m_size), 0, size_t(size - m_size) * sizeof(T));
+        }
+        m_size = size;
+    }
+
+    void reserve(qsizetype capacity)
+    {
+        if (capacity <= m_capacity) {
+            return;
+        }
+        const size_t bytes = (size_t(capacity) * sizeof(T) + kAlignment - 1) / kAlignment * kAlignment;
+        T* data = static_cast<T*>(::operator new(bytes, std::align_val_t(kAlignment)));
+        std::memset(static_cast<void*>(data), 0, bytes);
+        if (m_size > 0) {
+            std::memcpy(static_cast<void*>(data), m_data, size_t(m_size) * sizeof(T));
+        }
+        release();
+        m_data = data;
+        m_capacity = qsizetype(bytes / sizeof(T));
+    }
+
+    void append(const T& value)
+    {
+        if (m_size == m_capacity) {
+            reserve(qMax<qsizetype>(m_capacity * 2, kAlignment / sizeof(T)));
+        }
+        m_data[m_size++] = value;
+    }
+
+    void clear()
+    {
+        release();
+        m_data = nullptr;
+        m_size = 0;
+        m_capacity = 0;
+    }
+
+private:
+    void release()
+    {
+        if (m_data) {
+            ::operator delete(m_data, std::align_val_t(kAlignment));
+        }
+    }
+
+    T* m_data = nullptr;
+    qsizetype m_size = 0;
+    qsizetype m_capacity = 0;
+};
+
+#endif // ALIGNEDARRAY_H
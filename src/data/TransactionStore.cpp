@@ -0,0 +1,188 @@
+#include "data/TransactionStore.h"
+#include "network/ColumnarFile.h"
+#include <QJsonObject>
+#include <cmath>
+
+namespace {
+
+const char* const kTimeColumn = "txn_time";
+const char* const kAmountColumn = "amount";
+const char* const kDirectionColumn = "direction";
+const char* const kAccountColumn = "account";
+const char* const kCounterpartyColumn = "counterparty";
+const char* const kBalanceColumn = "balance";
+const char* const kMemoColumn = "memo";
+
+// 数值列可能是整数或小数；缺失的列保持为 0
+template <typename T>
+void copyNumeric(const ColumnarFile& file, int column, AlignedArray<T>& target)
+{
+    if (column < 0) {
+        return;
+    }
+    const qint64 rows = file.rowCount();
+    if (const qint64* ints = file.int64Data(column)) {
+        for (qint64 i = 0; i < rows; ++i) {
+            target[i] = T(ints[i]);
+        }
+    } else if (const double* doubles = file.float64Data(column)) {
+        for (qint64 i = 0; i < rows; ++i) {
+            target[i] = std::is_integral_v<T> ? T(std::llround(doubles[i])) : T(doubles[i]);
+        }
+    }
+}
+
+// 流水中相邻行的账号、摘要经常相同，先与上一行比较可以省掉大部分哈希查找
+void internColumn(const ColumnarFile& file, int column, StringDictionary& dictionary, AlignedArray<quint32>& target)
+{
+    if (column < 0 || file.column(column).type != ColumnarFile::String) {
+        return;
+    }
+    QByteArrayView previous;
+    quint32 previousId = 0;
+    for (qint64 i = 0; i < file.rowCount(); ++i) {
+        const QByteArrayView value = file.stringAt(column, i);
+        if (i == 0 || value != previous) {
+            previous = value;
+            previousId = dictionary.intern(value);
+        }
+        target[i] = previousId;
+    }
+}
+
+} // namespace
+
+// ==================== StringDictionary ====================
+
+StringDictionary::StringDictionary()
+{
+    m_values.append(QByteArray());
+    m_ids.insert(QByteArray(), 0);
+}
+
+quint32 StringDictionary::intern(QByteArrayView value)
+{
+    // 以原始数据构造临时键查找，只有新值才复制
+    const auto it = m_ids.constFind(QByteArray::fromRawData(value.data(), value.size()));
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+    const quint32 id = quint32(m_values.size());
+    const QByteArray copy = value.toByteArray();
+    m_values.append(copy);
+    m_ids.insert(copy, id);
+    return id;
+}
+
+qint64 StringDictionary::find(QByteArrayView value) const
+{
+    const auto it = m_ids.constFind(QByteArray::fromRawData(value.data(), value.size()));
+    return it != m_ids.constEnd() ? qint64(it.value()) : -1;
+}
+
+qint64 StringDictionary::memoryBytes() const
+{
+    qint64 bytes = m_values.capacity() * qint64(sizeof(QByteArray));
+    for (const QByteArray& value : m_values) {
+        bytes += value.capacity();
+    }
+    // 哈希节点：键（共享数据，只算对象本身）+ 值 + 桶
+    return bytes + m_ids.capacity() * qint64(sizeof(QByteArray) + sizeof(quint32) + sizeof(void*));
+}
+
+// ==================== TransactionStore ====================
+
+bool TransactionStore::loadColumnar(const ColumnarFile& file)
+{
+    m_error.clear();
+    const int time = file.columnIndex(kTimeColumn);
+    const int amount = file.columnIndex(kAmountColumn);
+    const int account = file.columnIndex(kAccountColumn);
+    if (time < 0 || amount < 0 || account < 0) {
+        m_error = "Missing required column (txn_time, amount, account)";
+        return false;
+    }
+
+    // 逐列填充：每次只顺序访问源文件的一列和目标的一个数组
+    resizeColumns(file.rowCount());
+    copyNumeric(file, time, m_timestamps);
+    copyNumeric(file, amount, m_amounts);
+    copyNumeric(file, file.columnIndex(kBalanceColumn), m_balances);
+    internColumn(file, account, m_accounts, m_accountIds);
+    internColumn(file, file.columnIndex(kCounterpartyColumn), m_accounts, m_counterpartyIds);
+    internColumn(file, file.columnIndex(kMemoColumn), m_memos, m_memoIds);
+
+    const int direction = file.columnIndex(kDirectionColumn);
+    if (direction >= 0 && file.column(direction).type == ColumnarFile::String) {
+        for (qint64 i = 0; i < file.rowCount(); ++i) {
+            m_directions[i] = parseDirection(file.stringAt(direction, i));
+        }
+    } else if (direction >= 0 && file.int64Data(direction)) {
+        const qint64* values = file.int64Data(direction);
+        for (qint64 i = 0; i < file.rowCount(); ++i) {
+            m_directions[i] = values[i] > 0 ? Inflow : values[i] < 0 ? Outflow : Unknown;
+        }
+    }
+    return true;
+}
+
+bool TransactionStore::loadRows(const QJsonArray& rows)
+{
+    m_error.clear();
+    resizeColumns(rows.size());
+    for (qsizetype i = 0; i < rows.size(); ++i) {
+        const QJsonObject row = rows.at(i).toObject();
+        if (!row.contains(kTimeColumn) || !row.contains(kAmountColumn)) {
+            m_error = QString("Row %1 is missing txn_time or amount").arg(i);
+            return false;
+        }
+        m_timestamps[i] = row.value(kTimeColumn).toInteger();
+        m_amounts[i] = row.value(kAmountColumn).toDouble();
+        m_balances[i] = row.value(kBalanceColumn).toDouble();
+        m_directions[i] = parseDirection(row.value(kDirectionColumn).toString().toUtf8());
+        m_accountIds[i] = m_accounts.intern(row.value(kAccountColumn).toString().toUtf8());
+        m_counterpartyIds[i] = m_accounts.intern(row.value(kCounterpartyColumn).toString().toUtf8());
+        m_memoIds[i] = m_memos.intern(row.value(kMemoColumn).toString().toUtf8());
+    }
+    return true;
+}
+
+void TransactionStore::resizeColumns(qint64 rows)
+{
+    m_timestamps.resize(rows);
+    m_amounts.resize(rows);
+    m_directions.resize(rows);
+    m_accountIds.resize(rows);
+    m_counterpartyIds.resize(rows);
+    m_balances.resize(rows);
+    m_memoIds.resize(rows);
+}
+
+qint64 TransactionStore::memoryBytes() const
+{
+    return m_timestamps.allocatedBytes() + m_amounts.allocatedBytes() + m_directions.allocatedBytes()
+         + m_accountIds.allocatedBytes() + m_counterpartyIds.allocatedBytes() + m_balances.allocatedBytes()
+         + m_memoIds.allocatedBytes() + m_accounts.memoryBytes() + m_memos.memoryBytes();
+}
+
+TransactionStore::Direction TransactionStore::parseDirection(QByteArrayView value)
+{
+    const QByteArrayView trimmed = value.trimmed();
+    if (trimmed.isEmpty()) {
+        return Unknown;
+    }
+    // 后端为 in / out，银行流水中常见 贷 / 借、收 / 支、C / D
+    static const char* const kInflow[] = {"in", "credit", "c", "+", "贷", "收", "收入", "转入"};
+    static const char* const kOutflow[] = {"out", "debit", "d", "-", "借", "支", "支出", "转出"};
+    for (const char* candidate : kInflow) {
+        if (trimmed.compare(QByteArrayView(candidate), Qt::CaseInsensitive) == 0) {
+            return Inflow;
+        }
+    }
+    for (const char* candidate : kOutflow) {
+        if (trimmed.compare(QByteArrayView(candidate), Qt::CaseInsensitive) == 0) {
+            return Outflow;
+        }
+    }
+    return Unknown;
+}
@@ -0,0 +1,99 @@
+#ifndef TRANSACTIONSTORE_H
+#define TRANSACTIONSTORE_H
+
+#include "data/AlignedArray.h"
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QJsonArray>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+class ColumnarFile;
+
+// 字符串字典：每个不同的值只保存一次，列中只存 32 位编号；编号 0 固定为空字符串
+class StringDictionary
+{
+public:
+    StringDictionary();
+
+    quint32 intern(QByteArrayView value);
+    // 不存在时返回 -1
+    qint64 find(QByteArrayView value) const;
+
+    QByteArrayView at(quint32 id) const { return m_values.at(id); }
+    qsizetype size() const { return m_values.size(); }
+    qint64 memoryBytes() const;
+
+private:
+    QVector<QByteArray> m_values;                // 与 m_ids 的键共享数据
+    QHash<QByteArray, quint32> m_ids;
+};
+
+// 任务交易明细的客户端列式存储：每个字段一个 64 字节对齐的数组（struct-of-arrays），
+// 账号、对方账号与摘要按字典编码，查询、统计、可视分析等视图直接扫描列，不必为每次筛选访问后端
+// 由工作区加载一次后以 TransactionStorePtr 在各子窗口间只读共享，加载完成后不再修改，可在任意线程读取
+class TransactionStore
+{
+public:
+    enum Direction : qint8 {
+        Outflow = -1,                            // 支出（借）
+        Unknown = 0,
+        Inflow = 1                               // 收入（贷）
+    };
+
+    TransactionStore() = default;
+
+    // 后端 data.query 的结果：列式文件（txn_time / amount / direction / account / counterparty / balance / memo）
+    // 或按行的 JSON（非批量通道的 chunks[].rows）；失败时见 errorString()
+    bool loadColumnar(const ColumnarFile& file);
+    bool loadRows(const QJsonArray& rows);
+    QString errorString() const { return m_error; }
+
+    qint64 rowCount() const { return m_timestamps.size(); }
+
+    const qint64* timestamps() const { return m_timestamps.data(); }      // UTC 秒
+    const double* amounts() const { return m_amounts.data(); }
+    const qint8* directions() const { return m_directions.data(); }
+    const quint32* accountIds() const { return m_accountIds.data(); }     // accounts() 中的编号
+    const quint32* counterpartyIds() const { return m_counterpartyIds.data(); }
+    const double* balances() const { return m_balances.data(); }
+    const quint32* memoIds() const { return m_memoIds.data(); }           // memos() 中的编号
+
+    // 本方账号与对方账号共用一个字典，同一账号在两列中编号相同
+    const StringDictionary& accounts() const { return m_accounts; }
+    const StringDictionary& memos() const { return m_memos; }
+
+    QByteArrayView account(qint64 row) const { return m_accounts.at(m_accountIds[row]); }
+    QByteArrayView counterparty(qint64 row) const { return m_accounts.at(m_counterpartyIds[row]); }
+    QByteArrayView memo(qint64 row) const { return m_memos.at(m_memoIds[row]); }
+
+    qint64 memoryBytes() const;
+
+    static Direction parseDirection(QByteArrayView value);
+
+private:
+    void resizeColumns(qint64 rows);
+
+private:
+    AlignedArray<qint64> m_timestamps;
+    AlignedArray<double> m_amounts;
+    AlignedArray<qint8> m_directions;
+    AlignedArray<quint32> m_accountIds;
+    AlignedArray<quint32> m_counterpartyIds;
+    AlignedArray<double> m_balances;
+    AlignedArray<quint32> m_memoIds;
+    StringDictionary m_accounts;
+    StringDictionary m_memos;
+    QString m_error;
+
+    Q_DISABLE_COPY(TransactionStore)
+};
+
+// 工作区各子窗口以动态属性 "transactionStore" 持有同一份存储，最后一个子窗口关闭时释放
+using TransactionStorePtr = std::shared_ptr<const TransactionStore>;
+Q_DECLARE_METATYPE(TransactionStorePtr)
+
+#endif // TRANSACTIONSTORE_H
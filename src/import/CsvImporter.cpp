@@ -0,0 +1,539 @@
+#include "import/CsvImporter.h"
+#include "import/CsvScanner.h"
+#include "core/Logger.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringDecoder>
+#include <QThread>
+#include <QtConcurrent>
+
+namespace {
+
+// 编码检测与分隔符检测读取的字节数
+constexpr qint64 kEncodingSampleBytes = 4 * 1024 * 1024;
+constexpr qint64 kDelimiterSampleBytes = 64 * 1024;
+// 解析线程每隔多少行检查一次取消
+constexpr qint64 kCancelCheckRows = 4096;
+// 在切块位置之后查找行首的最大范围（至少一个块），超出后按行重新切块
+constexpr qint64 kBoundaryScanBytes = 4 * 1024 * 1024;
+
+const char kDelimiterCandidates[] = {',', '\t', '|', ';'};
+
+const char* decoderName(CsvImporter::Encoding encoding)
+{
+    return encoding == CsvImporter::Gbk ? "GB18030" : "UTF-8";
+}
+
+} // namespace
+
+struct CsvImporter::Chunk {
+    qint64 begin = 0;               // 切块位置
+    qint64 end = 0;
+    qint64 quotes = 0;              // 块内的引号数，定位行首时换算为之前所有块的引号总数
+    qint64 rowStart = 0;            // 第一个完整行的起点
+    qint64 rowEnd = 0;              // 下一块第一行的起点
+    qint64 parsedEnd = 0;           // 解析实际结束的位置，切块正确时等于 rowEnd
+    ImportBatch batch;
+    qint64 typeWidenings = 0;
+    qint64 raggedRows = 0;
+    qint64 firstWidenRow = -1;      // 块内行号
+    int firstWidenColumn = -1;
+};
+
+CsvImporter::CsvImporter(const Options& options)
+    : m_options(options)
+    , m_cancelled(false)
+    , m_encoding(Utf8)
+    , m_delimiter(',')
+    , m_averageRowBytes(128)
+{
+    m_options.chunkBytes = qMax<qint64>(m_options.chunkBytes, 64 * 1024);
+    m_pool.setMaxThreadCount(m_options.threads > 0 ? m_options.threads : QThread::idealThreadCount());
+}
+
+CsvImporter::~CsvImporter()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+bool CsvImporter::import(const QString& path, const ImportBatchHandler& onBatch)
+{
+    m_error.clear();
+    m_stats = Stats();
+    m_cancelled.store(false, std::memory_order_relaxed);
+    m_columnNames.clear();
+    m_columnTypes.clear();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_error = file.errorString();
+        return false;
+    }
+    const qint64 size = file.size();
+    if (size == 0) {
+        m_error = "File is empty";
+        return false;
+    }
+    // 整个文件只读映射，解析线程直接读取映射区；QFile 析构时解除映射
+    const uchar* mapped = file.map(0, size);
+    if (!mapped) {
+        m_error = "Failed to map file: " + file.errorString();
+        return false;
+    }
+    const char* data = reinterpret_cast<const char*>(mapped);
+
+    qint64 dataStart = 0;
+    if (!detectFormat(data, size, &dataStart)) {
+        return false;
+    }
+    inferColumnTypes(data, size, dataStart);
+
+    QVector<Chunk> chunks;
+    locateChunks(data, size, dataStart, chunks);
+
+    const QString source = QFileInfo(path).fileName();
+
+    // 每次并行解析一个窗口的块，交付后立即释放，内存占用与文件大小无关
+    const qsizetype window = qMax(1, m_pool.maxThreadCount() * 2);
+    qint64 nextRow = 0;
+    qsizetype first = 0;
+    while (first < chunks.size() && !isCancelled()) {
+        qsizetype last = qMin(first + window, chunks.size());
+        QtConcurrent::blockingMap(&m_pool, chunks.begin() + first, chunks.begin() + last,
+                                  [this, data, size](Chunk& chunk) { parseChunk(data, size, chunk); });
+
+        for (qsizetype i = first; i < last; ++i) {
+            Chunk& chunk = chunks[i];
+            if (!isCancelled() && chunk.batch.rowCount > 0) {
+                if (chunk.firstWidenRow >= 0 && m_stats.typeWidenings == 0) {
+                    Logger::instance()->warning(QString("CSV value does not match column type: row %1, column %2 (%3), column widened to %4")
+                        .arg(nextRow + chunk.firstWidenRow + 1)
+                        .arg(m_columnNames.value(chunk.firstWidenColumn))
+                        .arg(ImportColumn::typeName(m_columnTypes.value(chunk.firstWidenColumn)))
+                        .arg(ImportColumn::typeName(chunk.batch.columns[chunk.firstWidenColumn].type)));
+                }
+                m_stats.typeWidenings += chunk.typeWidenings;
+                m_stats.raggedRows += chunk.raggedRows;
+                // 之后的窗口直接从放宽后的类型开始，减少重新编码
+                for (qsizetype c = 0; c < m_columnTypes.size(); ++c) {
+                    m_columnTypes[c] = ImportColumn::widerType(m_columnTypes[c], chunk.batch.columns[c].type);
+                }
+
+                chunk.batch.source = source;
+                chunk.batch.columnNames = m_columnNames;
+                chunk.batch.firstRow = nextRow;
+                nextRow += chunk.batch.rowCount;
+                if (!onBatch(chunk.batch)) {
+                    cancel();
+                }
+            }
+            chunk.batch = ImportBatch();
+
+            // 本块从正确的行首开始解析，最后一行越过了下一块的起点，说明引号奇偶性在字段中间的裸引号处失准，
+            // 之后各块的起点都不可靠：丢弃已解析的结果，从本块实际结束处起按行重新切块
+            if (!isCancelled() && chunk.parsedEnd != chunk.rowEnd) {
+                const qint64 resume = chunk.parsedEnd;
+                Logger::instance()->warning(QString("CSV chunk boundary mismatch at byte %1 (stray quote inside a field), "
+                                                    "re-splitting the rest of the file by rows").arg(chunk.rowEnd));
+                chunks.resize(i + 1);
+                splitRows(data, size, resume, chunks);
+                last = i + 1;
+                break;
+            }
+        }
+        first = last;
+    }
+
+    m_stats.rows = nextRow;
+    m_stats.bytes = size;
+    m_stats.elapsedMs = timer.elapsed();
+    m_stats.encoding = m_encoding;
+    m_stats.delimiter = m_delimiter;
+    m_stats.threads = m_pool.maxThreadCount();
+
+    if (isCancelled()) {
+        m_error = "Import cancelled";
+        Logger::instance()->info(QString("CSV import cancelled after %1 rows: %2").arg(nextRow).arg(path));
+        return false;
+    }
+
+    const double seconds = qMax<qint64>(m_stats.elapsedMs, 1) / 1000.0;
+    Logger::instance()->info(QString("CSV imported: %1 rows, %2 MB in %3 ms (%4 MB/s, %5, %6 threads, %7 type widenings, %8 ragged rows)")
+        .arg(nextRow)
+        .arg(size / 1048576.0, 0, 'f', 1)
+        .arg(m_stats.elapsedMs)
+        .arg(size / 1048576.0 / seconds, 0, 'f', 0)
+        .arg(encodingName(m_encoding))
+        .arg(m_stats.threads)
+        .arg(m_stats.typeWidenings)
+        .arg(m_stats.raggedRows));
+    return true;
+}
+
+bool CsvImporter::detectFormat(const char* data, qint64 size, qint64* dataStart)
+{
+    const uchar* bytes = reinterpret_cast<const uchar*>(data);
+    qint64 pos = 0;
+
+    // 1. 编码：BOM 优先，否则按 UTF-8 校验采样，不合法时按 GBK 处理
+    m_encoding = m_options.encoding;
+    if (size >= 2 && ((bytes[0] == 0xFF && bytes[1] == 0xFE) || (bytes[0] == 0xFE && bytes[1] == 0xFF))) {
+        m_error = "UTF-16 files are not supported";
+        return false;
+    }
+    if (size >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+        pos = 3;
+        if (m_encoding == AutoDetect) {
+            m_encoding = Utf8;
+        }
+    }
+    if (m_encoding == AutoDetect) {
+        const qint64 sample = qMin(size - pos, kEncodingSampleBytes);
+        m_encoding = CsvScanner::isValidUtf8(data + pos, size_t(sample), sample < size - pos) ? Utf8 : Gbk;
+    }
+    if (m_encoding == Gbk && !QStringDecoder(decoderName(Gbk)).isValid()) {
+        m_error = "GBK decoding is not available (Qt built without ICU)";
+        return false;
+    }
+
+    // 2. 分隔符：第一行中（引号外）出现次数最多的候选字符
+    m_delimiter = m_options.delimiter;
+    if (m_delimiter == 0) {
+        int counts[sizeof(kDelimiterCandidates)] = {};
+        const qint64 limit = qMin(size, pos + kDelimiterSampleBytes);
+        bool inQuotes = false;
+        for (qint64 i = pos; i < limit; ++i) {
+            const uchar c = bytes[i];
+            if (m_encoding == Gbk && c >= 0x81) {
+                ++i;
+                continue;
+            }
+            if (c == '"') {
+                inQuotes = !inQuotes;
+            } else if (c == '\n' && !inQuotes) {
+                break;
+            } else if (!inQuotes) {
+                for (size_t k = 0; k < sizeof(kDelimiterCandidates); ++k) {
+                    counts[k] += c == uchar(kDelimiterCandidates[k]);
+                }
+            }
+        }
+        m_delimiter = ',';
+        int best = 0;
+        for (size_t k = 0; k < sizeof(kDelimiterCandidates); ++k) {
+            if (counts[k] > best) {
+                best = counts[k];
+                m_delimiter = kDelimiterCandidates[k];
+            }
+        }
+    }
+
+    // 3. 表头：列名解码为 QString；没有表头时按第一行的字段数命名
+    CsvScanner scanner(data, size_t(size), m_delimiter, multibyteSafe());
+    QVector<Field> fields;
+    const qint64 firstRowEnd = tokenizeRow(scanner, data, size, pos, fields);
+    QStringDecoder decoder(decoderName(m_encoding), QStringConverter::Flag::Stateless);
+    QByteArray scratch;
+    for (qsizetype i = 0; i < fields.size(); ++i) {
+        QString name;
+        if (m_options.hasHeader) {
+            name = QString(decoder.decode(fieldValue(data, fields[i], scratch))).trimmed();
+        }
+        m_columnNames.append(name.isEmpty() ? QString("列%1").arg(i + 1) : name);
+    }
+    *dataStart = m_options.hasHeader ? firstRowEnd : pos;
+    return true;
+}
+
+void CsvImporter::inferColumnTypes(const char* data, qint64 size, qint64 start)
+{
+    const qsizetype columnCount = m_columnNames.size();
+    ImportTypeInference inference(columnCount);
+
+    CsvScanner scanner(data, size_t(size), m_delimiter, multibyteSafe());
+    QVector<Field> fields;
+    QByteArray scratch;
+    qint64 pos = start;
+    int rows = 0;
+    while (pos < size && rows < m_options.sampleRows) {
+        pos = tokenizeRow(scanner, data, size, pos, fields);
+        ++rows;
+        for (qsizetype c = 0; c < qMin(columnCount, fields.size()); ++c) {
+            // ="..." 是 Excel 的强制文本写法
+            const bool forcedText = !fields[c].quoted && QByteArrayView(data + fields[c].begin, fields[c].end - fields[c].begin)
+                                                             .trimmed().startsWith("=\"");
+            inference.observeText(c, fieldValue(data, fields[c], scratch), forcedText);
+        }
+    }
+    m_averageRowBytes = rows > 0 ? qMax<qint64>((pos - start) / rows, 1) : 128;
+
+    m_columnTypes.resize(columnCount);
+    for (qsizetype c = 0; c < columnCount; ++c) {
+        m_columnTypes[c] = m_options.columnTypes.value(m_columnNames[c], inference.type(c));
+    }
+}
+
+void CsvImporter::locateChunks(const char* data, qint64 size, qint64 dataStart, QVector<Chunk>& chunks)
+{
+    for (qint64 begin = dataStart; begin < size; begin += m_options.chunkBytes) {
+        Chunk chunk;
+        chunk.begin = begin;
+        chunk.end = qMin(size, begin + m_options.chunkBytes);
+        chunks.append(chunk);
+    }
+    if (chunks.isEmpty()) {
+        return;
+    }
+
+    // 1. 并行统计各块的引号数
+    QtConcurrent::blockingMap(&m_pool, chunks, [data](Chunk& chunk) {
+        chunk.quotes = qint64(CsvScanner::countQuotes(data + chunk.begin, size_t(chunk.end - chunk.begin)));
+    });
+
+    // 2. 之前所有块的引号数为奇数时切块位置在引号内：从切块位置起找第一个引号外的换行，下一字节即为行首
+    //    （"" 转义计为两个引号，不改变奇偶性）。各块的查找互不依赖，并行进行；
+    //    字段中间的裸引号会让之后的奇偶性失准，查找范围因此有上限，否则每块都可能扫描到文件末尾
+    qint64 quotes = 0;
+    for (Chunk& chunk : chunks) {
+        const qint64 own = chunk.quotes;
+        chunk.quotes = quotes;
+        quotes += own;
+    }
+    const qint64 scanBytes = qMax(m_options.chunkBytes, kBoundaryScanBytes);
+    if (chunks.size() > 1) {
+        QtConcurrent::blockingMap(&m_pool, chunks.begin() + 1, chunks.end(), [data, size, scanBytes](Chunk& chunk) {
+            const qint64 limit = qMin(size, chunk.begin + scanBytes);
+            bool inQuotes = chunk.quotes % 2 == 1;
+            chunk.rowStart = limit < size ? -1 : size;  // -1：范围内没有找到行首
+            for (qint64 i = chunk.begin; i < limit; ++i) {
+                const char c = data[i];
+                if (c == '"') {
+                    inQuotes = !inQuotes;
+                } else if (c == '\n' && !inQuotes) {
+                    chunk.rowStart = i + 1;
+                    break;
+                }
+            }
+        });
+    }
+
+    chunks[0].rowStart = dataStart;
+    for (qsizetype k = 1; k < chunks.size(); ++k) {
+        if (chunks[k].rowStart < 0) {
+            // 找不到可靠的行首：从上一块的行首起用解析的分词器按行切块（串行，但只扫描一遍）
+            const qint64 resume = chunks[k - 1].rowStart;
+            Logger::instance()->warning(QString("CSV row boundary not found near byte %1 (stray or long quoted field), "
+                                                "splitting the rest of the file by rows").arg(chunks[k].begin));
+            for (qsizetype j = 0; j < k - 1; ++j) {
+                chunks[j].rowEnd = chunks[j + 1].rowStart;
+            }
+            chunks.resize(k - 1);
+            splitRows(data, size, resume, chunks);
+            return;
+        }
+        chunks[k].rowStart = qMax(chunks[k].rowStart, chunks[k - 1].rowStart);
+    }
+    for (qsizetype k = 0; k < chunks.size(); ++k) {
+        chunks[k].rowEnd = k + 1 < chunks.size() ? chunks[k + 1].rowStart : size;
+    }
+}
+
+void CsvImporter::splitRows(const char* data, qint64 size, qint64 start, QVector<Chunk>& chunks) const
+{
+    // 与解析使用同一个分词器，块边界一定落在真正的行首
+    CsvScanner scanner(data, size_t(size), m_delimiter, multibyteSafe());
+    QVector<Field> fields;
+    qint64 pos = start;
+    while (pos < size && !isCancelled()) {
+        Chunk chunk;
+        chunk.begin = pos;
+        chunk.rowStart = pos;
+        const qint64 target = pos + m_options.chunkBytes;
+        while (pos < size && pos < target) {
+            pos = tokenizeRow(scanner, data, size, pos, fields);
+        }
+        chunk.end = pos;
+        chunk.rowEnd = pos;
+        chunks.append(chunk);
+    }
+}
+
+void CsvImporter::parseChunk(const char* data, qint64 size, Chunk& chunk) const
+{
+    chunk.parsedEnd = chunk.rowStart;
+    if (isCancelled() || chunk.rowStart >= chunk.rowEnd) {
+        return;
+    }
+
+    const qsizetype columnCount = m_columnTypes.size();
+    const qint64 estimatedRows = (chunk.rowEnd - chunk.rowStart) / m_averageRowBytes + 16;
+    ImportBatch& batch = chunk.batch;
+    batch.columns.resize(columnCount);
+    for (qsizetype c = 0; c < columnCount; ++c) {
+        batch.columns[c].reset(m_columnTypes[c], estimatedRows);
+    }
+
+    // 每个字段独立解码，不跨字段保留状态（字段边界都在 ASCII 分隔符上，不会截断多字节字符）
+    QStringDecoder decoder(decoderName(m_encoding), QStringConverter::Flag::Stateless);
+    CsvScanner scanner(data, size_t(size), m_delimiter, multibyteSafe());
+    QVector<Field> fields;
+    fields.reserve(columnCount + 4);
+    QByteArray scratch;
+
+    qint64 rows = 0;
+    qint64 pos = chunk.rowStart;
+    while (pos < chunk.rowEnd) {
+        pos = tokenizeRow(scanner, data, size, pos, fields);
+        if (fields.size() == 1 && fields[0].begin == fields[0].end) {
+            continue;  // 空行
+        }
+        if (fields.size() != columnCount) {
+            ++chunk.raggedRows;
+        }
+
+        for (qsizetype c = 0; c < columnCount; ++c) {
+            ImportColumn& column = batch.columns[c];
+            const QByteArrayView value = c < fields.size() ? fieldValue(data, fields[c], scratch) : QByteArrayView();
+            // 含非 ASCII 字符的值不可能是数值或时间，先解码为 UTF-8，列被放宽为字符串时也不会混入 GBK 字节
+            bool ok;
+            if (m_encoding == Gbk && !CsvScanner::isAscii(value.data(), size_t(value.size()))) {
+                ok = column.appendText(QString(decoder.decode(value)).toUtf8());
+            } else {
+                ok = column.appendText(value);
+            }
+            if (!ok) {
+                if (chunk.firstWidenRow < 0) {
+                    chunk.firstWidenRow = rows;
+                    chunk.firstWidenColumn = int(c);
+                }
+                ++chunk.typeWidenings;
+            }
+        }
+
+        if (++rows % kCancelCheckRows == 0 && isCancelled()) {
+            break;
+        }
+    }
+    batch.rowCount = rows;
+    batch.sourceEnd = pos;
+    chunk.parsedEnd = pos;
+}
+
+qint64 CsvImporter::tokenizeRow(CsvScanner& scanner, const char* data, qint64 size, qint64 pos,
+                                QVector<Field>& fields) const
+{
+    // 只在结构字符（分隔符 / 引号 / 换行）上推进状态；引号只在字段开头时开始引用，
+    // 引用内只关心引号本身（"" 为转义），引用结束后到分隔符之间的字符在取值时忽略
+    fields.clear();
+    Field field;
+    field.begin = pos;
+    bool inQuotes = false;
+    qint64 p = pos;
+
+    auto closeField = [&](qint64 end) {
+        field.end = end;
+        fields.append(field);
+        field = Field();
+    };
+
+    while (true) {
+        const qint64 s = qint64(scanner.next(size_t(p)));
+        if (s >= size) {
+            closeField(size > field.begin && data[size - 1] == '\r' ? size - 1 : size);
+            return size;
+        }
+        const char c = data[s];
+        if (inQuotes) {
+            if (c == '"') {
+                if (s + 1 < size && data[s + 1] == '"') {
+                    field.escaped = true;
+                    p = s + 2;
+                    continue;
+                }
+                inQuotes = false;
+            }
+            p = s + 1;
+            continue;
+        }
+        if (c == '"') {
+            if (s == field.begin) {
+                inQuotes = true;
+                field.quoted = true;
+            }
+            p = s + 1;
+            continue;
+        }
+        if (c == m_delimiter) {
+            closeField(s);
+            field.begin = s + 1;
+            p = s + 1;
+            continue;
+        }
+        // 换行：CRLF 去掉行尾的 \r
+        closeField(s > field.begin && data[s - 1] == '\r' ? s - 1 : s);
+        return s + 1;
+    }
+}
+
+QByteArrayView CsvImporter::fieldValue(const char* data, const Field& field, QByteArray& scratch) const
+{
+    const char* begin = data + field.begin;
+    const char* end = data + field.end;
+
+    if (field.quoted) {
+        // 取开头引号与最后一个引号之间的内容（未闭合时取到字段末尾）
+        ++begin;
+        const char* close = end;
+        while (close > begin && close[-1] != '"') {
+            --close;
+        }
+        if (close > begin) {
+            end = close - 1;
+        }
+        if (field.escaped) {
+            scratch.clear();
+            for (const char* p = begin; p < end; ++p) {
+                scratch.append(*p);
+                if (*p == '"' && p + 1 < end && p[1] == '"') {
+                    ++p;
+                }
+            }
+            begin = scratch.constData();
+            end = begin + scratch.size();
+        }
+    }
+
+    // 银行导出常在值前加制表符或空格（防止表格软件转换格式），统一去掉首尾空白
+    while (begin < end && (*begin == ' ' || *begin == '\t')) {
+        ++begin;
+    }
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) {
+        --end;
+    }
+    // Excel 的强制文本写法 ="..."
+    if (!field.quoted && end - begin >= 3 && begin[0] == '=' && begin[1] == '"' && end[-1] == '"') {
+        begin += 2;
+        --end;
+    }
+    return QByteArrayView(begin, end - begin);
+}
+
+bool CsvImporter::multibyteSafe() const
+{
+    return m_encoding != Gbk || uchar(m_delimiter) < 0x40;
+}
+
+QString CsvImporter::encodingName(Encoding encoding)
+{
+    switch (encoding) {
+        case AutoDetect: return "auto";
+        case Utf8: return "UTF-8";
+        case Gbk: return "GBK";
+    }
+    return QString();
+}
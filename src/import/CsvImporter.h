@@ -0,0 +1,105 @@
+#ifndef CSVIMPORTER_H
+#define CSVIMPORTER_H
+
+#include "import/ImportBatch.h"
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+
+class CsvScanner;
+
+// 银行流水 CSV / TXT 导入
+// 文件只读映射到内存，按固定字节数切块：先并行统计各块的引号数，由引号奇偶性确定每块第一个完整行的起点
+// （引号内的换行不会被当作行尾），再在所有核心上并行解析各块，按文件顺序产出带类型的列批次
+// 字段中间的裸引号会让奇偶性失准：交付时校验每块最后一行恰好结束在下一块的行首，不一致时其余部分按行重新切块
+// 编码自动识别 UTF-8（含 BOM）与 GBK（按 GB18030 解码，需要 Qt 的 ICU 支持），字符串列统一输出 UTF-8
+class CsvImporter
+{
+public:
+    enum Encoding {
+        AutoDetect,
+        Utf8,
+        Gbk
+    };
+
+    struct Options {
+        Encoding encoding = AutoDetect;
+        char delimiter = 0;                      // 0 表示自动检测（逗号 / 制表符 / 竖线 / 分号）
+        bool hasHeader = true;
+        int threads = 0;                         // 0 表示 QThread::idealThreadCount()
+        qint64 chunkBytes = 8 * 1024 * 1024;     // 每个解析任务（产出一个批次）覆盖的字节数
+        int sampleRows = 1000;                   // 推断列类型的样本行数
+        QHash<QString, ImportColumn::Type> columnTypes;  // 按列名指定类型，覆盖推断结果
+    };
+
+    struct Stats {
+        qint64 rows = 0;
+        qint64 bytes = 0;
+        qint64 elapsedMs = 0;
+        qint64 typeWidenings = 0;                // 值不符合列类型、整列放宽类型的次数（按批次计）
+        qint64 raggedRows = 0;                   // 字段数与表头不一致的行
+        Encoding encoding = AutoDetect;
+        char delimiter = ',';
+        int threads = 0;
+    };
+
+    explicit CsvImporter(const Options& options = Options());
+    ~CsvImporter();
+
+    // 阻塞直到导入完成、失败或被取消；批次在调用线程中按文件顺序交付，失败时见 errorString()
+    bool import(const QString& path, const ImportBatchHandler& onBatch);
+    // 任意线程调用，当前批次解析完后停止
+    void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+    QString errorString() const { return m_error; }
+    const Stats& stats() const { return m_stats; }
+
+    // 第一个批次之前确定；列类型在导入中被放宽时随之更新，各批次以其中列的 type 为准
+    QStringList columnNames() const { return m_columnNames; }
+    QVector<ImportColumn::Type> columnTypes() const { return m_columnTypes; }
+
+    static QString encodingName(Encoding encoding);
+
+private:
+    struct Field {
+        qint64 begin = 0;
+        qint64 end = 0;
+        bool quoted = false;
+        bool escaped = false;                    // 引号内含 "" 转义，取值时需要复制
+    };
+    struct Chunk;
+
+    bool detectFormat(const char* data, qint64 size, qint64* dataStart);
+    void inferColumnTypes(const char* data, qint64 size, qint64 start);
+    void locateChunks(const char* data, qint64 size, qint64 dataStart, QVector<Chunk>& chunks);
+    // 从行首 start 起逐行扫描到文件末尾，按完整行切块（边界精确，但只能串行）
+    void splitRows(const char* data, qint64 size, qint64 start, QVector<Chunk>& chunks) const;
+    void parseChunk(const char* data, qint64 size, Chunk& chunk) const;
+
+    qint64 tokenizeRow(CsvScanner& scanner, const char* data, qint64 size, qint64 pos,
+                       QVector<Field>& fields) const;
+    QByteArrayView fieldValue(const char* data, const Field& field, QByteArray& scratch) const;
+    bool multibyteSafe() const;
+
+private:
+    Options m_options;
+    QThreadPool m_pool;
+    std::atomic<bool> m_cancelled;
+    QString m_error;
+    Stats m_stats;
+    Encoding m_encoding;
+    char m_delimiter;
+    QStringList m_columnNames;
+    QVector<ImportColumn::Type> m_columnTypes;
+    qint64 m_averageRowBytes;
+
+    Q_DISABLE_COPY(CsvImporter)
+};
+
+#endif // CSVIMPORTER_H
@@ -0,0 +1,401 @@
+#ifndef CSVSCANNER_H
+#define CSVSCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <locale>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSV_SCANNER_SSE2 1
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+// CSV 结构字符扫描与字段值解析（不依赖 Qt，供 CsvImporter 的各解析线程使用）
+// 扫描按 64 字节块用 SIMD 一次比较出所有分隔符 / 引号 / 换行的位置（位掩码），
+// 逐位取出结构字符，字段内容本身不再逐字节判断
+class CsvScanner
+{
+public:
+    // multibyteSafe 为 false 时（GBK 且分隔符 >= 0x40，例如 '|'）双字节字符的尾字节可能与分隔符相同，
+    // 改为逐字节扫描并跳过双字节字符
+    CsvScanner(const char* data, size_t size, char delimiter, bool multibyteSafe = true)
+        : m_data(data)
+        , m_size(size)
+        , m_delimiter(delimiter)
+        , m_multibyteSafe(multibyteSafe)
+    {
+    }
+
+    // pos 起下一个分隔符 / 引号 / 换行的位置，没有时返回 size()；pos 必须位于字符边界
+    size_t next(size_t pos)
+    {
+        if (!m_multibyteSafe) {
+            return nextMultibyte(pos);
+        }
+        while (pos < m_size) {
+            const size_t block = pos & ~size_t(63);
+            if (block != m_blockStart) {
+                m_blockStart = block;
+                m_blockMask = blockMask(block);
+            }
+            const uint64_t mask = m_blockMask & (~uint64_t(0) << (pos - block));
+            if (mask) {
+                return block + countTrailingZeros(mask);
+            }
+            pos = block + 64;
+        }
+        return m_size;
+    }
+
+    size_t size() const { return m_size; }
+
+    static size_t countQuotes(const char* data, size_t size)
+    {
+        size_t count = 0;
+        size_t i = 0;
+#ifdef CSV_SCANNER_SSE2
+        const __m128i quote = _mm_set1_epi8('"');
+        for (; i + 16 <= size; i += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            count += popcount(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote))));
+        }
+#endif
+        for (; i < size; ++i) {
+            count += data[i] == '"';
+        }
+        return count;
+    }
+
+    static bool isAscii(const char* data, size_t size)
+    {
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            if (word & 0x8080808080808080ULL) {
+                return false;
+            }
+        }
+        for (; i < size; ++i) {
+            if (static_cast<unsigned char>(data[i]) & 0x80) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 严格的 UTF-8 校验（拒绝过长编码与代理区）；allowTruncatedTail 时末尾被截断的字符视为合法（用于采样）
+    static bool isValidUtf8(const char* data, size_t size, bool allowTruncatedTail = false)
+    {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        size_t i = 0;
+        while (i < size) {
+            if (i + 8 <= size && isAscii(data + i, 8)) {
+                i += 8;
+                continue;
+            }
+            const unsigned char c = p[i];
+            if (c < 0x80) {
+                ++i;
+                continue;
+            }
+            size_t length;
+            unsigned char low = 0x80, high = 0xBF;
+            if (c >= 0xC2 && c <= 0xDF) {
+                length = 2;
+            } else if (c >= 0xE0 && c <= 0xEF) {
+                length = 3;
+                if (c == 0xE0) low = 0xA0;
+                if (c == 0xED) high = 0x9F;
+            } else if (c >= 0xF0 && c <= 0xF4) {
+                length = 4;
+                if (c == 0xF0) low = 0x90;
+                if (c == 0xF4) high = 0x8F;
+            } else {
+                return false;
+            }
+            if (i + length > size) {
+                return allowTruncatedTail;
+            }
+            if (p[i + 1] < low || p[i + 1] > high) {
+                return false;
+            }
+            for (size_t k = 2; k < length; ++k) {
+                if ((p[i + k] & 0xC0) != 0x80) {
+                    return false;
+                }
+            }
+            i += length;
+        }
+        return true;
+    }
+
+    // 整数：可带正负号与千位分隔符 ','，最多 18 位数字
+    static bool parseInt64(const char* p, size_t n, int64_t* out)
+    {
+        size_t i = 0;
+        bool negative = false;
+        if (i < n && (p[i] == '-' || p[i] == '+')) {
+            negative = p[i] == '-';
+            ++i;
+        }
+        int64_t value = 0;
+        int digits = 0;
+        for (; i < n; ++i) {
+            const char c = p[i];
+            if (c >= '0' && c <= '9') {
+                if (++digits > 18) {
+                    return false;
+                }
+                value = value * 10 + (c - '0');
+            } else if (c != ',' || digits == 0) {
+                return false;
+            }
+        }
+        if (digits == 0) {
+            return false;
+        }
+        *out = negative ? -value : value;
+        return true;
+    }
+
+    // 小数：可带正负号与千位分隔符；有效数字不超过 15 位时用精确的 10 的幂直接计算（结果正确舍入），
+    // 其余情况（指数、长小数）交给标准库
+    static bool parseDouble(const char* p, size_t n, double* out)
+    {
+        static const double kPow10[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        size_t i = 0;
+        bool negative = false;
+        if (i < n && (p[i] == '-' || p[i] == '+')) {
+            negative = p[i] == '-';
+            ++i;
+        }
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int significant = 0;
+        int fraction = 0;
+        bool dot = false;
+        for (; i < n; ++i) {
+            const char c = p[i];
+            if (c >= '0' && c <= '9') {
+                ++digits;
+                if (mantissa != 0 || c != '0') {
+                    ++significant;
+                }
+                if (significant > 15) {
+                    return parseDoubleSlow(p, n, out);
+                }
+                mantissa = mantissa * 10 + uint64_t(c - '0');
+                fraction += dot;
+            } else if (c == '.' && !dot) {
+                dot = true;
+            } else if (c == ',' && !dot && digits > 0) {
+                continue;
+            } else if (c == 'e' || c == 'E') {
+                return parseDoubleSlow(p, n, out);
+            } else {
+                return false;
+            }
+        }
+        if (digits == 0) {
+            return false;
+        }
+        if (fraction > 22) {
+            return parseDoubleSlow(p, n, out);
+        }
+        const double value = double(mantissa) / kPow10[fraction];
+        *out = negative ? -value : value;
+        return true;
+    }
+
+    // 日期时间：yyyy-MM-dd / yyyy/MM/dd，可带 [ T]hh:mm[:ss[.zzz]]；
+    // 结果为按 UTC 解释的秒数（不做时区换算），小数秒舍去
+    static bool parseTimestamp(const char* p, size_t n, int64_t* out)
+    {
+        size_t i = 0;
+        int year, month, day;
+        if (!readNumber(p, n, &i, 4, 4, &year) || i >= n || (p[i] != '-' && p[i] != '/')) {
+            return false;
+        }
+        const char separator = p[i++];
+        if (!readNumber(p, n, &i, 1, 2, &month) || i >= n || p[i++] != separator
+            || !readNumber(p, n, &i, 1, 2, &day)) {
+            return false;
+        }
+        int hour = 0, minute = 0, second = 0;
+        if (i < n) {
+            if (p[i] != ' ' && p[i] != 'T') {
+                return false;
+            }
+            ++i;
+            if (!readNumber(p, n, &i, 1, 2, &hour) || i >= n || p[i++] != ':'
+                || !readNumber(p, n, &i, 2, 2, &minute)) {
+                return false;
+            }
+            if (i < n && p[i] == ':') {
+                ++i;
+                if (!readNumber(p, n, &i, 2, 2, &second)) {
+                    return false;
+                }
+                if (i < n && p[i] == '.') {
+                    ++i;
+                    while (i < n && p[i] >= '0' && p[i] <= '9') {
+                        ++i;
+                    }
+                }
+            }
+            if (i != n) {
+                return false;
+            }
+        }
+        if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)
+            || hour > 23 || minute > 59 || second > 60) {
+            return false;
+        }
+        *out = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+        return true;
+    }
+
+private:
+    uint64_t blockMask(size_t block) const
+    {
+        const char* p = m_data + block;
+        uint64_t mask = 0;
+#ifdef CSV_SCANNER_SSE2
+        if (block + 64 <= m_size) {
+            const __m128i delimiter = _mm_set1_epi8(m_delimiter);
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i newline = _mm_set1_epi8('\n');
+            for (int k = 0; k < 4; ++k) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + k * 16));
+                const __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, delimiter), _mm_cmpeq_epi8(v, quote)),
+                                                 _mm_cmpeq_epi8(v, newline));
+                mask |= uint64_t(uint32_t(_mm_movemask_epi8(hit))) << (k * 16);
+            }
+            return mask;
+        }
+#endif
+        // 末尾不足 64 字节（或无 SSE2）时逐字节计算，不越过映射区末尾读取
+        const size_t length = m_size - block < 64 ? m_size - block : 64;
+        for (size_t k = 0; k < length; ++k) {
+            const char c = p[k];
+            if (c == m_delimiter || c == '"' || c == '\n') {
+                mask |= uint64_t(1) << k;
+            }
+        }
+        return mask;
+    }
+
+    size_t nextMultibyte(size_t pos) const
+    {
+        while (pos < m_size) {
+            const unsigned char c = static_cast<unsigned char>(m_data[pos]);
+            if (c >= 0x81) {
+                pos += 2;
+                continue;
+            }
+            if (c == static_cast<unsigned char>(m_delimiter) || c == '"' || c == '\n') {
+                return pos;
+            }
+            ++pos;
+        }
+        return m_size;
+    }
+
+    static bool parseDoubleSlow(const char* p, size_t n, double* out)
+    {
+        // 去掉千位分隔符；标准库解析与区域设置无关
+        char buffer[64];
+        size_t length = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (p[i] == ',') {
+                continue;
+            }
+            if (length == sizeof(buffer) - 1) {
+                return false;
+            }
+            buffer[length++] = p[i];
+        }
+        buffer[length] = '\0';
+        const char* begin = buffer[0] == '+' ? buffer + 1 : buffer;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        const auto result = std::from_chars(begin, buffer + length, *out);
+        return result.ec == std::errc() && result.ptr == buffer + length;
+#else
+        std::istringstream stream(begin);
+        stream.imbue(std::locale::classic());
+        stream >> *out;
+        return !stream.fail() && stream.peek() == std::char_traits<char>::eof();
+#endif
+    }
+
+    static bool readNumber(const char* p, size_t n, size_t* i, int minDigits, int maxDigits, int* out)
+    {
+        int value = 0;
+        int digits = 0;
+        while (*i < n && digits < maxDigits && p[*i] >= '0' && p[*i] <= '9') {
+            value = value * 10 + (p[*i] - '0');
+            ++*i;
+            ++digits;
+        }
+        *out = value;
+        return digits >= minDigits;
+    }
+
+    static int daysInMonth(int year, int month)
+    {
+        static const int kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        return month == 2 && leap ? 29 : kDays[month - 1];
+    }
+
+    // 公历日期到 1970-01-01 的天数（Howard Hinnant 的 days_from_civil）
+    static int64_t daysFromCivil(int year, int month, int day)
+    {
+        year -= month <= 2;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const int64_t yoe = year - era * 400;
+        const int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    static int countTrailingZeros(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return int(index);
+#else
+        return __builtin_ctzll(value);
+#endif
+    }
+
+    static size_t popcount(uint32_t value)
+    {
+        value = value - ((value >> 1) & 0x55555555u);
+        value = (value & 0x33333333u) + ((value >> 2) & 0x33333333u);
+        return size_t((((value + (value >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+    }
+
+private:
+    const char* m_data;
+    size_t m_size;
+    char m_delimiter;
+    bool m_multibyteSafe;
+    size_t m_blockStart = size_t(-1);
+    uint64_t m_blockMask = 0;
+};
+
+#endif // CSVSCANNER_H
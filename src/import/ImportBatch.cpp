@@ -0,0 +1,327 @@
+#include "import/ImportBatch.h"
+#include "import/CsvScanner.h"
+#include <QDateTime>
+#include <QTimeZone>
+#include <cmath>
+
+namespace {
+
+// 整值小数（例如整数列中的 100.00）可以无损转为整数的范围
+constexpr double kMaxExactInteger = 9e15;
+
+bool looksLikeIdentifier(QByteArrayView value)
+{
+    if (value.size() < 2) {
+        return false;
+    }
+    for (char c : value) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+    }
+    return value[0] == '0' || value.size() > 15;
+}
+
+bool isExactInteger(double value)
+{
+    return value == std::trunc(value) && std::fabs(value) < kMaxExactInteger;
+}
+
+QByteArray numberText(double value)
+{
+    return isExactInteger(value) ? QByteArray::number(qint64(value)) : QByteArray::number(value, 'g', 15);
+}
+
+QByteArray timestampText(qint64 secs)
+{
+    return QDateTime::fromSecsSinceEpoch(secs, QTimeZone::UTC).toString("yyyy-MM-dd hh:mm:ss").toLatin1();
+}
+
+} // namespace
+
+// ==================== ImportColumn ====================
+
+void ImportColumn::reset(Type columnType, qint64 reserveRows)
+{
+    type = columnType;
+    ints.clear();
+    doubles.clear();
+    strings.clear();
+    offsets.clear();
+    valid.clear();
+
+    valid.reserve(reserveRows);
+    if (type == Float64) {
+        doubles.reserve(reserveRows);
+    } else if (type == String) {
+        offsets.reserve(reserveRows + 1);
+        offsets.append(0);
+    } else {
+        ints.reserve(reserveRows);
+    }
+}
+
+bool ImportColumn::appendText(QByteArrayView text)
+{
+    const char* p = text.data();
+    const size_t n = size_t(text.size());
+    if (n == 0) {
+        appendNull();
+        return true;
+    }
+
+    switch (type) {
+        case Int64: {
+            int64_t v = 0;
+            if (!CsvScanner::parseInt64(p, n, &v)) {
+                double d = 0;
+                if (!CsvScanner::parseDouble(p, n, &d)) {
+                    widen(String);
+                } else if (!isExactInteger(d)) {
+                    // 超出双精度整数精度的整值按字符串保存，不丢失精度
+                    widen(d == std::trunc(d) ? String : Float64);
+                } else {
+                    v = int64_t(d);
+                }
+                if (type != Int64) {
+                    appendText(text);
+                    return false;
+                }
+            }
+            ints.append(v);
+            break;
+        }
+        case Float64: {
+            double v = 0;
+            if (!CsvScanner::parseDouble(p, n, &v)) {
+                widen(String);
+                appendText(text);
+                return false;
+            }
+            doubles.append(v);
+            break;
+        }
+        case Timestamp: {
+            int64_t v = 0;
+            if (!CsvScanner::parseTimestamp(p, n, &v)) {
+                widen(String);
+                appendText(text);
+                return false;
+            }
+            ints.append(v);
+            break;
+        }
+        case String:
+            strings.append(p, qsizetype(n));
+            offsets.append(strings.size());
+            break;
+    }
+
+    valid.append(1);
+    return true;
+}
+
+bool ImportColumn::appendNumber(double value)
+{
+    switch (type) {
+        case Int64:
+            if (!isExactInteger(value)) {
+                widen(value == std::trunc(value) ? String : Float64);
+                appendNumber(value);
+                return false;
+            }
+            ints.append(qint64(value));
+            break;
+        case Float64:
+            doubles.append(value);
+            break;
+        case Timestamp:
+            widen(String);
+            appendNumber(value);
+            return false;
+        case String:
+            strings.append(numberText(value));
+            offsets.append(strings.size());
+            break;
+    }
+    valid.append(1);
+    return true;
+}
+
+bool ImportColumn::appendTimestamp(qint64 secs)
+{
+    switch (type) {
+        case Timestamp:
+            ints.append(secs);
+            break;
+        case String:
+            strings.append(timestampText(secs));
+            offsets.append(strings.size());
+            break;
+        case Int64:
+        case Float64:
+            widen(String);
+            appendTimestamp(secs);
+            return false;
+    }
+    valid.append(1);
+    return true;
+}
+
+void ImportColumn::appendNull()
+{
+    switch (type) {
+        case Int64:
+        case Timestamp:
+            ints.append(0);
+            break;
+        case Float64:
+            doubles.append(0);
+            break;
+        case String:
+            offsets.append(strings.size());
+            break;
+    }
+    valid.append(0);
+}
+
+void ImportColumn::widen(Type target)
+{
+    target = widerType(type, target);
+    if (target == type) {
+        return;
+    }
+    const qint64 rows = size();
+
+    if (target == Float64) {
+        // 只有整数列会放宽为小数；超出双精度整数精度的值无法无损转换，改为字符串
+        bool exact = true;
+        for (qint64 v : ints) {
+            exact = exact && std::fabs(double(v)) < kMaxExactInteger;
+        }
+        if (exact) {
+            doubles.reserve(valid.capacity());
+            for (qint64 v : ints) {
+                doubles.append(double(v));
+            }
+            ints = QVector<qint64>();
+            type = Float64;
+            return;
+        }
+        target = String;
+    }
+
+    strings.clear();
+    offsets.clear();
+    offsets.reserve(valid.capacity() + 1);
+    offsets.append(0);
+    for (qint64 row = 0; row < rows; ++row) {
+        if (valid[row]) {
+            switch (type) {
+                case Int64: strings.append(QByteArray::number(ints[row])); break;
+                case Float64: strings.append(numberText(doubles[row])); break;
+                case Timestamp: strings.append(timestampText(ints[row])); break;
+                case String: break;
+            }
+        }
+        offsets.append(strings.size());
+    }
+    ints = QVector<qint64>();
+    doubles = QVector<double>();
+    type = String;
+}
+
+ImportColumn::Type ImportColumn::widerType(Type a, Type b)
+{
+    if (a == b) {
+        return a;
+    }
+    if ((a == Int64 && b == Float64) || (a == Float64 && b == Int64)) {
+        return Float64;
+    }
+    return String;
+}
+
+QString ImportColumn::typeName(Type type)
+{
+    switch (type) {
+        case Int64: return "int64";
+        case Float64: return "float64";
+        case Timestamp: return "timestamp";
+        case String: return "string";
+    }
+    return QString();
+}
+
+// ==================== ImportTypeInference ====================
+
+ImportTypeInference::ImportTypeInference(qsizetype columns)
+    : m_columns(columns)
+{
+}
+
+void ImportTypeInference::observeText(qsizetype column, QByteArrayView value, bool forcedText)
+{
+    if (column >= m_columns.size() || value.isEmpty()) {
+        return;
+    }
+    Candidate& candidate = m_columns[column];
+    ++candidate.nonEmpty;
+    if (forcedText || looksLikeIdentifier(value)) {
+        candidate.canInt = candidate.canDouble = candidate.canTime = false;
+        return;
+    }
+
+    const char* p = value.data();
+    const size_t n = size_t(value.size());
+    int64_t integer;
+    double number;
+    if (candidate.canInt && !CsvScanner::parseInt64(p, n, &integer)) {
+        candidate.canInt = false;
+    }
+    if (candidate.canDouble && !CsvScanner::parseDouble(p, n, &number)) {
+        candidate.canDouble = false;
+    }
+    if (candidate.canTime && !CsvScanner::parseTimestamp(p, n, &integer)) {
+        candidate.canTime = false;
+    }
+}
+
+void ImportTypeInference::observeNumber(qsizetype column, double value)
+{
+    if (column >= m_columns.size()) {
+        return;
+    }
+    Candidate& candidate = m_columns[column];
+    ++candidate.nonEmpty;
+    candidate.canTime = false;
+    if (!isExactInteger(value)) {
+        // 超出双精度整数精度的整数（以数值存储的卡号等）按字符串处理
+        candidate.canInt = false;
+        if (value == std::trunc(value)) {
+            candidate.canDouble = false;
+        }
+    }
+}
+
+void ImportTypeInference::observeTimestamp(qsizetype column)
+{
+    if (column >= m_columns.size()) {
+        return;
+    }
+    Candidate& candidate = m_columns[column];
+    ++candidate.nonEmpty;
+    candidate.canInt = candidate.canDouble = false;
+}
+
+ImportColumn::Type ImportTypeInference::type(qsizetype column) const
+{
+    const Candidate& candidate = m_columns.at(column);
+    if (candidate.nonEmpty == 0) {
+        return ImportColumn::String;
+    }
+    return candidate.canInt ? ImportColumn::Int64
+         : candidate.canDouble ? ImportColumn::Float64
+         : candidate.canTime ? ImportColumn::Timestamp
+         : ImportColumn::String;
+}
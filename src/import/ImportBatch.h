@@ -0,0 +1,92 @@
+#ifndef IMPORTBATCH_H
+#define IMPORTBATCH_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+// 导入流水的一列（CSV / XLSX 共用）：按类型只使用对应的数组，空值在 valid 中为 0
+// 值不符合列类型时整列放宽（整数 → 小数 → 字符串，时间 → 字符串）并重新编码已有的值，不会丢弃任何非空值；
+// 因此同一列在不同批次中的类型可能不同，以各批次的 type 为准
+struct ImportColumn {
+    enum Type {
+        Int64,
+        Float64,
+        Timestamp,       // 按 UTC 解释的秒数（不做时区换算）
+        String
+    };
+
+    Type type = String;
+    QVector<qint64> ints;                    // Int64 / Timestamp
+    QVector<double> doubles;                 // Float64
+    QByteArray strings;                      // String：各行 UTF-8 数据首尾相接
+    QVector<qint64> offsets;                 // String：rows + 1 个偏移
+    QVector<quint8> valid;
+
+    // 清空并按类型预留空间
+    void reset(Type columnType, qint64 reserveRows);
+
+    // 按列类型解析文本（UTF-8），空文本记为空值；不符合类型时先放宽列类型再写入，返回 false
+    bool appendText(QByteArrayView text);
+    // 数值单元格（XLSX）：整数列遇到非整值放宽为小数，字符串列写入数值文本；放宽时返回 false
+    bool appendNumber(double value);
+    // 日期单元格（XLSX）：字符串列写入 yyyy-MM-dd hh:mm:ss，数值列放宽为字符串并返回 false
+    bool appendTimestamp(qint64 secs);
+    void appendNull();
+
+    // 把已有的值重新编码为更宽的类型（小数或字符串）；字符串为数值 / 时间的规范文本
+    void widen(Type target);
+
+    qint64 size() const { return valid.size(); }
+    QByteArrayView stringAt(qint64 row) const
+    {
+        return QByteArrayView(strings.constData() + offsets[row], offsets[row + 1] - offsets[row]);
+    }
+
+    static QString typeName(Type type);
+    // 能同时容纳两种类型的值的最窄类型
+    static Type widerType(Type a, Type b);
+};
+
+// 一批连续的行
+struct ImportBatch {
+    QString source;                          // 来源（文件名，XLSX 为工作表名）
+    QStringList columnNames;
+    qint64 firstRow = 0;                     // 第一行在来源中的行号（不含表头，从 0 开始）
+    qint64 rowCount = 0;
+    qint64 sourceEnd = 0;                    // 已读取的字节数（进度；XLSX 为所有工作表累计的压缩字节数）
+    QVector<ImportColumn> columns;           // 顺序与 columnNames 一致
+};
+
+// 在调用导入的线程中按来源内的行顺序调用；返回 false 时停止导入
+using ImportBatchHandler = std::function<bool(const ImportBatch&)>;
+
+// 由样本推断列类型：样本中所有非空值都能按某类型解析时取该类型（整数 > 小数 > 时间），否则为字符串
+// 纯数字且有前导 0 或超过 15 位的值（账号、卡号、流水号）按字符串处理，不丢失前导 0 与精度
+class ImportTypeInference
+{
+public:
+    explicit ImportTypeInference(qsizetype columns);
+
+    // forcedText：来源明确标为文本（例如 CSV 中 Excel 的 ="..." 写法）
+    void observeText(qsizetype column, QByteArrayView value, bool forcedText = false);
+    void observeNumber(qsizetype column, double value);
+    void observeTimestamp(qsizetype column);
+
+    ImportColumn::Type type(qsizetype column) const;
+
+private:
+    struct Candidate {
+        bool canInt = true;
+        bool canDouble = true;
+        bool canTime = true;
+        int nonEmpty = 0;
+    };
+
+    QVector<Candidate> m_columns;
+};
+
+#endif // IMPORTBATCH_H
@@ -0,0 +1,851 @@
+#include "import/XlsxReader.h"
+#include "import/ZipArchive.h"
+#include "core/Logger.h"
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QMutexLocker>
+#include <QThread>
+#include <QTimeZone>
+#include <QWaitCondition>
+#include <QXmlStreamReader>
+#include <QtConcurrent>
+
+namespace {
+
+// 每次解压交给 XML 解析器的数据量
+constexpr qint64 kXmlChunkBytes = 256 * 1024;
+// 解析线程每隔多少行检查一次取消
+constexpr qint64 kCancelCheckRows = 1024;
+// Excel 序列日期 0 点对应的 Unix 天数偏移（1900 / 1904 日期系统）
+constexpr double kEpochOffset1900 = 25569;
+constexpr double kEpochOffset1904 = 24107;
+
+const QLatin1String kTagCell("c");
+const QLatin1String kTagValue("v");
+const QLatin1String kTagInline("is");
+const QLatin1String kTagText("t");
+const QLatin1String kTagPhonetic("rPh");
+const QLatin1String kTagRow("row");
+const QLatin1String kTagSheetData("sheetData");
+const QLatin1String kTagSharedItem("si");
+
+// 单元格的 t 属性
+enum class CellType {
+    Number,          // n 或缺省
+    Shared,          // s：共享字符串下标
+    Inline,          // inlineStr
+    FormulaString,   // str
+    Boolean,         // b
+    IsoDate,         // d：ISO 8601 文本
+    Error            // e：#N/A 等，按空值处理
+};
+
+// 解析后的非空单元格
+struct Cell {
+    enum Kind { Text, Number, Date, Bool };
+
+    int column = 0;
+    Kind kind = Text;
+    double number = 0;
+    qint64 secs = 0;
+    QByteArray text;             // UTF-8；共享字符串直接引用共享字符串表
+};
+
+CellType cellType(QStringView t)
+{
+    if (t.isEmpty() || t == QLatin1String("n")) return CellType::Number;
+    if (t == QLatin1String("s")) return CellType::Shared;
+    if (t == QLatin1String("inlineStr")) return CellType::Inline;
+    if (t == QLatin1String("str")) return CellType::FormulaString;
+    if (t == QLatin1String("b")) return CellType::Boolean;
+    if (t == QLatin1String("d")) return CellType::IsoDate;
+    return CellType::Error;
+}
+
+// "AB12" -> 27（从 0 开始）；没有列字母时返回 -1
+int columnFromReference(QStringView reference)
+{
+    int column = 0;
+    qsizetype i = 0;
+    for (; i < reference.size(); ++i) {
+        const char16_t c = reference[i].unicode();
+        if (c >= 'A' && c <= 'Z') {
+            column = column * 26 + (c - 'A' + 1);
+        } else if (c >= 'a' && c <= 'z') {
+            column = column * 26 + (c - 'a' + 1);
+        } else {
+            break;
+        }
+    }
+    return i > 0 ? column - 1 : -1;
+}
+
+// 内置日期格式：14-22、45-47，以及中文环境下的 27-36、50-58
+bool isBuiltinDateFormat(int id)
+{
+    return (id >= 14 && id <= 22) || (id >= 27 && id <= 36) || (id >= 45 && id <= 47) || (id >= 50 && id <= 58);
+}
+
+// 自定义格式去掉引号内的文字、[...]（颜色、条件、区域）和转义字符后含 y / d / h 即为日期时间
+bool isDateFormatCode(QStringView code)
+{
+    bool quoted = false;
+    bool bracket = false;
+    for (qsizetype i = 0; i < code.size(); ++i) {
+        const QChar c = code[i];
+        if (quoted) {
+            quoted = c != u'"';
+        } else if (bracket) {
+            bracket = c != u']';
+        } else if (c == u'"') {
+            quoted = true;
+        } else if (c == u'[') {
+            bracket = true;
+        } else if (c == u'\\' || c == u'_' || c == u'*') {
+            ++i;
+        } else {
+            const char16_t lower = c.toLower().unicode();
+            if (lower == 'y' || lower == 'd' || lower == 'h') {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Excel 把控制字符写成 _xHHHH_（例如换行中的 _x000D_）
+void decodeEscapes(QString& text)
+{
+    if (!text.contains(QLatin1String("_x"))) {
+        return;
+    }
+    QString decoded;
+    decoded.reserve(text.size());
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        if (text[i] == u'_' && i + 6 < text.size() && text[i + 1] == u'x' && text[i + 6] == u'_') {
+            bool ok = false;
+            const ushort code = QStringView(text).mid(i + 2, 4).toUShort(&ok, 16);
+            if (ok) {
+                decoded += QChar(code);
+                i += 6;
+                continue;
+            }
+        }
+        decoded += text[i];
+    }
+    text = decoded;
+}
+
+// 从 ZIP 条目增量读取 XML：解析器数据不足时再解压下一段
+class XmlEntryStream
+{
+public:
+    XmlEntryStream(const ZipArchive& archive, const ZipArchive::Entry& entry)
+        : m_reader(archive, entry)
+    {
+    }
+
+    QXmlStreamReader& xml() { return m_xml; }
+
+    // 结束时返回 EndDocument，出错时返回 Invalid（见 errorString()）
+    QXmlStreamReader::TokenType next()
+    {
+        for (;;) {
+            const QXmlStreamReader::TokenType token = m_xml.readNext();
+            if (token != QXmlStreamReader::Invalid
+                || m_xml.error() != QXmlStreamReader::PrematureEndOfDocumentError
+                || !m_reader.isValid() || m_reader.atEnd()) {
+                return token;
+            }
+            const QByteArray chunk = m_reader.read(kXmlChunkBytes);
+            if (!m_reader.isValid()) {
+                return QXmlStreamReader::Invalid;
+            }
+            m_xml.addData(chunk);
+        }
+    }
+
+    QString errorString() const { return m_reader.isValid() ? m_xml.errorString() : m_reader.errorString(); }
+    qint64 compressedRead() const { return m_reader.compressedRead(); }
+
+private:
+    ZipEntryReader m_reader;
+    QXmlStreamReader m_xml;
+};
+
+} // namespace
+
+struct XlsxReader::SheetTask {
+    Sheet sheet;
+    const ZipArchive::Entry* entry = nullptr;
+};
+
+// 共享字符串表：所有字符串首尾相接保存为一个 UTF-8 数组，单元格以 fromRawData 引用，不逐个分配
+struct XlsxReader::SharedStrings {
+    explicit SharedStrings(const ZipArchive::Entry* sharedStringsEntry)
+        : entry(sharedStringsEntry)
+    {
+    }
+
+    // 任意解析线程在遇到第一个字符串单元格时调用，只有第一个调用者真正加载
+    bool ensureLoaded(const ZipArchive& archive)
+    {
+        if (loaded.load(std::memory_order_acquire)) {
+            return ok;
+        }
+        QMutexLocker locker(&mutex);
+        if (!loaded.load(std::memory_order_relaxed)) {
+            ok = load(archive);
+            loaded.store(true, std::memory_order_release);
+        }
+        return ok;
+    }
+
+    qsizetype count() const { return offsets.size() - 1; }
+    QByteArray at(qsizetype index) const
+    {
+        return QByteArray::fromRawData(arena.constData() + offsets[index], qsizetype(offsets[index + 1] - offsets[index]));
+    }
+
+    const ZipArchive::Entry* entry;
+    QMutex mutex;
+    std::atomic<bool> loaded{false};
+    bool ok = false;
+    QString error;
+    QByteArray arena;
+    QVector<qint64> offsets;
+
+private:
+    bool load(const ZipArchive& archive)
+    {
+        offsets.append(0);
+        if (!entry) {
+            return true;  // 工作簿没有共享字符串
+        }
+
+        XmlEntryStream stream(archive, *entry);
+        QXmlStreamReader& xml = stream.xml();
+        QString text;
+        bool inText = false;
+        int phonetic = 0;
+        for (;;) {
+            switch (stream.next()) {
+                case QXmlStreamReader::StartElement:
+                    if (xml.name() == kTagSharedItem) {
+                        text.clear();
+                    } else if (xml.name() == kTagText) {
+                        inText = phonetic == 0;  // 跳过注音（rPh）中的文字
+                    } else if (xml.name() == kTagPhonetic) {
+                        ++phonetic;
+                    } else if (xml.name() == QLatin1String("sst")) {
+                        const qsizetype unique = xml.attributes().value("uniqueCount").toLongLong();
+                        offsets.reserve(qBound<qsizetype>(0, unique, 16 * 1024 * 1024) + 1);
+                    }
+                    break;
+                case QXmlStreamReader::Characters:
+                    if (inText) {
+                        text.append(xml.text());
+                    }
+                    break;
+                case QXmlStreamReader::EndElement:
+                    if (xml.name() == kTagText) {
+                        inText = false;
+                    } else if (xml.name() == kTagPhonetic) {
+                        --phonetic;
+                    } else if (xml.name() == kTagSharedItem) {
+                        decodeEscapes(text);
+                        arena.append(text.toUtf8());
+                        offsets.append(arena.size());
+                    }
+                    break;
+                case QXmlStreamReader::EndDocument:
+                    arena.squeeze();
+                    return true;
+                case QXmlStreamReader::Invalid:
+                    error = "Invalid sharedStrings.xml: " + stream.errorString();
+                    return false;
+                default:
+                    break;
+            }
+        }
+    }
+};
+
+// 解析线程与调用线程之间的有界批次队列，队列满时解析线程等待，内存占用不随工作表大小增长
+struct XlsxReader::BatchQueue {
+    BatchQueue(qsizetype queueCapacity, int producerCount)
+        : capacity(queueCapacity)
+        , producers(producerCount)
+    {
+    }
+
+    void push(ImportBatch&& batch)
+    {
+        QMutexLocker locker(&mutex);
+        while (batches.size() >= capacity) {
+            notFull.wait(&mutex);
+        }
+        batches.append(std::move(batch));
+        notEmpty.wakeOne();
+    }
+
+    void producerDone()
+    {
+        QMutexLocker locker(&mutex);
+        --producers;
+        notEmpty.wakeAll();
+    }
+
+    // 队列为空且所有工作表都已结束时返回 false
+    bool pop(ImportBatch* batch)
+    {
+        QMutexLocker locker(&mutex);
+        while (batches.isEmpty() && producers > 0) {
+            notEmpty.wait(&mutex);
+        }
+        if (batches.isEmpty()) {
+            return false;
+        }
+        *batch = batches.takeFirst();
+        notFull.wakeOne();
+        return true;
+    }
+
+    QMutex mutex;
+    QWaitCondition notEmpty;
+    QWaitCondition notFull;
+    QList<ImportBatch> batches;
+    qsizetype capacity;
+    int producers;
+};
+
+XlsxReader::XlsxReader(const Options& options)
+    : m_options(options)
+    , m_cancelled(false)
+    , m_compressedRead(0)
+    , m_date1904(false)
+    , m_sharedStrings(nullptr)
+    , m_queue(nullptr)
+{
+    m_options.batchRows = qMax(m_options.batchRows, 1024);
+    m_options.sampleRows = qMax(m_options.sampleRows, 1);
+    m_pool.setMaxThreadCount(m_options.threads > 0 ? m_options.threads : QThread::idealThreadCount());
+}
+
+XlsxReader::~XlsxReader()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+bool XlsxReader::import(const QString& path, const ImportBatchHandler& onBatch)
+{
+    m_error.clear();
+    m_stats = Stats();
+    m_sheets.clear();
+    m_cancelled.store(false, std::memory_order_relaxed);
+    m_compressedRead.store(0, std::memory_order_relaxed);
+    m_date1904 = false;
+    m_dateStyles.clear();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    ZipArchive archive;
+    if (!archive.open(path)) {
+        m_error = archive.errorString();
+        return false;
+    }
+
+    QVector<SheetTask> tasks;
+    QString sharedStringsPath;
+    QString stylesPath;
+    if (!readWorkbook(archive, tasks, &sharedStringsPath, &stylesPath) || !readStyles(archive, stylesPath)) {
+        return false;
+    }
+    for (const SheetTask& task : tasks) {
+        m_stats.bytes += task.entry->compressedSize;
+    }
+
+    // 每个工作表一个解析任务；调用线程只负责交付批次
+    SharedStrings sharedStrings(archive.find(sharedStringsPath));
+    BatchQueue queue(qMax(2, m_pool.maxThreadCount() * 2), int(tasks.size()));
+    m_sharedStrings = &sharedStrings;
+    m_queue = &queue;
+
+    QList<QFuture<void>> futures;
+    for (SheetTask& task : tasks) {
+        futures.append(QtConcurrent::run(&m_pool, [this, &archive, &task]() {
+            parseSheet(archive, task);
+            m_queue->producerDone();
+        }));
+    }
+
+    // 取消后继续取出剩余批次（不再交付），使等待队列的解析线程能够退出
+    ImportBatch batch;
+    while (queue.pop(&batch)) {
+        if (!isCancelled() && !onBatch(batch)) {
+            cancel();
+        }
+    }
+    for (QFuture<void>& future : futures) {
+        future.waitForFinished();
+    }
+    m_sharedStrings = nullptr;
+    m_queue = nullptr;
+
+    for (const SheetTask& task : tasks) {
+        m_sheets.append(task.sheet);
+        m_stats.rows += task.sheet.rows;
+        m_stats.typeWidenings += task.sheet.typeWidenings;
+    }
+    m_stats.elapsedMs = timer.elapsed();
+    m_stats.threads = qMin(m_pool.maxThreadCount(), int(tasks.size()));
+
+    if (!m_error.isEmpty()) {
+        return false;
+    }
+    if (isCancelled()) {
+        m_error = "Import cancelled";
+        Logger::instance()->info(QString("XLSX import cancelled after %1 rows: %2").arg(m_stats.rows).arg(path));
+        return false;
+    }
+
+    const double seconds = qMax<qint64>(m_stats.elapsedMs, 1) / 1000.0;
+    Logger::instance()->info(QString("XLSX imported: %1 rows from %2 sheets, %3 MB compressed in %4 ms (%5 rows/s, %6 threads, %7 shared strings, %8 type widenings)")
+        .arg(m_stats.rows)
+        .arg(m_sheets.size())
+        .arg(m_stats.bytes / 1048576.0, 0, 'f', 1)
+        .arg(m_stats.elapsedMs)
+        .arg(m_stats.rows / seconds, 0, 'f', 0)
+        .arg(m_stats.threads)
+        .arg(sharedStrings.loaded ? sharedStrings.count() : 0)
+        .arg(m_stats.typeWidenings));
+    return true;
+}
+
+void XlsxReader::fail(const QString& error)
+{
+    {
+        QMutexLocker locker(&m_errorMutex);
+        if (m_error.isEmpty()) {
+            m_error = error;
+        }
+    }
+    cancel();
+}
+
+bool XlsxReader::readWorkbook(ZipArchive& archive, QVector<SheetTask>& tasks, QString* sharedStringsPath,
+                              QString* stylesPath)
+{
+    *sharedStringsPath = "xl/sharedStrings.xml";
+    *stylesPath = "xl/styles.xml";
+
+    // 1. 工作簿关系：r:id -> 部件路径（相对 xl/，以 / 开头的是包内绝对路径）
+    QHash<QString, QString> targets;
+    QByteArray data;
+    if (const ZipArchive::Entry* rels = archive.find("xl/_rels/workbook.xml.rels")) {
+        if (!archive.read(*rels, &data)) {
+            m_error = archive.errorString();
+            return false;
+        }
+        QXmlStreamReader xml(data);
+        while (!xml.atEnd()) {
+            if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != QLatin1String("Relationship")) {
+                continue;
+            }
+            const QXmlStreamAttributes attributes = xml.attributes();
+            const QString target = attributes.value("Target").toString();
+            const QString resolved = target.startsWith('/') ? target.mid(1) : QDir::cleanPath("xl/" + target);
+            const QStringView type = attributes.value("Type");
+            if (type.endsWith(QLatin1String("/sharedStrings"))) {
+                *sharedStringsPath = resolved;
+            } else if (type.endsWith(QLatin1String("/styles"))) {
+                *stylesPath = resolved;
+            }
+            targets.insert(attributes.value("Id").toString(), resolved);
+        }
+    }
+
+    // 2. 工作表列表与日期系统
+    const ZipArchive::Entry* workbook = archive.find("xl/workbook.xml");
+    if (!workbook) {
+        m_error = "Not an XLSX workbook: xl/workbook.xml not found";
+        return false;
+    }
+    if (!archive.read(*workbook, &data)) {
+        m_error = archive.errorString();
+        return false;
+    }
+    QXmlStreamReader xml(data);
+    int index = 0;
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == QLatin1String("workbookPr")) {
+            const QStringView date1904 = attributes.value("date1904");
+            m_date1904 = date1904 == QLatin1String("1") || date1904 == QLatin1String("true");
+        } else if (xml.name() == QLatin1String("sheet")) {
+            ++index;
+            const QString name = attributes.value("name").toString();
+            if (!m_options.sheets.isEmpty() && !m_options.sheets.contains(name)) {
+                continue;
+            }
+            // r:id 的前缀因生成工具而异，按命名空间中的 id 属性查找
+            QString relationId;
+            for (const QXmlStreamAttribute& attribute : attributes) {
+                if (attribute.name() == QLatin1String("id") && !attribute.namespaceUri().isEmpty()) {
+                    relationId = attribute.value().toString();
+                }
+            }
+            const QString sheetPath = targets.value(relationId, QString("xl/worksheets/sheet%1.xml").arg(index));
+            SheetTask task;
+            task.sheet.name = name;
+            task.entry = archive.find(sheetPath);
+            if (!task.entry) {
+                m_error = QString("Worksheet %1 not found: %2").arg(name, sheetPath);
+                return false;
+            }
+            tasks.append(task);
+        }
+    }
+    if (xml.hasError()) {
+        m_error = "Invalid workbook.xml: " + xml.errorString();
+        return false;
+    }
+    if (tasks.isEmpty()) {
+        m_error = m_options.sheets.isEmpty() ? QString("Workbook has no worksheets")
+                                             : "Sheets not found: " + m_options.sheets.join(", ");
+        return false;
+    }
+    return true;
+}
+
+bool XlsxReader::readStyles(ZipArchive& archive, const QString& stylesPath)
+{
+    const ZipArchive::Entry* styles = archive.find(stylesPath);
+    if (!styles) {
+        return true;  // 没有样式表时所有数值都按数值处理
+    }
+    QByteArray data;
+    if (!archive.read(*styles, &data)) {
+        m_error = archive.errorString();
+        return false;
+    }
+
+    // 单元格的 s 属性是 cellXfs 中的下标；cellStyleXfs 中的 xf 不直接被单元格引用
+    QHash<int, bool> customFormats;
+    bool inCellXfs = false;
+    QXmlStreamReader xml(data);
+    while (!xml.atEnd()) {
+        const QXmlStreamReader::TokenType token = xml.readNext();
+        if (token == QXmlStreamReader::StartElement) {
+            const QXmlStreamAttributes attributes = xml.attributes();
+            if (xml.name() == QLatin1String("numFmt")) {
+                customFormats.insert(attributes.value("numFmtId").toInt(),
+                                     isDateFormatCode(attributes.value("formatCode")));
+            } else if (xml.name() == QLatin1String("cellXfs")) {
+                inCellXfs = true;
+            } else if (inCellXfs && xml.name() == QLatin1String("xf")) {
+                const int id = attributes.value("numFmtId").toInt();
+                m_dateStyles.append(customFormats.contains(id) ? customFormats.value(id) : isBuiltinDateFormat(id));
+            }
+        } else if (token == QXmlStreamReader::EndElement && xml.name() == QLatin1String("cellXfs")) {
+            inCellXfs = false;
+        }
+    }
+    if (xml.hasError()) {
+        m_error = "Invalid styles.xml: " + xml.errorString();
+        return false;
+    }
+    return true;
+}
+
+void XlsxReader::parseSheet(const ZipArchive& archive, SheetTask& task)
+{
+    Sheet& sheet = task.sheet;
+    XmlEntryStream stream(archive, *task.entry);
+    QXmlStreamReader& xml = stream.xml();
+    const double epochOffset = m_date1904 ? kEpochOffset1904 : kEpochOffset1900;
+
+    QVector<Cell> row;                   // 当前行的非空单元格
+    QVector<QVector<Cell>> sample;       // 类型确定之前缓存的样本行
+    bool headerPending = m_options.hasHeader;
+    bool typesKnown = false;
+    qsizetype columnCount = 0;
+    ImportBatch batch;
+    qint64 rowsSeen = 0;
+    qint64 reportedRead = 0;
+
+    // 当前单元格
+    Cell cell;
+    CellType type = CellType::Number;
+    bool dateStyle = false;
+    bool inValue = false;
+    bool inInline = false;
+    bool inText = false;
+    int phonetic = 0;
+    QString text;
+
+    auto reportProgress = [&]() {
+        const qint64 read = stream.compressedRead();
+        m_compressedRead.fetch_add(read - reportedRead, std::memory_order_relaxed);
+        reportedRead = read;
+    };
+
+    auto startBatch = [&]() {
+        batch = ImportBatch();
+        batch.source = sheet.name;
+        batch.columnNames = sheet.columnNames;
+        batch.firstRow = sheet.rows;
+        batch.columns.resize(columnCount);
+        for (qsizetype c = 0; c < columnCount; ++c) {
+            batch.columns[c].reset(sheet.columnTypes[c], m_options.batchRows);
+        }
+    };
+
+    auto flush = [&]() {
+        if (batch.rowCount == 0) {
+            return;
+        }
+        reportProgress();
+        batch.sourceEnd = m_compressedRead.load(std::memory_order_relaxed);
+        sheet.rows += batch.rowCount;
+        m_queue->push(std::move(batch));
+        startBatch();
+    };
+
+    auto appendRow = [&](const QVector<Cell>& cells) {
+        qsizetype next = 0;
+        for (qsizetype c = 0; c < columnCount; ++c) {
+            ImportColumn& column = batch.columns[c];
+            while (next < cells.size() && cells[next].column < c) {
+                ++next;
+            }
+            if (next == cells.size() || cells[next].column != c) {
+                column.appendNull();
+                continue;
+            }
+            const Cell& value = cells[next];
+            bool ok = true;
+            switch (value.kind) {
+                case Cell::Text: ok = column.appendText(value.text); break;
+                case Cell::Number:
+                case Cell::Bool: ok = column.appendNumber(value.number); break;
+                case Cell::Date: ok = column.appendTimestamp(value.secs); break;
+            }
+            if (!ok) {
+                // 本批次的列已放宽并重新编码，之后的批次直接从放宽后的类型开始
+                sheet.columnTypes[c] = column.type;
+                ++sheet.typeWidenings;
+            }
+        }
+        if (++batch.rowCount >= m_options.batchRows) {
+            flush();
+        }
+    };
+
+    // 由样本推断列类型，之后样本行与后续行都直接写入批次
+    auto resolveTypes = [&]() {
+        if (!m_options.hasHeader) {
+            for (const QVector<Cell>& cells : sample) {
+                columnCount = qMax<qsizetype>(columnCount, cells.last().column + 1);
+            }
+            for (qsizetype c = 0; c < columnCount; ++c) {
+                sheet.columnNames.append(QString("列%1").arg(c + 1));
+            }
+        }
+        ImportTypeInference inference(columnCount);
+        for (const QVector<Cell>& cells : sample) {
+            for (const Cell& value : cells) {
+                switch (value.kind) {
+                    case Cell::Text: inference.observeText(value.column, value.text); break;
+                    case Cell::Number:
+                    case Cell::Bool: inference.observeNumber(value.column, value.number); break;
+                    case Cell::Date: inference.observeTimestamp(value.column); break;
+                }
+            }
+        }
+        sheet.columnTypes.resize(columnCount);
+        for (qsizetype c = 0; c < columnCount; ++c) {
+            sheet.columnTypes[c] = m_options.columnTypes.value(sheet.columnNames[c], inference.type(c));
+        }
+        typesKnown = true;
+        startBatch();
+        for (const QVector<Cell>& cells : sample) {
+            appendRow(cells);
+        }
+        sample.clear();
+        sample.squeeze();
+    };
+
+    auto finishRow = [&]() {
+        if (row.isEmpty()) {
+            return;  // 空行
+        }
+        if (headerPending) {
+            headerPending = false;
+            columnCount = row.last().column + 1;
+            sheet.columnNames.resize(columnCount);
+            for (const Cell& value : row) {
+                QString name;
+                switch (value.kind) {
+                    case Cell::Text: name = QString::fromUtf8(value.text).trimmed(); break;
+                    case Cell::Number: name = QString::number(value.number, 'g', 15); break;
+                    case Cell::Bool: name = value.number != 0 ? "TRUE" : "FALSE"; break;
+                    case Cell::Date:
+                        name = QDateTime::fromSecsSinceEpoch(value.secs, QTimeZone::UTC).toString("yyyy-MM-dd");
+                        break;
+                }
+                sheet.columnNames[value.column] = name;
+            }
+            for (qsizetype c = 0; c < columnCount; ++c) {
+                if (sheet.columnNames[c].isEmpty()) {
+                    sheet.columnNames[c] = QString("列%1").arg(c + 1);
+                }
+            }
+        } else if (!typesKnown) {
+            sample.append(row);
+            if (sample.size() >= m_options.sampleRows) {
+                resolveTypes();
+            }
+        } else {
+            appendRow(row);
+        }
+    };
+
+    auto finishCell = [&]() -> bool {
+        if (text.isEmpty()) {
+            return true;
+        }
+        switch (type) {
+            case CellType::Shared: {
+                bool ok = false;
+                const qsizetype index = QStringView(text).trimmed().toLongLong(&ok);
+                if (!m_sharedStrings->ensureLoaded(archive)) {
+                    fail(m_sharedStrings->error);
+                    return false;
+                }
+                if (!ok || index < 0 || index >= m_sharedStrings->count()) {
+                    return true;  // 无效下标按空值处理
+                }
+                cell.kind = Cell::Text;
+                cell.text = m_sharedStrings->at(index);
+                break;
+            }
+            case CellType::Inline:
+                decodeEscapes(text);
+                Q_FALLTHROUGH();
+            case CellType::FormulaString:
+            case CellType::IsoDate:
+                cell.kind = Cell::Text;
+                cell.text = text.toUtf8();
+                break;
+            case CellType::Boolean:
+                cell.kind = Cell::Bool;
+                cell.number = QStringView(text).trimmed() == QLatin1String("1") ? 1 : 0;
+                break;
+            case CellType::Number: {
+                bool ok = false;
+                cell.number = QStringView(text).trimmed().toDouble(&ok);
+                if (!ok) {
+                    cell.kind = Cell::Text;
+                    cell.text = text.toUtf8();
+                } else if (dateStyle) {
+                    cell.kind = Cell::Date;
+                    cell.secs = qRound64((cell.number - epochOffset) * 86400.0);
+                } else {
+                    cell.kind = Cell::Number;
+                }
+                break;
+            }
+            case CellType::Error:
+                return true;
+        }
+        if (cell.kind != Cell::Text || !cell.text.isEmpty()) {
+            row.append(cell);
+        }
+        return true;
+    };
+
+    bool reading = true;
+    while (reading) {
+        switch (stream.next()) {
+            case QXmlStreamReader::StartElement: {
+                const QStringView name = xml.name();
+                if (name == kTagCell) {
+                    const QXmlStreamAttributes attributes = xml.attributes();
+                    const int previous = row.isEmpty() ? -1 : row.last().column;
+                    const int column = columnFromReference(attributes.value("r"));
+                    cell = Cell();
+                    cell.column = column >= 0 ? column : previous + 1;
+                    type = cellType(attributes.value("t"));
+                    const int style = attributes.value("s").toInt();
+                    dateStyle = style >= 0 && style < m_dateStyles.size() && m_dateStyles[style];
+                    text.clear();
+                } else if (name == kTagValue) {
+                    inValue = true;
+                } else if (name == kTagInline) {
+                    inInline = true;
+                } else if (name == kTagText) {
+                    inText = inInline && phonetic == 0;
+                } else if (name == kTagPhonetic) {
+                    ++phonetic;
+                } else if (name == kTagRow) {
+                    row.clear();
+                }
+                break;
+            }
+            case QXmlStreamReader::Characters:
+                if (inValue || inText) {
+                    text.append(xml.text());
+                }
+                break;
+            case QXmlStreamReader::EndElement: {
+                const QStringView name = xml.name();
+                if (name == kTagValue) {
+                    inValue = false;
+                } else if (name == kTagText) {
+                    inText = false;
+                } else if (name == kTagPhonetic) {
+                    --phonetic;
+                } else if (name == kTagInline) {
+                    inInline = false;
+                } else if (name == kTagCell) {
+                    if (!finishCell()) {
+                        return;
+                    }
+                } else if (name == kTagRow) {
+                    finishRow();
+                    if (++rowsSeen % kCancelCheckRows == 0 && isCancelled()) {
+                        return;
+                    }
+                } else if (name == kTagSheetData) {
+                    reading = false;  // 其后的合并单元格、页面设置等与数据无关
+                }
+                break;
+            }
+            case QXmlStreamReader::EndDocument:
+                reading = false;
+                break;
+            case QXmlStreamReader::Invalid:
+                fail(QString("Invalid worksheet %1: %2").arg(sheet.name, stream.errorString()));
+                return;
+            default:
+                break;
+        }
+    }
+
+    if (isCancelled()) {
+        return;
+    }
+    if (!typesKnown && (!sample.isEmpty() || columnCount > 0)) {
+        resolveTypes();
+    }
+    flush();
+    reportProgress();
+}
@@ -0,0 +1,91 @@
+#ifndef XLSXREADER_H
+#define XLSXREADER_H
+
+#include "import/ImportBatch.h"
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+
+class ZipArchive;
+
+// 银行流水 XLSX 导入（替代后端 openpyxl 读取整个工作簿 DOM 的方式）
+// ZIP 条目流式解压后交给 QXmlStreamReader 增量解析，只保留当前批次的数据，内存占用与工作表行数无关
+// 多个工作表在线程池中并行解析，批次经有界队列交回调用线程，与 CsvImporter 产出相同的列批次
+// 共享字符串表在第一个字符串单元格出现时才加载（只加载一次），以紧凑的 UTF-8 数组保存，单元格直接引用
+class XlsxReader
+{
+public:
+    struct Options {
+        int threads = 0;                         // 0 表示 QThread::idealThreadCount()
+        int batchRows = 64 * 1024;               // 每个批次的行数
+        int sampleRows = 1000;                   // 推断列类型的样本行数（每个工作表）
+        bool hasHeader = true;                   // 每个工作表第一个非空行是表头
+        QStringList sheets;                      // 只导入这些工作表，空表示全部
+        QHash<QString, ImportColumn::Type> columnTypes;  // 按列名指定类型，覆盖推断结果
+    };
+
+    struct Sheet {
+        QString name;
+        qint64 rows = 0;
+        qint64 typeWidenings = 0;                // 值不符合列类型、整列放宽类型的次数（按批次计）
+        QStringList columnNames;
+        QVector<ImportColumn::Type> columnTypes; // 导入完成后为放宽后的最终类型
+    };
+
+    struct Stats {
+        qint64 rows = 0;
+        qint64 bytes = 0;                        // 所选工作表的压缩数据总量
+        qint64 elapsedMs = 0;
+        qint64 typeWidenings = 0;
+        int threads = 0;
+    };
+
+    explicit XlsxReader(const Options& options = Options());
+    ~XlsxReader();
+
+    // 阻塞直到导入完成、失败或被取消；批次在调用线程中交付，同一工作表内按行顺序，
+    // 不同工作表的批次交错到达（以 ImportBatch::source 区分）；失败时见 errorString()
+    bool import(const QString& path, const ImportBatchHandler& onBatch);
+    // 任意线程调用，各工作表在当前行解析完后停止
+    void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+    QString errorString() const { return m_error; }
+    const Stats& stats() const { return m_stats; }
+    // 导入完成后有效，顺序与工作簿一致
+    QVector<Sheet> sheets() const { return m_sheets; }
+
+private:
+    struct SheetTask;
+    struct SharedStrings;
+    struct BatchQueue;
+
+    bool readWorkbook(ZipArchive& archive, QVector<SheetTask>& tasks, QString* sharedStringsPath, QString* stylesPath);
+    bool readStyles(ZipArchive& archive, const QString& stylesPath);
+    void parseSheet(const ZipArchive& archive, SheetTask& task);
+    // 工作线程出错：记录第一个错误并停止其他工作表
+    void fail(const QString& error);
+
+private:
+    Options m_options;
+    QThreadPool m_pool;
+    std::atomic<bool> m_cancelled;
+    std::atomic<qint64> m_compressedRead;        // 所有工作表已解压的压缩字节数（进度）
+    QMutex m_errorMutex;
+    QString m_error;
+    Stats m_stats;
+    QVector<Sheet> m_sheets;
+
+    bool m_date1904;
+    QVector<bool> m_dateStyles;                  // cellXfs 下标 -> 是否日期格式
+    SharedStrings* m_sharedStrings;              // 仅在 import() 期间有效
+    BatchQueue* m_queue;
+
+    Q_DISABLE_COPY(XlsxReader)
+};
+
+#endif // XLSXREADER_H
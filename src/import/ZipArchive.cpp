@@ -0,0 +1,364 @@
+#include "import/ZipArchive.h"
+#include <QtEndian>
+#include <climits>
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+constexpr quint32 kLocalHeaderSignature = 0x04034b50;
+constexpr quint32 kCentralHeaderSignature = 0x02014b50;
+constexpr quint32 kEndOfCentralDirSignature = 0x06054b50;
+constexpr quint32 kZip64LocatorSignature = 0x07064b50;
+constexpr quint32 kZip64EndOfCentralDirSignature = 0x06064b50;
+constexpr quint16 kZip64ExtraId = 0x0001;
+
+constexpr qint64 kEndOfCentralDirSize = 22;
+constexpr qint64 kZip64LocatorSize = 20;
+constexpr qint64 kZip64EndOfCentralDirSize = 56;
+constexpr qint64 kCentralHeaderSize = 46;
+constexpr qint64 kLocalHeaderSize = 30;
+constexpr qint64 kMaxCommentSize = 0xFFFF;
+
+// 每次交给 inflate 的压缩数据上限（z_stream 的长度字段是 32 位）
+constexpr qint64 kInflateInputSlice = 1024 * 1024;
+
+quint16 u16(const uchar* p) { return qFromLittleEndian<quint16>(p); }
+quint32 u32(const uchar* p) { return qFromLittleEndian<quint32>(p); }
+quint64 u64(const uchar* p) { return qFromLittleEndian<quint64>(p); }
+
+} // namespace
+
+// ==================== ZipArchive ====================
+
+ZipArchive::ZipArchive()
+    : m_data(nullptr)
+    , m_size(0)
+{
+}
+
+ZipArchive::~ZipArchive()
+{
+    close();
+}
+
+bool ZipArchive::open(const QString& path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    m_data = m_size > 0 ? m_file.map(0, m_size) : nullptr;
+    if (!m_data) {
+        m_error = "Failed to map file: " + m_file.errorString();
+        close();
+        return false;
+    }
+    if (!readCentralDirectory()) {
+        const QString error = m_error;
+        close();
+        m_error = error;
+        return false;
+    }
+    return true;
+}
+
+void ZipArchive::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_entries.clear();
+    m_error.clear();
+}
+
+bool ZipArchive::readCentralDirectory()
+{
+    // 1. 从文件尾部向前查找中央目录结束记录（其后可能跟有注释）
+    qint64 eocd = -1;
+    const qint64 lowest = qMax<qint64>(0, m_size - kEndOfCentralDirSize - kMaxCommentSize);
+    for (qint64 pos = m_size - kEndOfCentralDirSize; pos >= lowest; --pos) {
+        if (u32(m_data + pos) == kEndOfCentralDirSignature) {
+            eocd = pos;
+            break;
+        }
+    }
+    if (eocd < 0) {
+        m_error = "Not a ZIP archive: end of central directory not found";
+        return false;
+    }
+
+    quint64 entryCount = u16(m_data + eocd + 10);
+    quint64 directorySize = u32(m_data + eocd + 12);
+    quint64 directoryOffset = u32(m_data + eocd + 16);
+
+    // 2. 超过 65535 个条目或 4 GB 时使用 ZIP64 结束记录
+    if (entryCount == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF) {
+        const qint64 locator = eocd - kZip64LocatorSize;
+        if (locator < 0 || u32(m_data + locator) != kZip64LocatorSignature) {
+            m_error = "ZIP64 end of central directory locator not found";
+            return false;
+        }
+        const quint64 record = u64(m_data + locator + 8);
+        if (record > quint64(m_size - kZip64EndOfCentralDirSize)
+            || u32(m_data + record) != kZip64EndOfCentralDirSignature) {
+            m_error = "Invalid ZIP64 end of central directory record";
+            return false;
+        }
+        entryCount = u64(m_data + record + 32);
+        directorySize = u64(m_data + record + 40);
+        directoryOffset = u64(m_data + record + 48);
+    }
+
+    if (directoryOffset > quint64(m_size) || directorySize > quint64(m_size) - directoryOffset) {
+        m_error = "Central directory is outside of the file";
+        return false;
+    }
+
+    // 3. 逐条读取中央目录（大小以中央目录为准，兼容使用数据描述符的条目）
+    const uchar* p = m_data + directoryOffset;
+    const uchar* end = p + directorySize;
+    m_entries.reserve(qsizetype(qMin<quint64>(entryCount, directorySize / kCentralHeaderSize)));
+    for (quint64 i = 0; i < entryCount; ++i) {
+        if (end - p < kCentralHeaderSize || u32(p) != kCentralHeaderSignature) {
+            m_error = "Corrupted central directory";
+            return false;
+        }
+        const quint16 nameLength = u16(p + 28);
+        const quint16 extraLength = u16(p + 30);
+        const quint16 commentLength = u16(p + 32);
+        if (end - p < kCentralHeaderSize + nameLength + extraLength + commentLength) {
+            m_error = "Corrupted central directory";
+            return false;
+        }
+
+        Entry entry;
+        entry.method = u16(p + 10);
+        quint64 compressedSize = u32(p + 20);
+        quint64 uncompressedSize = u32(p + 24);
+        quint64 localHeaderOffset = u32(p + 42);
+        entry.name = QString::fromUtf8(reinterpret_cast<const char*>(p + kCentralHeaderSize), nameLength);
+
+        // ZIP64 扩展字段只包含取值为 0xFFFFFFFF 的字段，顺序固定
+        const uchar* extra = p + kCentralHeaderSize + nameLength;
+        const uchar* extraEnd = extra + extraLength;
+        while (extraEnd - extra >= 4) {
+            const quint16 id = u16(extra);
+            const quint16 size = u16(extra + 2);
+            const uchar* field = extra + 4;
+            const uchar* fieldEnd = field + qMin<qint64>(size, extraEnd - field);
+            if (id == kZip64ExtraId) {
+                if (uncompressedSize == 0xFFFFFFFF && fieldEnd - field >= 8) {
+                    uncompressedSize = u64(field);
+                    field += 8;
+                }
+                if (compressedSize == 0xFFFFFFFF && fieldEnd - field >= 8) {
+                    compressedSize = u64(field);
+                    field += 8;
+                }
+                if (localHeaderOffset == 0xFFFFFFFF && fieldEnd - field >= 8) {
+                    localHeaderOffset = u64(field);
+                }
+            }
+            extra = fieldEnd;
+        }
+
+        if (compressedSize > quint64(m_size) || localHeaderOffset > quint64(m_size)
+            || uncompressedSize > quint64(LLONG_MAX)) {
+            m_error = "Invalid ZIP entry: " + entry.name;
+            return false;
+        }
+        entry.compressedSize = qint64(compressedSize);
+        entry.uncompressedSize = qint64(uncompressedSize);
+        entry.localHeaderOffset = qint64(localHeaderOffset);
+        m_entries.append(entry);
+
+        p += kCentralHeaderSize + nameLength + extraLength + commentLength;
+    }
+    return true;
+}
+
+const ZipArchive::Entry* ZipArchive::find(const QString& name) const
+{
+    for (const Entry& entry : m_entries) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    // 个别生成工具的路径大小写与关系文件不一致
+    for (const Entry& entry : m_entries) {
+        if (entry.name.compare(name, Qt::CaseInsensitive) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+qint64 ZipArchive::dataOffset(const Entry& entry) const
+{
+    const qint64 header = entry.localHeaderOffset;
+    if (header > m_size - kLocalHeaderSize || u32(m_data + header) != kLocalHeaderSignature) {
+        return -1;
+    }
+    const qint64 offset = header + kLocalHeaderSize + u16(m_data + header + 26) + u16(m_data + header + 28);
+    if (offset > m_size || entry.compressedSize > m_size - offset) {
+        return -1;
+    }
+    return offset;
+}
+
+bool ZipArchive::read(const Entry& entry, QByteArray* out)
+{
+    constexpr qint64 kReadChunk = 1024 * 1024;
+
+    out->clear();
+    ZipEntryReader reader(*this, entry);
+    if (entry.uncompressedSize < 256 * 1024 * 1024) {
+        out->reserve(qsizetype(entry.uncompressedSize));
+    }
+    while (reader.isValid() && !reader.atEnd()) {
+        out->append(reader.read(kReadChunk));
+    }
+    if (!reader.isValid()) {
+        m_error = reader.errorString();
+        return false;
+    }
+    return true;
+}
+
+// ==================== ZipEntryReader ====================
+
+struct ZipEntryReader::Inflater {
+#ifdef HAS_ZLIB
+    z_stream stream{};
+#endif
+};
+
+ZipEntryReader::ZipEntryReader(const ZipArchive& archive, const ZipArchive::Entry& entry)
+    : m_input(nullptr)
+    , m_compressedSize(entry.compressedSize)
+    , m_uncompressedSize(entry.uncompressedSize)
+    , m_inputOffset(0)
+    , m_outputSize(0)
+    , m_method(entry.method)
+    , m_finished(false)
+{
+    const qint64 offset = archive.m_data ? archive.dataOffset(entry) : -1;
+    if (offset < 0) {
+        m_error = "Invalid local file header: " + entry.name;
+        return;
+    }
+    m_input = archive.m_data + offset;
+
+    if (m_method == 0) {
+        if (m_uncompressedSize != m_compressedSize) {
+            m_error = "Stored entry size mismatch: " + entry.name;
+        }
+        return;
+    }
+    if (m_method != 8) {
+        m_error = QString("Unsupported compression method %1: %2").arg(m_method).arg(entry.name);
+        return;
+    }
+#ifdef HAS_ZLIB
+    m_inflater.reset(new Inflater);
+    // 负的窗口位数表示原始 deflate 流（ZIP 中没有 zlib 头）
+    if (inflateInit2(&m_inflater->stream, -MAX_WBITS) != Z_OK) {
+        m_inflater.reset();
+        m_error = "Failed to initialize inflate";
+    }
+#else
+    m_error = "XLSX import requires zlib (deflate entries cannot be read): " + entry.name;
+#endif
+}
+
+ZipEntryReader::~ZipEntryReader()
+{
+#ifdef HAS_ZLIB
+    if (m_inflater) {
+        inflateEnd(&m_inflater->stream);
+    }
+#endif
+}
+
+QByteArray ZipEntryReader::read(qint64 maxBytes)
+{
+    if (!isValid() || m_finished || maxBytes <= 0) {
+        return QByteArray();
+    }
+
+    if (m_method == 0) {
+        const qint64 n = qMin(maxBytes, m_compressedSize - m_inputOffset);
+        QByteArray out(reinterpret_cast<const char*>(m_input + m_inputOffset), qsizetype(n));
+        m_inputOffset += n;
+        m_finished = m_inputOffset >= m_compressedSize;
+        return out;
+    }
+
+#ifdef HAS_ZLIB
+    // 最多比剩余的声明大小多解出 1 字节，多出来就说明条目比声明的大
+    const qint64 limit = qMin(maxBytes, m_uncompressedSize - m_outputSize + 1);
+    QByteArray out(qsizetype(limit), Qt::Uninitialized);
+    z_stream& stream = m_inflater->stream;
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = uInt(qMin<qint64>(limit, UINT_MAX));
+
+    while (stream.avail_out > 0) {
+        if (stream.avail_in == 0) {
+            const qint64 remaining = m_compressedSize - m_inputOffset;
+            if (remaining <= 0) {
+                m_error = "Truncated deflate stream";
+                return QByteArray();
+            }
+            const qint64 slice = qMin(remaining, kInflateInputSlice);
+            stream.next_in = const_cast<Bytef*>(m_input + m_inputOffset);
+            stream.avail_in = uInt(slice);
+            m_inputOffset += slice;
+        }
+        const int result = inflate(&stream, Z_NO_FLUSH);
+        if (result == Z_STREAM_END) {
+            m_finished = true;
+            break;
+        }
+        if (result != Z_OK) {
+            m_error = QString("Inflate failed (%1)").arg(stream.msg ? stream.msg : "unknown error");
+            return QByteArray();
+        }
+    }
+
+    const qint64 produced = limit - stream.avail_out;
+    m_outputSize += produced;
+    if (m_outputSize > m_uncompressedSize) {
+        m_error = QString("Entry inflates beyond its declared size (%1 bytes)").arg(m_uncompressedSize);
+        return QByteArray();
+    }
+    if (m_finished && m_outputSize != m_uncompressedSize) {
+        m_error = QString("Entry size mismatch (%1 of %2 bytes)").arg(m_outputSize).arg(m_uncompressedSize);
+        return QByteArray();
+    }
+
+    out.truncate(qsizetype(produced));
+    return out;
+#else
+    return QByteArray();
+#endif
+}
+
+qint64 ZipEntryReader::compressedRead() const
+{
+#ifdef HAS_ZLIB
+    // 已交给 inflate 但尚未消耗的输入不计入进度
+    if (m_inflater) {
+        return m_inputOffset - m_inflater->stream.avail_in;
+    }
+#endif
+    return m_inputOffset;
+}
@@ -0,0 +1,88 @@
+#ifndef ZIPARCHIVE_H
+#define ZIPARCHIVE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+// 只读 ZIP 归档（XLSX 容器）：文件映射到内存，只解析中央目录，支持 ZIP64
+// 条目数据按需解压：小条目用 read() 一次读出，大条目（工作表）用 ZipEntryReader 流式解压
+// 映射区只读，多个 ZipEntryReader 可在不同线程中同时读取
+// 解压 deflate 条目需要 zlib（HAS_ZLIB），否则只能读取未压缩的条目
+class ZipArchive
+{
+public:
+    struct Entry {
+        QString name;
+        int method = 0;                          // 0 = stored，8 = deflate
+        qint64 compressedSize = 0;
+        qint64 uncompressedSize = 0;
+        qint64 localHeaderOffset = 0;
+    };
+
+    ZipArchive();
+    ~ZipArchive();
+
+    bool open(const QString& path);
+    void close();
+    QString errorString() const { return m_error; }
+
+    const QVector<Entry>& entries() const { return m_entries; }
+    const Entry* find(const QString& name) const;
+
+    // 解压整个条目（workbook.xml、styles.xml 等小条目）
+    bool read(const Entry& entry, QByteArray* out);
+
+private:
+    friend class ZipEntryReader;
+
+    bool readCentralDirectory();
+    // 校验本地文件头并返回条目数据在文件中的偏移，失败返回 -1
+    qint64 dataOffset(const Entry& entry) const;
+
+private:
+    QFile m_file;
+    const uchar* m_data;
+    qint64 m_size;
+    QVector<Entry> m_entries;
+    QString m_error;
+
+    Q_DISABLE_COPY(ZipArchive)
+};
+
+// 流式读取一个条目：每次返回一段解压后的数据，内存占用与条目大小无关
+class ZipEntryReader
+{
+public:
+    ZipEntryReader(const ZipArchive& archive, const ZipArchive::Entry& entry);
+    ~ZipEntryReader();
+
+    bool isValid() const { return m_error.isEmpty(); }
+    QString errorString() const { return m_error; }
+
+    // 返回最多 maxBytes 字节的解压数据；结束或出错时返回空（见 atEnd() / errorString()）
+    // 解压结果超过或不足中央目录记录的大小时报错，损坏或恶意构造的条目不会无限展开
+    QByteArray read(qint64 maxBytes);
+    bool atEnd() const { return m_finished; }
+    // 已消耗的压缩数据字节数（用于进度）
+    qint64 compressedRead() const;
+
+private:
+    struct Inflater;
+
+    const uchar* m_input;
+    qint64 m_compressedSize;
+    qint64 m_uncompressedSize;                   // 中央目录记录的解压后大小，解压输出不得超过
+    qint64 m_inputOffset;                        // 已交给解压器的压缩数据字节数
+    qint64 m_outputSize;                         // 已解压输出的字节数
+    int m_method;
+    bool m_finished;
+    QString m_error;
+    std::unique_ptr<Inflater> m_inflater;
+
+    Q_DISABLE_COPY(ZipEntryReader)
+};
+
+#endif // ZIPARCHIVE_H
@@ -14,6 +14,9 @@ int main(int argc, char *argv[])
     QDir().mkpath(logPath);
     QString logFile = logPath + "/fundanalysis.log";
     Logger::instance()->setLogFile(logFile);
+    // 异步写日志：调用线程只入队，磁盘 I/O 在后台写入线程批量完成；退出与崩溃时写出缓冲区
+    Logger::instance()->setAsync(true);
+    Logger::installCrashHandler();
     
     Logger::instance()->info("========================================");
     Logger::instance()->info("资金分析系统启动");
@@ -23,9 +26,18 @@ int main(int argc, char *argv[])
     // 初始化应用程序
     if (!app.initialize()) {
         QMessageBox::critical(nullptr, "错误", "应用程序初始化失败!");
+        Logger::instance()->shutdown();
         return -1;
     }
     
+    // 日志轮转策略（config.ini 的 log/* 配置项可覆盖默认值）
+    LogRotationPolicy rotation;
+    rotation.maxBytes = app.getConfigValue("log/max_size_mb", "64").toLongLong() * 1024 * 1024;
+    rotation.daily = app.getConfigValue("log/daily_rollover", "true") == "true";
+    rotation.maxFiles = app.getConfigValue("log/retention", "14").toInt();
+    rotation.compress = app.getConfigValue("log/compress", "true") == "true";
+    Logger::instance()->setRotationPolicy(rotation);
+    
     // 创建并显示主窗口
     MainWindow mainWindow;
     mainWindow.show();
@@ -37,6 +49,7 @@ int main(int argc, char *argv[])
     
     Logger::instance()->info("Application exiting with code: " + QString::number(ret));
     Logger::instance()->info("========================================");
+    Logger::instance()->shutdown();
     
     return ret;
 }
@@ -0,0 +1,174 @@
+#include "network/ColumnarFile.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'A', 'C', 'O', 'L', '0', '1', '\0'};
+constexpr qint64 kPreambleSize = 12;  // 魔数 + 元数据长度
+
+} // namespace
+
+ColumnarFile::ColumnarFile()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_rows(0)
+    , m_autoRemove(false)
+{
+}
+
+ColumnarFile::~ColumnarFile()
+{
+    close();
+}
+
+bool ColumnarFile::open(const QString& path)
+{
+    close();
+    
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    
+    m_size = m_file.size();
+    m_data = m_size > 0 ? m_file.map(0, m_size) : nullptr;
+    if (!m_data) {
+        m_error = "Failed to map file: " + m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    
+    if (!parse()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ColumnarFile::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    
+    // Windows 下映射中的文件不能删除，先解除映射
+    if (m_file.isOpen()) {
+        m_file.close();
+        if (m_autoRemove) {
+            m_file.remove();
+        }
+    }
+    
+    m_size = 0;
+    m_rows = 0;
+    m_columns.clear();
+}
+
+bool ColumnarFile::parse()
+{
+    if (m_size < kPreambleSize || memcmp(m_data, kMagic, sizeof(kMagic)) != 0) {
+        m_error = "Not a columnar result file";
+        return false;
+    }
+    
+    const quint32 metaSize = qFromLittleEndian<quint32>(m_data + 8);
+    if (kPreambleSize + metaSize > quint64(m_size)) {
+        m_error = "Truncated metadata";
+        return false;
+    }
+    
+    QJsonObject meta = QJsonDocument::fromJson(
+        QByteArray::fromRawData(reinterpret_cast<const char*>(m_data + kPreambleSize), metaSize)).object();
+    m_rows = meta["rows"].toInteger();
+    
+    // 校验每个缓冲区都落在文件内、长度与行数一致，之后的访问不再检查
+    auto inFile = [this](qint64 offset, qint64 length) {
+        return offset >= 0 && length >= 0 && offset + length <= m_size;
+    };
+    
+    const QJsonArray columns = meta["columns"].toArray();
+    for (const QJsonValue& value : columns) {
+        QJsonObject object = value.toObject();
+        Column column;
+        column.name = object["name"].toString();
+        column.offset = object["offset"].toInteger();
+        column.length = object["length"].toInteger();
+        column.dataOffset = object["data_offset"].toInteger();
+        column.dataLength = object["data_length"].toInteger();
+        
+        QString type = object["type"].toString();
+        bool valid = inFile(column.offset, column.length);
+        if (type == "int64" || type == "float64") {
+            column.type = type == "int64" ? Int64 : Float64;
+            valid = valid && column.length == m_rows * 8 && column.offset % 8 == 0;
+        } else if (type == "string") {
+            column.type = String;
+            valid = valid && column.length == (m_rows + 1) * 8 && column.offset % 8 == 0
+                    && inFile(column.dataOffset, column.dataLength);
+            if (valid && m_rows > 0) {
+                const qint64* offsets = reinterpret_cast<const qint64*>(m_data + column.offset);
+                valid = qFromLittleEndian(offsets[m_rows]) == column.dataLength;
+            }
+        } else {
+            valid = false;
+        }
+        
+        if (!valid) {
+            m_error = "Invalid column: " + column.name;
+            return false;
+        }
+        m_columns.append(column);
+    }
+    
+    return true;
+}
+
+int ColumnarFile::columnIndex(const QString& name) const
+{
+    for (int i = 0; i < m_columns.size(); ++i) {
+        if (m_columns.at(i).name == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const qint64* ColumnarFile::int64Data(int column) const
+{
+    // 文件按小端写出，与 x86/ARM 主机字节序一致，可直接使用
+    if (column < 0 || column >= m_columns.size() || m_columns.at(column).type != Int64) {
+        return nullptr;
+    }
+    return reinterpret_cast<const qint64*>(m_data + m_columns.at(column).offset);
+}
+
+const double* ColumnarFile::float64Data(int column) const
+{
+    if (column < 0 || column >= m_columns.size() || m_columns.at(column).type != Float64) {
+        return nullptr;
+    }
+    return reinterpret_cast<const double*>(m_data + m_columns.at(column).offset);
+}
+
+QByteArrayView ColumnarFile::stringAt(int column, qint64 row) const
+{
+    if (column < 0 || column >= m_columns.size() || m_columns.at(column).type != String
+        || row < 0 || row >= m_rows) {
+        return QByteArrayView();
+    }
+    
+    const Column& c = m_columns.at(column);
+    const qint64* offsets = reinterpret_cast<const qint64*>(m_data + c.offset);
+    const qint64 begin = offsets[row];
+    const qint64 end = offsets[row + 1];
+    if (begin < 0 || end < begin || end > c.dataLength) {
+        return QByteArrayView();
+    }
+    return QByteArrayView(reinterpret_cast<const char*>(m_data + c.dataOffset + begin), end - begin);
+}
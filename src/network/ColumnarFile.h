@@ -0,0 +1,65 @@
+#ifndef COLUMNARFILE_H
+#define COLUMNARFILE_H
+
+#include <QByteArrayView>
+#include <QFile>
+#include <QList>
+#include <QString>
+
+// 后端写出的列式结果文件（同机批量数据通道）
+// 整个文件只读映射到内存，各列直接指向映射区，不做复制；格式见 backend/main.py 的 write_columnar
+class ColumnarFile
+{
+public:
+    enum ColumnType {
+        Int64,
+        Float64,
+        String
+    };
+    
+    struct Column {
+        QString name;
+        ColumnType type = Int64;
+        qint64 offset = 0;         // 定长值，或字符串的 rows+1 个偏移
+        qint64 length = 0;
+        qint64 dataOffset = 0;     // 字符串的 UTF-8 数据
+        qint64 dataLength = 0;
+    };
+
+    ColumnarFile();
+    ~ColumnarFile();
+    
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+    QString errorString() const { return m_error; }
+    
+    // 关闭时删除文件（文件由后端为本次请求生成，用完即删）
+    void setAutoRemove(bool autoRemove) { m_autoRemove = autoRemove; }
+    
+    qint64 rowCount() const { return m_rows; }
+    int columnCount() const { return int(m_columns.size()); }
+    const Column& column(int index) const { return m_columns.at(index); }
+    int columnIndex(const QString& name) const;
+    
+    // 类型不符时返回 nullptr
+    const qint64* int64Data(int column) const;
+    const double* float64Data(int column) const;
+    QByteArrayView stringAt(int column, qint64 row) const;   // UTF-8，指向映射区
+
+private:
+    bool parse();
+
+private:
+    QFile m_file;
+    const uchar* m_data;
+    qint64 m_size;
+    qint64 m_rows;
+    QList<Column> m_columns;
+    QString m_error;
+    bool m_autoRemove;
+    
+    Q_DISABLE_COPY(ColumnarFile)
+};
+
+#endif // COLUMNARFILE_H
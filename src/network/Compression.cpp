@@ -0,0 +1,221 @@
+#include "network/Compression.h"
+#include "core/Logger.h"
+#include <QtEndian>
+#include <cstring>
+
+#ifdef HAS_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
+#ifdef HAS_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+constexpr unsigned char kMagic = 0xFC;
+constexpr qsizetype kHeaderSize = 6;
+
+// 单条消息解压后的上限，防止损坏的长度字段导致超大分配
+constexpr quint32 kMaxRawSize = 1024u * 1024u * 1024u;
+
+} // namespace
+
+QByteArray Compression::compress(const QByteArray& data, Algorithm algorithm, int level)
+{
+    QByteArray body;
+    
+    switch (algorithm) {
+        case Zlib:
+            // qCompress 前 4 字节为大端原始长度，压缩帧头里已有，去掉
+            body = qCompress(data, level).mid(4);
+            break;
+#ifdef HAS_LZ4
+        case Lz4: {
+            body.resize(LZ4_compressBound(int(data.size())));
+            int size = level > 0
+                ? LZ4_compress_HC(data.constData(), body.data(), int(data.size()), int(body.size()), level)
+                : LZ4_compress_default(data.constData(), body.data(), int(data.size()), int(body.size()));
+            if (size <= 0) {
+                return QByteArray();
+            }
+            body.truncate(size);
+            break;
+        }
+#endif
+#ifdef HAS_ZSTD
+        case Zstd: {
+            body.resize(qsizetype(ZSTD_compressBound(size_t(data.size()))));
+            size_t size = ZSTD_compress(body.data(), size_t(body.size()), data.constData(), size_t(data.size()), level);
+            if (ZSTD_isError(size)) {
+                return QByteArray();
+            }
+            body.truncate(qsizetype(size));
+            break;
+        }
+#endif
+        default:
+            return QByteArray();
+    }
+    
+    QByteArray frame(kHeaderSize, Qt::Uninitialized);
+    frame[0] = char(kMagic);
+    frame[1] = char(algorithm);
+    qToLittleEndian<quint32>(quint32(data.size()), frame.data() + 2);
+    return frame + body;
+}
+
+QByteArray Compression::decompress(const char* data, qsizetype size)
+{
+    if (!isCompressed(data, size)) {
+        return QByteArray();
+    }
+    
+    const Algorithm algorithm = Algorithm(static_cast<unsigned char>(data[1]));
+    const quint32 rawSize = qFromLittleEndian<quint32>(data + 2);
+    const char* body = data + kHeaderSize;
+    const qsizetype bodySize = size - kHeaderSize;
+    if (rawSize > kMaxRawSize) {
+        return QByteArray();
+    }
+    
+    switch (algorithm) {
+        case Zlib: {
+#ifdef HAS_ZLIB
+            // 最多解出帧头声明的长度，输出放不下（实际数据更大）时 uncompress 返回 Z_BUF_ERROR
+            QByteArray raw(qsizetype(rawSize), Qt::Uninitialized);
+            uLongf rawLength = uLongf(rawSize);
+            int result = uncompress(reinterpret_cast<Bytef*>(raw.data()), &rawLength,
+                                    reinterpret_cast<const Bytef*>(body), uLong(bodySize));
+            return result == Z_OK && rawLength == rawSize ? raw : QByteArray();
+#else
+            // 没有系统 zlib 时用 qUncompress：前缀长度只是分配提示，解压后再核对长度
+            QByteArray input(4 + bodySize, Qt::Uninitialized);
+            qToBigEndian<quint32>(rawSize, input.data());
+            memcpy(input.data() + 4, body, size_t(bodySize));
+            QByteArray raw = qUncompress(input);
+            return raw.size() == qsizetype(rawSize) ? raw : QByteArray();
+#endif
+        }
+#ifdef HAS_LZ4
+        case Lz4: {
+            QByteArray raw(qsizetype(rawSize), Qt::Uninitialized);
+            int result = LZ4_decompress_safe(body, raw.data(), int(bodySize), int(rawSize));
+            return result == int(rawSize) ? raw : QByteArray();
+        }
+#endif
+#ifdef HAS_ZSTD
+        case Zstd: {
+            QByteArray raw(qsizetype(rawSize), Qt::Uninitialized);
+            size_t result = ZSTD_decompress(raw.data(), rawSize, body, size_t(bodySize));
+            return !ZSTD_isError(result) && result == rawSize ? raw : QByteArray();
+        }
+#endif
+        default:
+            return QByteArray();
+    }
+}
+
+bool Compression::isCompressed(const char* data, qsizetype size)
+{
+    return size >= kHeaderSize && static_cast<unsigned char>(data[0]) == kMagic;
+}
+
+QString Compression::algorithmName(Algorithm algorithm)
+{
+    switch (algorithm) {
+        case Zlib: return "zlib";
+        case Lz4:  return "lz4";
+        case Zstd: return "zstd";
+        case None:
+        default:   return "none";
+    }
+}
+
+Compression::Algorithm Compression::algorithmFromName(const QString& name, Algorithm fallback)
+{
+    if (name == "zlib") {
+        return Zlib;
+    }
+#ifdef HAS_LZ4
+    if (name == "lz4") {
+        return Lz4;
+    }
+#endif
+#ifdef HAS_ZSTD
+    if (name == "zstd") {
+        return Zstd;
+    }
+#endif
+    if (name == "none") {
+        return None;
+    }
+    return fallback;
+}
+
+QStringList Compression::supportedAlgorithms()
+{
+    // 按优先级排列，zlib 随 Qt 提供，总是可用
+    QStringList algorithms;
+#ifdef HAS_ZSTD
+    algorithms << "zstd";
+#endif
+#ifdef HAS_LZ4
+    algorithms << "lz4";
+#endif
+    algorithms << "zlib";
+    return algorithms;
+}
+
+// ==================== CompressionStats ====================
+
+void CompressionStats::record(const QString& action, Direction direction, qsizetype rawBytes,
+                              qsizetype wireBytes, qint64 nsecs)
+{
+    const QString key = (direction == Compress ? "compress " : "decompress ") + action;
+    
+    Entry snapshot;
+    {
+        QMutexLocker locker(&m_mutex);
+        Entry& entry = m_entries[key];
+        entry.count++;
+        entry.rawBytes += rawBytes;
+        entry.wireBytes += wireBytes;
+        entry.nsecs += nsecs;
+        if (entry.count % 100 != 1) {
+            return;
+        }
+        snapshot = entry;
+    }
+    
+    log(key, snapshot);
+}
+
+void CompressionStats::logSummary()
+{
+    QHash<QString, Entry> entries;
+    {
+        QMutexLocker locker(&m_mutex);
+        entries = m_entries;
+    }
+    
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        log(it.key(), it.value());
+    }
+}
+
+void CompressionStats::log(const QString& key, const Entry& entry)
+{
+    Logger::instance()->info(QString("Compression [%1]: %2 msgs, %3 KB -> %4 KB, ratio %5, %6 us/msg")
+                                 .arg(key)
+                                 .arg(entry.count)
+                                 .arg(entry.rawBytes / 1024)
+                                 .arg(entry.wireBytes / 1024)
+                                 .arg(double(entry.rawBytes) / double(qMax<qint64>(entry.wireBytes, 1)), 0, 'f', 2)
+                                 .arg(double(entry.nsecs) / 1000.0 / double(entry.count), 0, 'f', 1));
+}
@@ -0,0 +1,61 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+// 消息压缩（zlib / lz4 / zstd）
+// 压缩帧：[0xFC][算法][原始长度 uint32 LE][压缩数据]
+// 0xFC 既不是 JSON 的 '{' 也不在 CBOR map 的首字节范围内，解码前可直接识别
+class Compression
+{
+public:
+    enum Algorithm {
+        None,
+        Zlib,
+        Lz4,
+        Zstd
+    };
+
+    static QByteArray compress(const QByteArray& data, Algorithm algorithm, int level);
+    static QByteArray decompress(const char* data, qsizetype size);   // 失败时返回空
+    static bool isCompressed(const char* data, qsizetype size);
+    
+    // 协商用名称（"zlib" / "lz4" / "zstd"）
+    static QString algorithmName(Algorithm algorithm);
+    static Algorithm algorithmFromName(const QString& name, Algorithm fallback = None);
+    static QStringList supportedAlgorithms();
+};
+
+// 按动作统计压缩比与 CPU 耗时（线程安全），每个动作每 100 条消息写一次日志
+class CompressionStats
+{
+public:
+    enum Direction {
+        Compress,
+        Decompress
+    };
+
+    void record(const QString& action, Direction direction, qsizetype rawBytes,
+                qsizetype wireBytes, qint64 nsecs);
+    void logSummary();
+
+private:
+    struct Entry {
+        quint64 count = 0;
+        qint64 rawBytes = 0;
+        qint64 wireBytes = 0;
+        qint64 nsecs = 0;
+    };
+    
+    static void log(const QString& key, const Entry& entry);
+
+private:
+    QMutex m_mutex;
+    QHash<QString, Entry> m_entries;           // 键为 "<方向> <动作>"
+};
+
+#endif // COMPRESSION_H
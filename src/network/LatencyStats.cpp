@@ -0,0 +1,106 @@
+#include "network/LatencyStats.h"
+#include <QtAlgorithms>
+
+// ==================== LatencyHistogram ====================
+
+void LatencyHistogram::record(qint64 nsecs)
+{
+    nsecs = qMax<qint64>(nsecs, 0);
+    m_buckets[bucketFor(nsecs / 1000)]++;
+    m_count++;
+    m_max = qMax(m_max, nsecs);
+}
+
+qint64 LatencyHistogram::percentile(double p) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+    
+    const quint64 rank = qMax<quint64>(1, quint64(p * double(m_count) + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) {
+            // 桶上界可能超过实际最大值
+            return qMin(bucketUpperBound(i) * 1000, m_max);
+        }
+    }
+    return m_max;
+}
+
+int LatencyHistogram::bucketFor(qint64 usecs)
+{
+    if (usecs < kLinearBuckets) {
+        return int(usecs);
+    }
+    
+    // usecs 的最高位决定区间，其后 3 位决定区间内的子桶
+    int exponent = 63 - qCountLeadingZeroBits(quint64(usecs));
+    int octave = exponent - 4;
+    if (octave >= kOctaves) {
+        return kBucketCount - 1;
+    }
+    int sub = int((usecs >> (exponent - 3)) & (kSubBuckets - 1));
+    return kLinearBuckets + octave * kSubBuckets + sub;
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int bucket)
+{
+    if (bucket < kLinearBuckets) {
+        return bucket + 1;
+    }
+    
+    int octave = (bucket - kLinearBuckets) / kSubBuckets;
+    int sub = (bucket - kLinearBuckets) % kSubBuckets;
+    int exponent = octave + 4;
+    return (qint64(kSubBuckets + sub + 1) << (exponent - 3));
+}
+
+// ==================== LatencyStats ====================
+
+void LatencyStats::record(const QString& action, Stage stage, qint64 nsecs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_actions[action][stage].record(nsecs);
+}
+
+QList<LatencyStats::Summary> LatencyStats::snapshot() const
+{
+    QMutexLocker locker(&m_mutex);
+    
+    QList<Summary> summaries;
+    summaries.reserve(m_actions.size());
+    for (auto it = m_actions.cbegin(); it != m_actions.cend(); ++it) {
+        Summary summary;
+        summary.action = it.key();
+        summary.count = it.value()[Wait].count();
+        for (int stage = 0; stage < StageCount; ++stage) {
+            const LatencyHistogram& histogram = it.value()[stage];
+            summary.p50[stage] = histogram.percentile(0.50);
+            summary.p99[stage] = histogram.percentile(0.99);
+            summary.max[stage] = histogram.max();
+        }
+        summaries.append(summary);
+    }
+    return summaries;
+}
+
+void LatencyStats::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_actions.clear();
+}
+
+QString LatencyStats::stageName(Stage stage)
+{
+    switch (stage) {
+        case Serialize: return "序列化";
+        case Send:      return "发送";
+        case Wait:      return "等待";
+        case Handler:   return "后端处理";
+        case Network:   return "网络";
+        case Parse:     return "解析";
+        default:        return QString();
+    }
+}
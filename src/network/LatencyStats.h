@@ -0,0 +1,68 @@
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <array>
+
+// 延迟直方图：16us 以下每 1us 一个桶，之后每个 2 的幂区间分 8 个桶（相对误差不超过 12.5%）
+class LatencyHistogram
+{
+public:
+    void record(qint64 nsecs);
+    
+    quint64 count() const { return m_count; }
+    qint64 percentile(double p) const;         // 纳秒，取所在桶的上界
+    qint64 max() const { return m_max; }
+
+private:
+    static constexpr int kLinearBuckets = 16;
+    static constexpr int kSubBuckets = 8;
+    static constexpr int kOctaves = 33;        // 上限约 2^36 us
+    static constexpr int kBucketCount = kLinearBuckets + kOctaves * kSubBuckets;
+    
+    static int bucketFor(qint64 usecs);
+    static qint64 bucketUpperBound(int bucket);  // 微秒
+
+private:
+    std::array<quint32, kBucketCount> m_buckets{};
+    quint64 m_count = 0;
+    qint64 m_max = 0;
+};
+
+// 按动作统计请求各阶段耗时（线程安全）
+class LatencyStats
+{
+public:
+    enum Stage {
+        Serialize,      // 编码 + 压缩
+        Send,           // 提交到写入 socket
+        Wait,           // 写入 socket 到收到响应
+        Handler,        // 后端处理器耗时（响应中的 handler_us）
+        Network,        // 等待时间扣除后端处理时间
+        Parse,          // 解压 + 解码
+        StageCount
+    };
+    
+    struct Summary {
+        QString action;
+        quint64 count = 0;                     // 完成的请求数
+        std::array<qint64, StageCount> p50{};  // 纳秒
+        std::array<qint64, StageCount> p99{};
+        std::array<qint64, StageCount> max{};
+    };
+
+    void record(const QString& action, Stage stage, qint64 nsecs);
+    QList<Summary> snapshot() const;
+    void reset();
+    
+    static QString stageName(Stage stage);
+
+private:
+    mutable QMutex m_mutex;
+    QHash<QString, std::array<LatencyHistogram, StageCount>> m_actions;
+};
+
+#endif // LATENCYSTATS_H
@@ -0,0 +1,148 @@
+#include "network/ResponseCache.h"
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+ResponseCache::ResponseCache(qsizetype maxBytes)
+    : m_entries(maxBytes)
+    , m_generation(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+{
+}
+
+void ResponseCache::setTtl(const QString& action, int ttlMs)
+{
+    QMutexLocker locker(&m_mutex);
+    if (ttlMs > 0) {
+        m_ttls.insert(action, ttlMs);
+    } else {
+        m_ttls.remove(action);
+    }
+}
+
+void ResponseCache::setMaxBytes(qsizetype maxBytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.setMaxCost(maxBytes);
+}
+
+bool ResponseCache::isCacheable(const QString& action) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_ttls.contains(action);
+}
+
+bool ResponseCache::lookup(const QString& action, const QJsonObject& params, QJsonObject* response)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_ttls.contains(action)) {
+        return false;
+    }
+    
+    QString key = makeKey(action, params);
+    Entry* entry = m_entries.object(key);
+    if (entry && entry->expiry.hasExpired()) {
+        m_entries.remove(key);
+        ++m_evictions;
+        entry = nullptr;
+    }
+    
+    if (!entry) {
+        ++m_misses;
+        return false;
+    }
+    
+    ++m_hits;
+    *response = entry->response;
+    return true;
+}
+
+void ResponseCache::insert(const QString& action, const QJsonObject& params,
+                           const QJsonObject& response, quint64 generation)
+{
+    // 只缓存成功响应
+    if (response["status"].toString() != "success") {
+        return;
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    auto ttl = m_ttls.constFind(action);
+    if (ttl == m_ttls.cend() || generation != m_generation) {
+        return;
+    }
+    
+    qsizetype cost = QJsonDocument(response).toJson(QJsonDocument::Compact).size();
+    Entry* entry = new Entry{action, response, QDeadlineTimer(ttl.value())};
+    
+    // 超过上限的单条响应 QCache 会直接丢弃（并删除 entry）
+    m_entries.insert(makeKey(action, params), entry, cost);
+}
+
+quint64 ResponseCache::generation() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_generation;
+}
+
+void ResponseCache::invalidate(const QString& action)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+    
+    const QString prefix = action + '\n';
+    const QList<QString> keys = m_entries.keys();
+    for (const QString& key : keys) {
+        if (key.startsWith(prefix)) {
+            m_entries.remove(key);
+            ++m_evictions;
+        }
+    }
+}
+
+void ResponseCache::invalidateAll()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+    m_evictions += m_entries.size();
+    m_entries.clear();
+}
+
+void ResponseCache::handleNotification(const QString& type, const QJsonObject& data)
+{
+    // {"type": "cache.invalidate", "data": {"actions": [...]}} 或 {"all": true}
+    if (type != "cache.invalidate") {
+        return;
+    }
+    
+    if (data["all"].toBool()) {
+        invalidateAll();
+        return;
+    }
+    
+    const QJsonArray actions = data["actions"].toArray();
+    for (const QJsonValue& action : actions) {
+        invalidate(action.toString());
+    }
+}
+
+ResponseCache::Stats ResponseCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.entries = m_entries.size();
+    stats.bytes = m_entries.totalCost();
+    return stats;
+}
+
+QString ResponseCache::makeKey(const QString& action, const QJsonObject& params)
+{
+    // QJsonObject 的键有序，紧凑序列化即为规范形式
+    QByteArray canonical = QJsonDocument(params).toJson(QJsonDocument::Compact);
+    QByteArray hash = QCryptographicHash::hash(canonical, QCryptographicHash::Sha1).toHex();
+    return action + '\n' + QString::fromLatin1(hash);
+}
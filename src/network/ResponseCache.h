@@ -0,0 +1,65 @@
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QDeadlineTimer>
+
+// 只读请求的响应缓存
+// 键为 action + 参数规范化后的哈希；只缓存设置了 TTL 的动作，
+// 按估算字节数做 LRU 淘汰，后端发布 cache.invalidate 通知时失效
+class ResponseCache
+{
+public:
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 evictions = 0;     // 过期或失效移除的条目
+        qsizetype entries = 0;
+        qsizetype bytes = 0;
+        
+        double hitRate() const { return hits + misses ? double(hits) / double(hits + misses) : 0.0; }
+    };
+
+    explicit ResponseCache(qsizetype maxBytes = 32 * 1024 * 1024);
+    
+    // 配置
+    void setTtl(const QString& action, int ttlMs);
+    void setMaxBytes(qsizetype maxBytes);
+    bool isCacheable(const QString& action) const;
+    
+    // 查询与写入；generation 用于丢弃请求在途期间被失效的响应
+    bool lookup(const QString& action, const QJsonObject& params, QJsonObject* response);
+    void insert(const QString& action, const QJsonObject& params, const QJsonObject& response, quint64 generation);
+    quint64 generation() const;
+    
+    // 失效
+    void invalidate(const QString& action);
+    void invalidateAll();
+    void handleNotification(const QString& type, const QJsonObject& data);
+    
+    Stats stats() const;
+
+private:
+    struct Entry {
+        QString action;
+        QJsonObject response;
+        QDeadlineTimer expiry;
+    };
+    
+    static QString makeKey(const QString& action, const QJsonObject& params);
+
+private:
+    mutable QMutex m_mutex;
+    QCache<QString, Entry> m_entries;          // cost 为响应的估算字节数
+    QHash<QString, int> m_ttls;
+    quint64 m_generation;
+    quint64 m_hits;
+    quint64 m_misses;
+    quint64 m_evictions;
+};
+
+#endif // RESPONSECACHE_H
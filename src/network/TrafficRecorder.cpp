@@ -0,0 +1,137 @@
+#include "network/TrafficRecorder.h"
+#include "core/Logger.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QtEndian>
+#include <cstring>
+
+// ==================== TrafficRecorder Implementation ====================
+
+TrafficRecorder::~TrafficRecorder()
+{
+    stop();
+}
+
+bool TrafficRecorder::start(const QString& path)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_file.isOpen()) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        Logger::instance()->error("Failed to open traffic log: " + path);
+        return false;
+    }
+
+    char header[kHeaderSize];
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    qToLittleEndian<quint64>(quint64(QDateTime::currentMSecsSinceEpoch()), header + 8);
+    m_file.write(header, kHeaderSize);
+
+    m_buffer.reserve(kFlushBytes + 64 * 1024);
+    m_clock.start();
+    m_recording = true;
+
+    Logger::instance()->info("Recording traffic to: " + path);
+    return true;
+}
+
+void TrafficRecorder::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_recording = false;
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    flushLocked();
+    m_file.close();
+    Logger::instance()->info("Traffic recording stopped: " + m_file.fileName());
+}
+
+void TrafficRecorder::record(Kind kind, int lane, QByteArrayView key, const void* data, size_t size)
+{
+    if (!isRecording()) {
+        return;
+    }
+
+    const qsizetype keySize = qMin<qsizetype>(key.size(), 0xFFFF);
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_file.isOpen()) {
+        return;  // 检查与加锁之间已停止
+    }
+
+    char header[kRecordHeaderSize];
+    header[0] = char(kind);
+    header[1] = char(lane);
+    qToLittleEndian<quint16>(quint16(keySize), header + 2);
+    qToLittleEndian<quint32>(quint32(size), header + 4);
+    qToLittleEndian<quint64>(quint64(m_clock.nsecsElapsed()), header + 8);
+
+    m_buffer.append(header, kRecordHeaderSize);
+    m_buffer.append(key.data(), keySize);
+    m_buffer.append(static_cast<const char*>(data), qsizetype(size));
+
+    if (m_buffer.size() >= kFlushBytes) {
+        flushLocked();
+    }
+}
+
+void TrafficRecorder::flushLocked()
+{
+    if (!m_buffer.isEmpty()) {
+        m_file.write(m_buffer);
+        m_buffer.clear();  // clear 保留容量
+    }
+}
+
+// ==================== TrafficLogReader Implementation ====================
+
+bool TrafficLogReader::open(const QString& path)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    QByteArray header = m_file.read(TrafficRecorder::kHeaderSize);
+    if (header.size() != TrafficRecorder::kHeaderSize
+        || std::memcmp(header.constData(), TrafficRecorder::kMagic, sizeof(TrafficRecorder::kMagic)) != 0) {
+        m_error = "Not a traffic log";
+        m_file.close();
+        return false;
+    }
+
+    m_startedAt = qint64(qFromLittleEndian<quint64>(header.constData() + 8));
+    return true;
+}
+
+bool TrafficLogReader::next(TrafficRecorder::Record* record)
+{
+    char header[TrafficRecorder::kRecordHeaderSize];
+    if (m_file.read(header, sizeof(header)) != qint64(sizeof(header))) {
+        return false;
+    }
+
+    const quint16 keySize = qFromLittleEndian<quint16>(header + 2);
+    const quint32 payloadSize = qFromLittleEndian<quint32>(header + 4);
+
+    record->kind = TrafficRecorder::Kind(quint8(header[0]));
+    record->lane = quint8(header[1]);
+    record->offsetNsecs = qint64(qFromLittleEndian<quint64>(header + 8));
+    record->key = m_file.read(keySize);
+    record->payload = m_file.read(payloadSize);
+
+    // 录制被中断时最后一条记录可能不完整
+    if (record->key.size() != keySize || record->payload.size() != qsizetype(payloadSize)) {
+        m_error = "Truncated record";
+        return false;
+    }
+    return true;
+}
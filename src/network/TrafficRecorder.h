@@ -0,0 +1,82 @@
+#ifndef TRAFFICRECORDER_H
+#define TRAFFICRECORDER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+
+// 流量录制：把请求、响应与通知的原始线上字节（编码、压缩后）连同时间戳写入二进制日志，
+// 供 traffic_replay 按原始节奏（或加速）重放到后端
+//
+// 文件格式（小端）：
+//   文件头 16 字节：magic "FATRC01\0" + 录制开始时间（uint64，毫秒时间戳）
+//   记录：kind(u8) lane(u8) keyLen(u16) payloadLen(u32) offset(u64，相对开始的纳秒) key payload
+//   key 对请求 / 响应为 msg_id，对通知为主题
+class TrafficRecorder
+{
+public:
+    enum Kind : quint8 {
+        Request = 1,
+        Reply = 2,
+        Notification = 3
+    };
+
+    struct Record {
+        Kind kind = Request;
+        quint8 lane = 0;
+        qint64 offsetNsecs = 0;
+        QByteArray key;
+        QByteArray payload;
+    };
+
+    static constexpr char kMagic[8] = {'F', 'A', 'T', 'R', 'C', '0', '1', '\0'};
+    static constexpr int kHeaderSize = 16;
+    static constexpr int kRecordHeaderSize = 16;
+
+    TrafficRecorder() = default;
+    ~TrafficRecorder();
+
+    // 开始 / 停止录制（任意线程可调用）
+    bool start(const QString& path);
+    void stop();
+    bool isRecording() const { return m_recording.load(std::memory_order_relaxed); }
+
+    // 追加一条记录；未录制时直接返回（I/O 线程热路径上只有一次原子读）
+    void record(Kind kind, int lane, QByteArrayView key, const void* data, size_t size);
+
+private:
+    void flushLocked();
+
+    // 缓冲区超过该大小时写入文件
+    static constexpr qsizetype kFlushBytes = 1 << 20;
+
+    std::atomic<bool> m_recording{false};
+    QMutex m_mutex;
+    QFile m_file;
+    QByteArray m_buffer;
+    QElapsedTimer m_clock;
+};
+
+// 流量日志读取（重放工具使用）
+class TrafficLogReader
+{
+public:
+    bool open(const QString& path);
+    QString errorString() const { return m_error; }
+
+    qint64 startedAtMsecs() const { return m_startedAt; }
+
+    // 读取下一条记录，到达文件末尾或记录损坏时返回 false
+    bool next(TrafficRecorder::Record* record);
+
+private:
+    QFile m_file;
+    QString m_error;
+    qint64 m_startedAt = 0;
+};
+
+#endif // TRAFFICRECORDER_H
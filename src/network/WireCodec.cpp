@@ -0,0 +1,81 @@
+#include "network/WireCodec.h"
+#include "network/Compression.h"
+#include <QJsonDocument>
+#include <QCborValue>
+#include <QCborMap>
+
+QByteArray WireCodec::encode(const QJsonObject& message, Encoding encoding)
+{
+    if (encoding == Cbor) {
+        return QCborMap::fromJsonObject(message).toCborValue().toCbor();
+    }
+    return QJsonDocument(message).toJson(QJsonDocument::Compact);
+}
+
+QJsonObject WireCodec::decode(const QByteArray& data)
+{
+    return decode(data.constData(), data.size());
+}
+
+QJsonObject WireCodec::decode(const char* data, qsizetype size)
+{
+    // 压缩帧先解压
+    if (Compression::isCompressed(data, size)) {
+        QByteArray raw = Compression::decompress(data, size);
+        return raw.isEmpty() ? QJsonObject() : decode(raw.constData(), raw.size());
+    }
+    
+    // fromRawData 不复制底层缓冲区
+    QByteArray raw = QByteArray::fromRawData(data, size);
+    
+    if (detect(data, size) == Cbor) {
+        QCborParserError error;
+        QCborValue value = QCborValue::fromCbor(raw, &error);
+        if (error.error != QCborError::NoError || !value.isMap()) {
+            return QJsonObject();
+        }
+        return value.toMap().toJsonObject();
+    }
+    
+    return QJsonDocument::fromJson(raw).object();
+}
+
+WireCodec::Encoding WireCodec::detect(const char* data, qsizetype size)
+{
+    if (size <= 0) {
+        return Json;
+    }
+    
+    // CBOR map 的主类型为 5（0xA0-0xBF），JSON 对象以 '{' 开头
+    unsigned char first = static_cast<unsigned char>(data[0]);
+    if ((first & 0xE0) == 0xA0) {
+        return Cbor;
+    }
+    return Json;
+}
+
+QString WireCodec::encodingName(Encoding encoding)
+{
+    switch (encoding) {
+        case Cbor: return "cbor";
+        case Json:
+        default:   return "json";
+    }
+}
+
+WireCodec::Encoding WireCodec::encodingFromName(const QString& name, Encoding fallback)
+{
+    if (name == "cbor") {
+        return Cbor;
+    }
+    if (name == "json") {
+        return Json;
+    }
+    return fallback;
+}
+
+QStringList WireCodec::supportedEncodings()
+{
+    // 按优先级排列
+    return QStringList{"cbor", "json"};
+}
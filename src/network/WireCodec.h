@@ -0,0 +1,31 @@
+#ifndef WIRECODEC_H
+#define WIRECODEC_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+// 消息编解码（JSON / CBOR）
+// 解码时根据首字节自动识别编码（以及压缩帧），因此双方可以在任意时刻切换编码
+class WireCodec
+{
+public:
+    enum Encoding {
+        Json,
+        Cbor
+    };
+
+    static QByteArray encode(const QJsonObject& message, Encoding encoding);
+    static QJsonObject decode(const QByteArray& data);
+    static QJsonObject decode(const char* data, qsizetype size);
+    
+    static Encoding detect(const char* data, qsizetype size);
+    
+    // 协商用名称（"json" / "cbor"）
+    static QString encodingName(Encoding encoding);
+    static Encoding encodingFromName(const QString& name, Encoding fallback = Json);
+    static QStringList supportedEncodings();
+};
+
+#endif // WIRECODEC_H
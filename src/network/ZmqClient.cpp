@@ -1,17 +1,105 @@
 #include "network/ZmqClient.h"
 #include "core/Logger.h"
+#include "core/Tracing.h"
 #include <QUuid>
 #include <QDateTime>
 #include <QThread>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QFileInfo>
+#include <zmq_addon.hpp>
+#include <chrono>
+#include <iterator>
+
+namespace {
+
+QFuture<QJsonObject> readyResponse(const QJsonObject& response)
+{
+    QPromise<QJsonObject> promise;
+    promise.start();
+    promise.addResult(response);
+    promise.finish();
+    return promise.future();
+}
+
+QJsonObject cancelledResponse()
+{
+    return QJsonObject{
+        {"status", "error"},
+        {"message", "Request cancelled"},
+        {"cancelled", true}
+    };
+}
+
+} // namespace
+
+// ==================== ZmqCancelToken Implementation ====================
+
+ZmqCancelToken::ZmqCancelToken()
+    : m_state(std::make_shared<State>())
+{
+}
+
+void ZmqCancelToken::cancel()
+{
+    QHash<quint64, std::function<void()>> callbacks;
+    {
+        QMutexLocker locker(&m_state->mutex);
+        if (m_state->cancelled) {
+            return;
+        }
+        m_state->cancelled = true;
+        callbacks.swap(m_state->callbacks);
+    }
+    
+    // 在锁外调用，回调可能完成请求并触发注销
+    for (const auto& callback : std::as_const(callbacks)) {
+        callback();
+    }
+}
+
+bool ZmqCancelToken::isCancelled() const
+{
+    QMutexLocker locker(&m_state->mutex);
+    return m_state->cancelled;
+}
+
+quint64 ZmqCancelToken::onCancel(std::function<void()> callback) const
+{
+    {
+        QMutexLocker locker(&m_state->mutex);
+        if (!m_state->cancelled) {
+            quint64 id = ++m_state->nextId;
+            m_state->callbacks.insert(id, std::move(callback));
+            return id;
+        }
+    }
+    
+    callback();
+    return 0;
+}
+
+void ZmqCancelToken::removeCallback(quint64 id) const
+{
+    QMutexLocker locker(&m_state->mutex);
+    m_state->callbacks.remove(id);
+}
 
 // ==================== ZmqClient Implementation ====================
 
 ZmqClient::ZmqClient(QObject *parent)
     : QObject(parent)
     , m_context(std::make_unique<zmq::context_t>(1))
+    , m_requestThreads{}
     , m_receiveThread(nullptr)
     , m_connected(false)
+    , m_encoding(WireCodec::Json)
+    , m_preferredCompression(Compression::Zlib)
+    , m_compression(Compression::None)
+    , m_compressionLevel(3)
+    , m_compressionThreshold(4096)
 {
+    qRegisterMetaType<ZmqMessagePtr>("ZmqMessagePtr");
 }
 
 ZmqClient::~ZmqClient()
@@ -19,27 +107,43 @@ ZmqClient::~ZmqClient()
     disconnect();
 }
 
-bool ZmqClient::connectToServer(const QString& reqEndpoint, const QString& subEndpoint)
+bool ZmqClient::connectToServer(const QString& reqEndpoint, const QString& subEndpoint,
+                                const QString& bulkEndpoint)
 {
+    // 退出登录后重新登录会再次连接：先停止旧的请求 / 订阅线程，否则它们继续运行且信号被重复连接
+    if (m_connected) {
+        disconnect();
+    }
+
     try {
         m_reqEndpoint = reqEndpoint;
         m_subEndpoint = subEndpoint;
+        m_bulkEndpoint = bulkEndpoint.isEmpty() ? reqEndpoint : bulkEndpoint;
         
         Logger::instance()->info("Connecting to ZeroMQ server...");
         Logger::instance()->info("REQ endpoint: " + reqEndpoint);
+        Logger::instance()->info("BULK endpoint: " + m_bulkEndpoint);
         Logger::instance()->info("SUB endpoint: " + subEndpoint);
         
-        // 创建REQ socket（用于请求-响应）
-        m_reqSocket = std::make_unique<zmq::socket_t>(*m_context, zmq::socket_type::req);
-        m_reqSocket->connect(reqEndpoint.toStdString());
-        
-        // 设置接收超时
-        int timeout = 30000; // 30秒
-        m_reqSocket->set(zmq::sockopt::rcvtimeo, timeout);
-        m_reqSocket->set(zmq::sockopt::sndtimeo, timeout);
+        // 每个通道一个请求线程（DEALER socket，用于请求-响应）
+        const QString endpoints[LaneCount] = {reqEndpoint, m_bulkEndpoint};
+        for (int lane = 0; lane < LaneCount; ++lane) {
+            m_requestThreads[lane] = new ZmqRequestThread(m_context.get(), endpoints[lane], lane,
+                                                          &m_compressionStats, &m_latencyStats,
+                                                          &m_trafficRecorder, this);
+            connect(m_requestThreads[lane], &ZmqRequestThread::errorOccurred,
+                    this, &ZmqClient::errorOccurred);
+            m_requestThreads[lane]->start();
+        }
         
-        // 创建订阅线程
-        m_receiveThread = new ZmqReceiveThread(subEndpoint, this);
+        // 创建订阅线程，连接前登记的订阅随即生效
+        {
+            QMutexLocker locker(&m_topicMutex);
+            m_receiveThread = new ZmqReceiveThread(m_context.get(), subEndpoint, &m_trafficRecorder, this);
+            for (auto it = m_topics.cbegin(); it != m_topics.cend(); ++it) {
+                m_receiveThread->subscribe(it.key());
+            }
+        }
         connect(m_receiveThread, &ZmqReceiveThread::messageReceived,
                 this, &ZmqClient::onNotificationMessage);
         m_receiveThread->start();
@@ -47,6 +151,9 @@ bool ZmqClient::connectToServer(const QString& reqEndpoint, const QString& subEn
         m_connected = true;
         emit connected();
         
+        // 协商二进制编码，完成前使用 JSON
+        negotiateEncoding();
+        
         Logger::instance()->info("ZeroMQ client connected successfully");
         return true;
         
@@ -54,6 +161,15 @@ bool ZmqClient::connectToServer(const QString& reqEndpoint, const QString& subEn
         QString error = QString("ZeroMQ connect error: %1").arg(e.what());
         Logger::instance()->error(error);
         emit errorOccurred(error);
+        {
+            QMutexLocker locker(&m_topicMutex);
+            delete m_receiveThread;
+            m_receiveThread = nullptr;
+        }
+        for (ZmqRequestThread*& thread : m_requestThreads) {
+            delete thread;
+            thread = nullptr;
+        }
         m_connected = false;
         return false;
     }
@@ -67,21 +183,32 @@ void ZmqClient::disconnect()
     
     Logger::instance()->info("Disconnecting from ZeroMQ server...");
     
-    // 停止接收线程
-    if (m_receiveThread) {
-        m_receiveThread->stop();
-        m_receiveThread->wait(3000);
-        delete m_receiveThread;
-        m_receiveThread = nullptr;
+    // 停止接收线程（订阅记录保留，重新连接时恢复）
+    {
+        QMutexLocker locker(&m_topicMutex);
+        if (m_receiveThread) {
+            m_receiveThread->stop();
+            m_receiveThread->wait(3000);
+            delete m_receiveThread;
+            m_receiveThread = nullptr;
+        }
     }
     
-    // 关闭REQ socket
-    if (m_reqSocket) {
-        m_reqSocket->close();
-        m_reqSocket.reset();
+    // 停止请求线程（未完成的请求会以错误结束）
+    for (ZmqRequestThread*& thread : m_requestThreads) {
+        if (thread) {
+            thread->stop();
+            thread->wait(3000);
+            delete thread;
+            thread = nullptr;
+        }
     }
     
     m_connected = false;
+    m_encoding = WireCodec::Json;
+    m_compression = Compression::None;
+    logCacheStats();
+    m_compressionStats.logSummary();
     emit disconnected();
     
     Logger::instance()->info("ZeroMQ client disconnected");
@@ -89,85 +216,308 @@ void ZmqClient::disconnect()
 
 QJsonObject ZmqClient::request(const QString& action, const QJsonObject& params, int timeout)
 {
-    if (!m_connected) {
-        return QJsonObject{
+    QFuture<QJsonObject> future = requestAsync(action, params, timeout);
+    future.waitForFinished();
+    
+    QJsonObject response = future.result();
+    LOG_DEBUG("Received response: %1", response["status"].toString());
+    
+    return response;
+}
+
+QFuture<QJsonObject> ZmqClient::requestAsync(const QString& action, const QJsonObject& params, int timeout,
+                                             const ZmqCancelToken& token)
+{
+    ZmqRequestThread* thread = m_requestThreads[laneFor(action)];
+    if (!m_connected || !thread) {
+        return readyResponse(QJsonObject{
             {"status", "error"},
             {"message", "Not connected to server"}
-        };
+        });
     }
     
-    try {
-        // 1. 构建请求
-        QJsonObject request = buildRequest(action, params);
-        QJsonDocument doc(request);
-        QString jsonStr = doc.toJson(QJsonDocument::Compact);
-        
-        Logger::instance()->debug("Sending request: " + action);
-        
-        // 2. 发送请求
-        zmq::message_t requestMsg(jsonStr.toStdString());
-        auto sendResult = m_reqSocket->send(requestMsg, zmq::send_flags::none);
+    // 命中缓存则不访问后端；批量结果是只读一次的文件，不缓存
+    const bool cacheable = m_cache.isCacheable(action) && !params.contains("bulk_dir");
+    if (cacheable) {
+        QJsonObject cached;
+        bool hit = m_cache.lookup(action, params, &cached);
         
-        if (!sendResult.has_value()) {
-            Logger::instance()->error("Failed to send request");
-            return QJsonObject{{"status", "error"}, {"message", "Failed to send request"}};
+        ResponseCache::Stats stats = m_cache.stats();
+        if ((stats.hits + stats.misses) % 100 == 0) {
+            logCacheStats();
         }
         
-        // 3. 接收响应
-        zmq::message_t replyMsg;
-        
-        // 临时设置超时
-        m_reqSocket->set(zmq::sockopt::rcvtimeo, timeout);
-        
-        auto recvResult = m_reqSocket->recv(replyMsg, zmq::recv_flags::none);
-        
-        if (!recvResult.has_value()) {
-            Logger::instance()->warning("Request timeout: " + action);
-            return QJsonObject{{"status", "error"}, {"message", "Request timeout"}};
+        if (hit) {
+            LOG_DEBUG("Cache hit: %1", action);
+            return readyResponse(cached);
         }
-        
-        // 4. 解析响应
-        std::string replyStr = replyMsg.to_string();
-        QJsonObject response = parseResponse(replyStr);
-        
-        Logger::instance()->debug("Received response: " + response["status"].toString());
-        
+    }
+    
+    // 构建请求（msg_id 用于匹配响应）
+    TraceSpan span("ZmqClient::requestAsync", "client");
+    span.setArg("action", action);
+    QJsonObject request = buildRequest(action, params);
+    QByteArray payload = encodeRequest(request, action);
+    
+    LOG_DEBUG("Sending request: %1", action);
+    
+    // 在发送前记下代数，在途期间（包括响应很快到达时）发生失效的响应不写入缓存
+    const quint64 generation = m_cache.generation();
+    QFuture<QJsonObject> future = submitRequest(thread, request, payload, timeout, token);
+    if (!cacheable) {
+        return future;
+    }
+    
+    return future.then([this, action, params, generation](const QJsonObject& response) {
+        if (response["cancelled"].toBool()) {
+            return response;
+        }
+        m_cache.insert(action, params, response, generation);
         return response;
-        
-    } catch (const zmq::error_t& e) {
-        QString error = QString("Request error: %1").arg(e.what());
-        Logger::instance()->error(error);
-        emit errorOccurred(error);
-        return QJsonObject{{"status", "error"}, {"message", error}};
+    });
+}
+
+QFuture<QJsonObject> ZmqClient::requestStream(const QString& action, const QJsonObject& params,
+                                              QObject* context, ZmqChunkHandler onChunk, int timeout,
+                                              const ZmqCancelToken& token)
+{
+    ZmqRequestThread* thread = m_requestThreads[laneFor(action)];
+    if (!m_connected || !thread) {
+        return requestAsync(action, params, timeout, token);
     }
+    
+    // stream 标记告诉后端按分块发送结果；stream_window 让后端按分块确认限制未消费的分块数
+    QJsonObject request = buildRequest(action, params);
+    request["stream"] = true;
+    request["stream_window"] = ZmqRequestThread::kStreamWindow;
+    QByteArray payload = encodeRequest(request, action);
+    
+    LOG_DEBUG("Sending stream request: %1", action);
+    
+    return submitRequest(thread, request, payload, timeout, token, context, std::move(onChunk));
+}
+
+QFuture<QJsonObject> ZmqClient::submitRequest(ZmqRequestThread* thread, const QJsonObject& request,
+                                              const QByteArray& payload, int timeout, const ZmqCancelToken& token,
+                                              QObject* context, ZmqChunkHandler onChunk)
+{
+    if (token.isCancelled()) {
+        return readyResponse(cancelledResponse());
+    }
+    
+    const QString msgId = request["msg_id"].toString();
+    QFuture<QJsonObject> future = thread->submit(msgId, request["action"].toString(), payload, timeout,
+                                                 context, std::move(onChunk), request["trace_id"].toString());
+    
+    // 请求完成后注销回调，长期持有的令牌不会累积已完成的请求
+    QPointer<ZmqRequestThread> target(thread);
+    const quint64 callbackId = token.onCancel([target, msgId]() {
+        if (target) {
+            target->cancel(msgId);
+        }
+    });
+    return future.then([this, token, callbackId](const QJsonObject& response) {
+        token.removeCallback(callbackId);
+        // 写操作的响应带失效列表：在调用方拿到结果之前失效，不依赖随后才到达的通知
+        if (response.contains("invalidates")) {
+            applyInvalidation(QJsonObject{{"actions", response["invalidates"]}});
+        }
+        return response;
+    });
+}
+
+void ZmqClient::setLane(const QString& action, Lane lane)
+{
+    m_lanes.insert(action, lane);
+}
+
+void ZmqClient::setBulkDirectory(const QString& path)
+{
+    const QString directory = QDir(path).absolutePath();
+    if (directory == m_bulkDirectory) {
+        return;  // 重连时重复设置：目录中可能有仍在读取的结果文件
+    }
+    m_bulkDirectory = directory;
+    QDir dir(m_bulkDirectory);
+    dir.mkpath(".");
+    
+    // 首次使用该目录时清理上次运行遗留的结果文件（崩溃或未读取的响应）
+    const QStringList stale = dir.entryList(QStringList{"*.col", "*.col.tmp"}, QDir::Files);
+    for (const QString& name : stale) {
+        dir.remove(name);
+    }
+}
+
+QFuture<QJsonObject> ZmqClient::requestBulk(const QString& action, const QJsonObject& params, int timeout,
+                                            const ZmqCancelToken& token)
+{
+    if (m_bulkDirectory.isEmpty()) {
+        return requestAsync(action, params, timeout, token);
+    }
+    
+    QJsonObject bulkParams = params;
+    bulkParams["bulk_dir"] = m_bulkDirectory;
+    
+    const QString directory = m_bulkDirectory;
+    return requestAsync(action, bulkParams, timeout, token).then([directory](const QJsonObject& response) {
+        // 只接受 bulk 目录下的文件；目录外的路径不可信，只记录不做任何文件操作
+        QJsonObject bulk = response["data"].toObject()["bulk"].toObject();
+        if (!bulk.isEmpty()) {
+            QString path = QDir::cleanPath(QDir::fromNativeSeparators(bulk["path"].toString()));
+            const QFileInfo info(path);
+            if (info.absolutePath() != directory && info.canonicalPath() != QDir(directory).canonicalPath()) {
+                Logger::instance()->warning("Rejected bulk result outside bulk directory: " + path);
+                return QJsonObject{
+                    {"status", "error"},
+                    {"message", "Invalid bulk result path"}
+                };
+            }
+        }
+        return response;
+    });
+}
+
+QFuture<QJsonArray> ZmqClient::requestBatch(const QList<QPair<QString, QJsonObject>>& requests, int timeout,
+                                            const ZmqCancelToken& token)
+{
+    QJsonArray items;
+    for (const auto& request : requests) {
+        items.append(QJsonObject{
+            {"action", request.first},
+            {"params", request.second}
+        });
+    }
+    
+    const qsizetype count = items.size();
+    return requestAsync("batch", QJsonObject{{"requests", items}}, timeout, token)
+        .then([this, count](const QJsonObject& response) {
+            QJsonArray results = response["data"].toObject()["results"].toArray();
+            if (response["status"].toString() == "success" && results.size() == count) {
+                for (const QJsonValue& result : results) {
+                    const QJsonObject item = result.toObject();
+                    if (item.contains("invalidates")) {
+                        applyInvalidation(QJsonObject{{"actions", item["invalidates"]}});
+                    }
+                }
+                return results;
+            }
+            
+            // 整个批次失败（超时、断开等）时每一项都返回该错误
+            QJsonObject error{
+                {"status", "error"},
+                {"message", response["message"].toString()}
+            };
+            QJsonArray failed;
+            for (qsizetype i = 0; i < count; ++i) {
+                failed.append(error);
+            }
+            return failed;
+        });
 }
 
 void ZmqClient::subscribe(const QString& topic)
 {
+    QMutexLocker locker(&m_topicMutex);
+    if (m_topics[topic]++ > 0) {
+        return;  // 已订阅（如同一任务打开了多个工作区）
+    }
     if (m_receiveThread) {
         m_receiveThread->subscribe(topic);
-        Logger::instance()->info("Subscribed to topic: " + (topic.isEmpty() ? "ALL" : topic));
     }
+    Logger::instance()->info("Subscribed to topic: " + (topic.isEmpty() ? "ALL" : topic));
+}
+
+void ZmqClient::unsubscribe(const QString& topic)
+{
+    QMutexLocker locker(&m_topicMutex);
+    auto it = m_topics.find(topic);
+    if (it == m_topics.end() || --it.value() > 0) {
+        return;
+    }
+    m_topics.erase(it);
+    if (m_receiveThread) {
+        m_receiveThread->unsubscribe(topic);
+    }
+    Logger::instance()->info("Unsubscribed from topic: " + (topic.isEmpty() ? "ALL" : topic));
 }
 
-void ZmqClient::onNotificationMessage(const QString& message)
+void ZmqClient::onNotificationMessage(const QString& topic, ZmqMessagePtr message)
 {
     try {
-        QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
-        if (!doc.isObject()) {
+        // 直接从 zmq 消息缓冲区解析，不经过 std::string / QString 中转
+        QJsonObject notification = WireCodec::decode(static_cast<const char*>(message->data()),
+                                                      qsizetype(message->size()));
+        if (notification.isEmpty()) {
             return;
         }
         
-        QJsonObject notification = doc.object();
         QString type = notification["type"].toString();
         QJsonObject data = notification["data"].toObject();
         
-        Logger::instance()->debug("Received notification: " + type);
-        emit notificationReceived(type, data);
+        LOG_DEBUG("Received notification: %1 (%2)", type, topic);
+        if (type == "cache.invalidate") {
+            applyInvalidation(data);
+        }
+        emit notificationReceived(type, data, topic);
         
     } catch (...) {
-        Logger::instance()->error("Failed to parse notification message");
+        LOG_ERROR("Failed to parse notification message");
+    }
+}
+
+void ZmqClient::applyInvalidation(const QJsonObject& data)
+{
+    // {"actions": [...]} 或 {"all": true}；同一失效可能由响应和通知各触发一次，重复失效无副作用
+    m_cache.handleNotification("cache.invalidate", data);
+    
+    QStringList actions;
+    if (!data["all"].toBool()) {
+        for (const QJsonValue& action : data["actions"].toArray()) {
+            actions.append(action.toString());
+        }
     }
+    emit cacheInvalidated(actions);
+}
+
+void ZmqClient::logCacheStats()
+{
+    ResponseCache::Stats stats = m_cache.stats();
+    Logger::instance()->info(QString("Response cache: hits=%1 misses=%2 hit rate=%3% entries=%4 size=%5 KB")
+                                 .arg(stats.hits)
+                                 .arg(stats.misses)
+                                 .arg(stats.hitRate() * 100.0, 0, 'f', 1)
+                                 .arg(stats.entries)
+                                 .arg(stats.bytes / 1024));
+}
+
+void ZmqClient::setCompression(Compression::Algorithm algorithm, int level, int thresholdBytes)
+{
+    m_preferredCompression = algorithm;
+    m_compressionLevel = level;
+    m_compressionThreshold = thresholdBytes;
+}
+
+void ZmqClient::negotiateEncoding()
+{
+    // 后端返回双方都支持的首选编码；旧版后端不认识该动作时保持 JSON、不压缩
+    QJsonObject params;
+    params["encodings"] = QJsonArray::fromStringList(WireCodec::supportedEncodings());
+    
+    // 配置的算法优先，其余本端支持的算法作为备选
+    if (m_preferredCompression != Compression::None) {
+        QStringList algorithms = Compression::supportedAlgorithms();
+        algorithms.removeAll(Compression::algorithmName(m_preferredCompression));
+        algorithms.prepend(Compression::algorithmName(m_preferredCompression));
+        params["compression"] = QJsonArray::fromStringList(algorithms);
+    }
+    
+    requestAsync("session.hello", params, 5000).then(this, [this](const QJsonObject& response) {
+        QJsonObject data = response["data"].toObject();
+        m_encoding = WireCodec::encodingFromName(data["encoding"].toString(), WireCodec::Json);
+        m_compression = Compression::algorithmFromName(data["compression"].toString(), Compression::None);
+        Logger::instance()->info("Wire encoding: " + WireCodec::encodingName(m_encoding)
+                                 + ", compression: " + Compression::algorithmName(m_compression));
+    });
 }
 
 QString ZmqClient::generateMessageId()
@@ -184,83 +534,733 @@ QJsonObject ZmqClient::buildRequest(const QString& action, const QJsonObject& pa
     request["params"] = params;
     request["user_id"] = "current_user";  // 从Application获取
     
+    // 在追踪的操作内发出的请求带上 trace_id，后端据此记录并带回处理区间
+    const QString traceId = Tracing::currentTraceId();
+    if (!traceId.isEmpty()) {
+        request["trace_id"] = traceId;
+    }
+    
     return request;
 }
 
-QJsonObject ZmqClient::parseResponse(const std::string& response)
+QByteArray ZmqClient::encodeRequest(QJsonObject& request, const QString& action)
+{
+    // compress 字段告诉后端响应可以用该算法压缩
+    const Compression::Algorithm algorithm = m_compression;
+    if (algorithm != Compression::None) {
+        request["compress"] = Compression::algorithmName(algorithm);
+    }
+    
+    TraceSpan span("serialize", "client");
+    QElapsedTimer serializeTimer;
+    serializeTimer.start();
+    
+    QByteArray payload = WireCodec::encode(request, m_encoding);
+    if (algorithm != Compression::None && payload.size() >= m_compressionThreshold) {
+        QElapsedTimer timer;
+        timer.start();
+        QByteArray compressed = Compression::compress(payload, algorithm, m_compressionLevel);
+        qint64 nsecs = timer.nsecsElapsed();
+        
+        // 压缩失败或没有变小时发送原始消息
+        const bool smaller = !compressed.isEmpty() && compressed.size() < payload.size();
+        m_compressionStats.record(action, CompressionStats::Compress, payload.size(),
+                                  smaller ? compressed.size() : payload.size(), nsecs);
+        if (smaller) {
+            payload = compressed;
+        }
+    }
+    
+    m_latencyStats.record(action, LatencyStats::Serialize, serializeTimer.nsecsElapsed());
+    return payload;
+}
+
+// ==================== ZmqRequestThread Implementation ====================
+
+ZmqRequestThread::ZmqRequestThread(zmq::context_t* context, const QString& endpoint, int lane,
+                                   CompressionStats* compressionStats, LatencyStats* latencyStats,
+                                   TrafficRecorder* recorder, QObject *parent)
+    : QThread(parent)
+    , m_context(context)
+    , m_endpoint(endpoint)
+    , m_lane(lane)
+    , m_compressionStats(compressionStats)
+    , m_latencyStats(latencyStats)
+    , m_recorder(recorder)
+    , m_controlEndpoint(QString("inproc://zmq-request-%1")
+                            .arg(reinterpret_cast<quintptr>(this), 0, 16).toStdString())
+    , m_running(true)
+{
+    // PUSH 端在调用方线程使用；inproc 允许先 connect 后 bind
+    m_controlSocket = std::make_unique<zmq::socket_t>(*m_context, zmq::socket_type::push);
+    m_controlSocket->set(zmq::sockopt::linger, 0);
+    m_controlSocket->connect(m_controlEndpoint);
+}
+
+ZmqRequestThread::~ZmqRequestThread()
+{
+    stop();
+    wait();
+    
+    QMutexLocker locker(&m_submitMutex);
+    if (m_controlSocket) {
+        m_controlSocket->close();
+        m_controlSocket.reset();
+    }
+}
+
+QFuture<QJsonObject> ZmqRequestThread::submit(const QString& msgId, const QString& action,
+                                               const QByteArray& payload, int timeout,
+                                               QObject* context, ZmqChunkHandler onChunk,
+                                               const QString& traceId)
+{
+    auto promise = std::make_shared<QPromise<QJsonObject>>();
+    promise->start();
+    QFuture<QJsonObject> future = promise->future();
+    
+    // 先登记再发送，保证响应到达时一定能找到对应的请求
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        PendingRequest pending;
+        pending.action = action;
+        pending.timeout = timeout;
+        pending.deadline = QDeadlineTimer(timeout);
+        pending.promise = promise;
+        pending.context = context;
+        pending.onChunk = std::move(onChunk);
+        pending.timer.start();
+        if (!traceId.isEmpty() && Tracing::isEnabled()) {
+            pending.traceId = traceId;
+            pending.submitUs = Tracing::nowUs();
+        }
+        m_pending.insert(msgId, pending);
+    }
+    
+    try {
+        QMutexLocker locker(&m_submitMutex);
+        QByteArray id = msgId.toUtf8();
+        m_controlSocket->send(zmq::str_buffer("R"), zmq::send_flags::sndmore);
+        m_controlSocket->send(zmq::buffer(id.constData(), id.size()), zmq::send_flags::sndmore);
+        m_controlSocket->send(zmq::buffer(payload.constData(), payload.size()), zmq::send_flags::none);
+    } catch (const zmq::error_t& e) {
+        QString error = QString("Request error: %1").arg(e.what());
+        Logger::instance()->error(error);
+        finishRequest(msgId, QJsonObject{{"status", "error"}, {"message", error}});
+    }
+    
+    return future;
+}
+
+void ZmqRequestThread::cancel(const QString& msgId)
+{
+    // 经控制通道交给 I/O 线程，保证排在该请求的发送之后
+    try {
+        QMutexLocker locker(&m_submitMutex);
+        if (m_controlSocket) {
+            QByteArray id = msgId.toUtf8();
+            m_controlSocket->send(zmq::str_buffer("C"), zmq::send_flags::sndmore);
+            m_controlSocket->send(zmq::buffer(id.constData(), id.size()), zmq::send_flags::none);
+        }
+    } catch (const zmq::error_t& e) {
+        Logger::instance()->error(QString("Cancel error: %1").arg(e.what()));
+    }
+}
+
+void ZmqRequestThread::ackChunk(const QString& msgId, qint64 seq)
+{
+    // 与 cancel 相同经控制通道交给 I/O 线程发送
+    try {
+        QMutexLocker locker(&m_submitMutex);
+        if (m_controlSocket) {
+            QByteArray id = msgId.toUtf8();
+            QByteArray number = QByteArray::number(seq);
+            m_controlSocket->send(zmq::str_buffer("A"), zmq::send_flags::sndmore);
+            m_controlSocket->send(zmq::buffer(id.constData(), id.size()), zmq::send_flags::sndmore);
+            m_controlSocket->send(zmq::buffer(number.constData(), number.size()), zmq::send_flags::none);
+        }
+    } catch (const zmq::error_t& e) {
+        Logger::instance()->error(QString("Stream ack error: %1").arg(e.what()));
+    }
+}
+
+void ZmqRequestThread::stop()
+{
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    
+    // 发送空帧唤醒 I/O 线程
+    try {
+        QMutexLocker locker(&m_submitMutex);
+        if (m_controlSocket) {
+            m_controlSocket->send(zmq::message_t(), zmq::send_flags::dontwait);
+        }
+    } catch (const zmq::error_t&) {
+    }
+}
+
+void ZmqRequestThread::run()
 {
-    QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(response));
-    return doc.object();
+    try {
+        zmq::socket_t dealer(*m_context, zmq::socket_type::dealer);
+        dealer.set(zmq::sockopt::linger, 0);
+        dealer.connect(m_endpoint.toStdString());
+        
+        zmq::socket_t control(*m_context, zmq::socket_type::pull);
+        control.set(zmq::sockopt::linger, 0);
+        control.bind(m_controlEndpoint);
+        
+        Logger::instance()->info("ZeroMQ request thread started");
+        
+        while (m_running) {
+            // 流式响应的反压由后端按分块确认控制，这里始终读取响应，慢消费者不影响其他请求
+            zmq::pollitem_t items[] = {
+                { dealer.handle(), 0, ZMQ_POLLIN, 0 },
+                { control.handle(), 0, ZMQ_POLLIN, 0 }
+            };
+            zmq::poll(items, 2, std::chrono::milliseconds(nextTimeout()));
+            
+            if (items[1].revents & ZMQ_POLLIN) {
+                if (!forwardRequests(control, dealer)) {
+                    break;
+                }
+            }
+            if (items[0].revents & ZMQ_POLLIN) {
+                handleReply(dealer);
+            }
+            expireRequests();
+        }
+        
+        dealer.close();
+        control.close();
+        Logger::instance()->info("ZeroMQ request thread stopped");
+        
+    } catch (const zmq::error_t& e) {
+        QString error = QString("Request thread error: %1").arg(e.what());
+        Logger::instance()->error(error);
+        emit errorOccurred(error);
+    }
+    
+    failAllPending("Client disconnected");
+}
+
+bool ZmqRequestThread::forwardRequests(zmq::socket_t& control, zmq::socket_t& dealer)
+{
+    // 一次唤醒尽量转发所有排队的请求与取消命令
+    while (true) {
+        zmq::message_t command;
+        if (!control.recv(command, zmq::recv_flags::dontwait)) {
+            return true;
+        }
+        if (command.size() == 0 && !command.more()) {
+            return false;  // 停止命令
+        }
+        
+        zmq::message_t idMsg;
+        control.recv(idMsg, zmq::recv_flags::none);
+        QString msgId = QString::fromUtf8(static_cast<const char*>(idMsg.data()), int(idMsg.size()));
+        
+        const char type = *static_cast<const char*>(command.data());
+        if (type == 'C') {
+            cancelRequest(dealer, msgId);
+            continue;
+        }
+        if (type == 'A') {
+            zmq::message_t seq;
+            control.recv(seq, zmq::recv_flags::none);
+            sendAck(dealer, msgId, QByteArray(seq.data<char>(), int(seq.size())).toLongLong());
+            continue;
+        }
+        
+        zmq::message_t payload;
+        control.recv(payload, zmq::recv_flags::none);
+        if (m_recorder) {
+            m_recorder->record(TrafficRecorder::Request, m_lane, QByteArrayView(idMsg.data<char>(), idMsg.size()),
+                               payload.data(), payload.size());
+        }
+        
+        // 空分隔帧保持与 REP/ROUTER 信封兼容
+        auto sent = dealer.send(zmq::message_t(), zmq::send_flags::sndmore | zmq::send_flags::dontwait);
+        if (sent) {
+            sent = dealer.send(payload, zmq::send_flags::dontwait);
+        }
+        if (sent) {
+            markSent(msgId);
+        } else {
+            LOG_ERROR("Failed to send request");
+            finishRequest(msgId, QJsonObject{{"status", "error"}, {"message", "Failed to send request"}});
+        }
+    }
+}
+
+void ZmqRequestThread::cancelRequest(zmq::socket_t& dealer, const QString& msgId)
+{
+    // 已完成（或已超时）的请求无需通知后端
+    const QString action = pendingAction(msgId);
+    if (action.isEmpty()) {
+        return;
+    }
+    
+    // cancel 控制消息以 msg_id 指明目标请求，后端不回复；取消消息很小，固定用 JSON 编码
+    QByteArray message = WireCodec::encode(QJsonObject{
+        {"action", "cancel"},
+        {"msg_id", msgId}
+    }, WireCodec::Json);
+    if (m_recorder) {
+        m_recorder->record(TrafficRecorder::Request, m_lane, msgId.toUtf8(), message.constData(), message.size());
+    }
+    auto sent = dealer.send(zmq::message_t(), zmq::send_flags::sndmore | zmq::send_flags::dontwait);
+    if (sent) {
+        sent = dealer.send(zmq::buffer(message.constData(), message.size()), zmq::send_flags::dontwait);
+    }
+    if (!sent) {
+        LOG_WARNING("Failed to send cancel for: %1", action);
+    }
+    
+    // 后端随后返回的响应（若有）按未知请求丢弃
+    LOG_INFO("Request cancelled: %1", action);
+    finishRequest(msgId, cancelledResponse());
+}
+
+void ZmqRequestThread::sendAck(zmq::socket_t& dealer, const QString& msgId, qint64 seq)
+{
+    // 已完成、取消或超时的流后端已经停止发送，无需确认
+    if (pendingAction(msgId).isEmpty()) {
+        return;
+    }
+    
+    // stream.ack 与 cancel 一样以 msg_id 指明目标请求，后端不回复
+    QByteArray message = WireCodec::encode(QJsonObject{
+        {"action", "stream.ack"},
+        {"msg_id", msgId},
+        {"seq", seq}
+    }, WireCodec::Json);
+    auto sent = dealer.send(zmq::message_t(), zmq::send_flags::sndmore | zmq::send_flags::dontwait);
+    if (sent) {
+        sent = dealer.send(zmq::buffer(message.constData(), message.size()), zmq::send_flags::dontwait);
+    }
+    if (!sent) {
+        LOG_WARNING("Failed to send stream ack: %1", msgId);
+    }
+}
+
+void ZmqRequestThread::handleReply(zmq::socket_t& dealer)
+{
+    while (true) {
+        std::vector<zmq::message_t> frames;
+        auto result = zmq::recv_multipart(dealer, std::back_inserter(frames), zmq::recv_flags::dontwait);
+        if (!result) {
+            return;
+        }
+        if (frames.empty()) {
+            continue;
+        }
+        
+        // 最后一帧为响应正文（前面是空分隔帧）
+        const zmq::message_t& body = frames.back();
+        const char* data = static_cast<const char*>(body.data());
+        qsizetype size = qsizetype(body.size());
+        
+        // 压缩的响应先解压，并按动作记录压缩比与耗时
+        QElapsedTimer parseTimer;
+        parseTimer.start();
+        QByteArray raw;
+        qint64 decompressNsecs = -1;
+        if (Compression::isCompressed(data, size)) {
+            QElapsedTimer timer;
+            timer.start();
+            raw = Compression::decompress(data, size);
+            decompressNsecs = timer.nsecsElapsed();
+            data = raw.constData();
+            size = raw.size();
+        }
+        
+        QJsonObject response = WireCodec::decode(data, size);
+        QString msgId = response["msg_id"].toString();
+        const qint64 parseNsecs = parseTimer.nsecsElapsed();
+        
+        if (m_recorder) {
+            m_recorder->record(TrafficRecorder::Reply, m_lane, msgId.toUtf8(), body.data(), body.size());
+        }
+        
+        if (decompressNsecs >= 0 && m_compressionStats) {
+            m_compressionStats->record(pendingAction(msgId), CompressionStats::Decompress,
+                                       raw.size(), qsizetype(body.size()), decompressNsecs);
+        }
+        
+        // 流式响应：中间分块交给消费者，结束标记完成请求
+        QJsonObject stream = response["stream"].toObject();
+        if (!stream.isEmpty() && !stream["final"].toBool()) {
+            deliverChunk(msgId, response);
+            continue;
+        }
+        
+        recordLatency(msgId, response, parseNsecs);
+        recordTrace(msgId, response, parseNsecs);
+        finishRequest(msgId, response);
+    }
+}
+
+void ZmqRequestThread::deliverChunk(const QString& msgId, const QJsonObject& response)
+{
+    ZmqChunkHandler onChunk;
+    QPointer<QObject> context;
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        auto it = m_pending.find(msgId);
+        if (it == m_pending.end()) {
+            return;
+        }
+        // 每收到一个分块就重新计算超时
+        it->deadline = QDeadlineTimer(it->timeout);
+        onChunk = it->onChunk;
+        context = it->context;
+    }
+    
+    const qint64 seq = response["stream"].toObject()["seq"].toInteger();
+    if (!onChunk || !context) {
+        ackChunk(msgId, seq);  // 没有消费者，直接确认，后端不必等待
+        return;
+    }
+    
+    // 回调执行完（或回调对象被销毁、投递事件被丢弃）时 ticket 析构，确认该分块
+    struct ChunkTicket {
+        ChunkTicket(ZmqRequestThread* t, const QString& id, qint64 s) : thread(t), msgId(id), seq(s) {}
+        ~ChunkTicket() { if (thread) thread->ackChunk(msgId, seq); }
+        QPointer<ZmqRequestThread> thread;
+        QString msgId;
+        qint64 seq;
+    };
+    auto ticket = std::make_shared<ChunkTicket>(this, msgId, seq);
+    QJsonObject chunk = response["data"].toObject();
+    
+    QMetaObject::invokeMethod(context.data(), [onChunk, chunk, ticket]() {
+        onChunk(chunk);
+    }, Qt::QueuedConnection);
+}
+
+void ZmqRequestThread::finishRequest(const QString& msgId, const QJsonObject& response)
+{
+    PendingRequest pending;
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        auto it = m_pending.find(msgId);
+        if (it == m_pending.end()) {
+            LOG_DEBUG("Dropping late or unknown response: %1", msgId);
+            return;
+        }
+        pending = it.value();
+        m_pending.erase(it);
+    }
+    
+    pending.promise->addResult(response);
+    pending.promise->finish();
+}
+
+void ZmqRequestThread::expireRequests()
+{
+    QList<QPair<QString, QString>> expired;  // msg_id, action
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it) {
+            if (it.value().deadline.hasExpired()) {
+                expired.append(qMakePair(it.key(), it.value().action));
+            }
+        }
+    }
+    
+    for (const auto& request : expired) {
+        LOG_WARNING("Request timeout: %1", request.second);
+        finishRequest(request.first, QJsonObject{{"status", "error"}, {"message", "Request timeout"}});
+    }
+}
+
+void ZmqRequestThread::failAllPending(const QString& message)
+{
+    QHash<QString, PendingRequest> pending;
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        pending.swap(m_pending);
+    }
+    
+    for (const PendingRequest& request : std::as_const(pending)) {
+        request.promise->addResult(QJsonObject{{"status", "error"}, {"message", message}});
+        request.promise->finish();
+    }
+}
+
+QString ZmqRequestThread::pendingAction(const QString& msgId)
+{
+    QMutexLocker locker(&m_pendingMutex);
+    auto it = m_pending.constFind(msgId);
+    return it != m_pending.cend() ? it->action : QString();
+}
+
+void ZmqRequestThread::markSent(const QString& msgId)
+{
+    QString action;
+    qint64 sendNsecs = 0;
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        auto it = m_pending.find(msgId);
+        if (it == m_pending.end()) {
+            return;
+        }
+        it->sentNsecs = it->timer.nsecsElapsed();
+        action = it->action;
+        sendNsecs = it->sentNsecs;
+    }
+    
+    if (m_latencyStats) {
+        m_latencyStats->record(action, LatencyStats::Send, sendNsecs);
+    }
+}
+
+void ZmqRequestThread::recordLatency(const QString& msgId, const QJsonObject& response, qint64 parseNsecs)
+{
+    if (!m_latencyStats) {
+        return;
+    }
+    
+    QString action;
+    qint64 waitNsecs = 0;
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        auto it = m_pending.constFind(msgId);
+        if (it == m_pending.cend() || it->sentNsecs < 0) {
+            return;
+        }
+        action = it->action;
+        waitNsecs = it->timer.nsecsElapsed() - it->sentNsecs - parseNsecs;
+    }
+    
+    m_latencyStats->record(action, LatencyStats::Wait, waitNsecs);
+    m_latencyStats->record(action, LatencyStats::Parse, parseNsecs);
+    
+    // 后端在响应中带回处理器耗时，等待时间的其余部分记为网络（含排队）
+    if (response.contains("handler_us")) {
+        qint64 handlerNsecs = response["handler_us"].toInteger() * 1000;
+        m_latencyStats->record(action, LatencyStats::Handler, handlerNsecs);
+        m_latencyStats->record(action, LatencyStats::Network, qMax<qint64>(waitNsecs - handlerNsecs, 0));
+    }
+}
+
+void ZmqRequestThread::recordTrace(const QString& msgId, QJsonObject& response, qint64 parseNsecs)
+{
+    // 后端区间只在导出追踪时有用，不交给调用方
+    const QJsonObject trace = response.take("trace").toObject();
+    
+    QString action;
+    QString traceId;
+    qint64 submitUs = 0;
+    qint64 sentUs = -1;
+    qint64 elapsedUs = 0;
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        auto it = m_pending.constFind(msgId);
+        if (it == m_pending.cend() || it->traceId.isEmpty()) {
+            return;
+        }
+        action = it->action;
+        traceId = it->traceId;
+        submitUs = it->submitUs;
+        sentUs = it->sentNsecs >= 0 ? submitUs + it->sentNsecs / 1000 : -1;
+        elapsedUs = it->timer.nsecsElapsed() / 1000;
+    }
+    
+    // 以提交时刻为起点，用请求自身的计时器换算各阶段的时间点
+    const qint64 endUs = submitUs + elapsedUs;
+    const qint64 parseStartUs = endUs - parseNsecs / 1000;
+    const QJsonObject args{{"action", action}, {"msg_id", msgId}};
+    Tracing::record(QString("request:%1").arg(action), "client", submitUs, endUs, traceId, args);
+    if (sentUs >= 0) {
+        Tracing::record("send", "client", submitUs, sentUs, traceId, args);
+        Tracing::record("wait", "client", sentUs, parseStartUs, traceId, args);
+    }
+    Tracing::record("parse", "client", parseStartUs, endUs, traceId, args);
+    
+    if (!trace.isEmpty()) {
+        Tracing::addRemoteSpans(trace);
+    }
+}
+
+int ZmqRequestThread::nextTimeout()
+{
+    // 无在途请求时无限等待，否则等到最近的截止时间
+    QMutexLocker locker(&m_pendingMutex);
+    qint64 timeout = -1;
+    for (const PendingRequest& request : std::as_const(m_pending)) {
+        qint64 remaining = request.deadline.remainingTime();
+        if (timeout < 0 || remaining < timeout) {
+            timeout = remaining;
+        }
+    }
+    return int(timeout);
 }
 
 // ==================== ZmqReceiveThread Implementation ====================
 
-ZmqReceiveThread::ZmqReceiveThread(const QString& endpoint, QObject *parent)
+ZmqReceiveThread::ZmqReceiveThread(zmq::context_t* context, const QString& endpoint, TrafficRecorder* recorder,
+                                   QObject *parent)
     : QThread(parent)
+    , m_context(context)
     , m_endpoint(endpoint)
-    , m_context(std::make_unique<zmq::context_t>(1))
-    , m_running(false)
+    , m_recorder(recorder)
+    , m_controlEndpoint(QString("inproc://zmq-receive-%1")
+                            .arg(reinterpret_cast<quintptr>(this), 0, 16).toStdString())
+    , m_running(true)
 {
+    // 线程启动前发出的命令在 inproc 队列中等待 bind
+    m_controlSocket = std::make_unique<zmq::socket_t>(*m_context, zmq::socket_type::push);
+    m_controlSocket->set(zmq::sockopt::linger, 0);
+    m_controlSocket->connect(m_controlEndpoint);
 }
 
 ZmqReceiveThread::~ZmqReceiveThread()
 {
     stop();
+    wait();
+    
+    QMutexLocker locker(&m_controlMutex);
+    if (m_controlSocket) {
+        m_controlSocket->close();
+        m_controlSocket.reset();
+    }
 }
 
 void ZmqReceiveThread::stop()
 {
-    m_running = false;
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    
+    // 发送空帧唤醒接收线程
+    try {
+        QMutexLocker locker(&m_controlMutex);
+        if (m_controlSocket) {
+            m_controlSocket->send(zmq::message_t(), zmq::send_flags::dontwait);
+        }
+    } catch (const zmq::error_t&) {
+    }
 }
 
 void ZmqReceiveThread::subscribe(const QString& topic)
 {
-    m_topics.append(topic);
+    sendCommand('S', topic);
+}
+
+void ZmqReceiveThread::unsubscribe(const QString& topic)
+{
+    sendCommand('U', topic);
+}
+
+void ZmqReceiveThread::sendCommand(char command, const QString& topic)
+{
+    // 命令帧：[命令字][主题]
+    try {
+        QMutexLocker locker(&m_controlMutex);
+        QByteArray data = topic.toUtf8();
+        m_controlSocket->send(zmq::buffer(&command, 1), zmq::send_flags::sndmore);
+        m_controlSocket->send(zmq::buffer(data.constData(), data.size()), zmq::send_flags::none);
+    } catch (const zmq::error_t& e) {
+        Logger::instance()->warning(QString("Subscription command failed: %1").arg(e.what()));
+    }
 }
 
 void ZmqReceiveThread::run()
 {
     try {
-        // 创建SUB socket
-        m_subSocket = std::make_unique<zmq::socket_t>(*m_context, zmq::socket_type::sub);
-        m_subSocket->connect(m_endpoint.toStdString());
+        zmq::socket_t sub(*m_context, zmq::socket_type::sub);
+        sub.set(zmq::sockopt::linger, 0);
+        sub.connect(m_endpoint.toStdString());
         
-        // 订阅主题
-        if (m_topics.isEmpty()) {
-            m_subSocket->set(zmq::sockopt::subscribe, "");  // 订阅所有
-        } else {
-            for (const QString& topic : m_topics) {
-                m_subSocket->set(zmq::sockopt::subscribe, topic.toStdString());
-            }
-        }
+        zmq::socket_t control(*m_context, zmq::socket_type::pull);
+        control.set(zmq::sockopt::linger, 0);
+        control.bind(m_controlEndpoint);
         
-        // 设置接收超时（用于定期检查m_running）
-        m_subSocket->set(zmq::sockopt::rcvtimeo, 1000);
+        QSet<QString> topics;  // 已生效的订阅（SUB 订阅按次数计数，这里去重），也用于精确匹配
         
         Logger::instance()->info("ZeroMQ receive thread started");
-        m_running = true;
         
         while (m_running) {
-            try {
-                zmq::message_t msg;
-                auto result = m_subSocket->recv(msg, zmq::recv_flags::none);
-                
-                if (result.has_value()) {
-                    std::string msgStr = msg.to_string();
-                    emit messageReceived(QString::fromStdString(msgStr));
+            zmq::pollitem_t items[] = {
+                { sub.handle(), 0, ZMQ_POLLIN, 0 },
+                { control.handle(), 0, ZMQ_POLLIN, 0 }
+            };
+            zmq::poll(items, 2, std::chrono::milliseconds(-1));
+            
+            if (items[1].revents & ZMQ_POLLIN) {
+                if (!handleCommands(control, sub, topics)) {
+                    break;
                 }
-                
-            } catch (const zmq::error_t& e) {
-                if (e.num() != EAGAIN) {  // EAGAIN 是超时，正常
-                    Logger::instance()->warning(QString("Receive error: %1").arg(e.what()));
+            }
+            
+            if (items[0].revents & ZMQ_POLLIN) {
+                // 一次唤醒取完所有已到达的通知：[主题帧][正文帧]
+                while (true) {
+                    zmq::message_t topicMsg;
+                    if (!sub.recv(topicMsg, zmq::recv_flags::dontwait)) {
+                        break;
+                    }
+                    if (!topicMsg.more()) {
+                        continue;  // 不完整的通知
+                    }
+                    auto msg = std::make_shared<zmq::message_t>();
+                    sub.recv(*msg, zmq::recv_flags::none);
+                    for (bool more = msg->more(); more; ) {
+                        zmq::message_t extra;  // 忽略多余的帧
+                        sub.recv(extra, zmq::recv_flags::none);
+                        more = extra.more();
+                    }
+                    
+                    // SUB 按前缀过滤，这里再按主题精确匹配（task:1 不应收到 task:12）
+                    QString topic = QString::fromUtf8(static_cast<const char*>(topicMsg.data()),
+                                                      int(topicMsg.size()));
+                    if (!topics.contains(topic) && !topics.contains(QString())) {
+                        continue;
+                    }
+                    if (m_recorder) {
+                        m_recorder->record(TrafficRecorder::Notification, 0,
+                                           QByteArrayView(topicMsg.data<char>(), topicMsg.size()),
+                                           msg->data(), msg->size());
+                    }
+                    emit messageReceived(topic, std::move(msg));
                 }
             }
         }
         
-        m_subSocket->close();
+        sub.close();
+        control.close();
         Logger::instance()->info("ZeroMQ receive thread stopped");
         
     } catch (const zmq::error_t& e) {
         Logger::instance()->error(QString("Receive thread error: %1").arg(e.what()));
     }
 }
+
+bool ZmqReceiveThread::handleCommands(zmq::socket_t& control, zmq::socket_t& sub, QSet<QString>& topics)
+{
+    while (true) {
+        zmq::message_t command;
+        if (!control.recv(command, zmq::recv_flags::dontwait)) {
+            return true;
+        }
+        if (command.size() == 0 && !command.more()) {
+            return false;  // 停止命令
+        }
+        
+        zmq::message_t topicMsg;
+        control.recv(topicMsg, zmq::recv_flags::none);
+        QString topic = QString::fromUtf8(static_cast<const char*>(topicMsg.data()), int(topicMsg.size()));
+        std::string filter = topic.toStdString();
+        
+        if (*static_cast<const char*>(command.data()) == 'S') {
+            if (!topics.contains(topic)) {
+                sub.set(zmq::sockopt::subscribe, filter);
+                topics.insert(topic);
+            }
+        } else if (topics.remove(topic)) {
+            sub.set(zmq::sockopt::unsubscribe, filter);
+        }
+    }
+}
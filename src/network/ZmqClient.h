@@ -6,35 +6,148 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QString>
+#include <QStringList>
 #include <QThread>
+#include <QFuture>
+#include <QPromise>
+#include <QMutex>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QPair>
+#include <QDeadlineTimer>
+#include <QPointer>
+#include <QElapsedTimer>
+#include "network/WireCodec.h"
+#include "network/ResponseCache.h"
+#include "network/Compression.h"
+#include "network/LatencyStats.h"
+#include "network/TrafficRecorder.h"
 #include <zmq.hpp>
 #include <memory>
+#include <atomic>
+#include <functional>
 
 class ZmqReceiveThread;
+class ZmqRequestThread;
+
+// 流式响应的分块回调（参数为分块的 data 字段）
+using ZmqChunkHandler = std::function<void(const QJsonObject& chunk)>;
+
+// 跨线程传递的原始消息（共享所有权，不复制消息缓冲区）
+using ZmqMessagePtr = std::shared_ptr<const zmq::message_t>;
+Q_DECLARE_METATYPE(ZmqMessagePtr)
+
+// 请求取消令牌：副本共享同一状态，cancel() 后用该令牌发出的在途请求立即以
+// "Request cancelled" 错误完成（cancelled 字段为 true），并通知后端停止处理
+// 典型用法：任务工作区持有一个令牌，关闭工作区或发起新查询时取消上一批请求
+class ZmqCancelToken
+{
+public:
+    ZmqCancelToken();
+    
+    void cancel();
+    bool isCancelled() const;
+
+private:
+    friend class ZmqClient;
+    
+    // 登记取消回调（已取消时立即调用），返回的编号用于请求完成后注销
+    quint64 onCancel(std::function<void()> callback) const;
+    void removeCallback(quint64 id) const;
+    
+    struct State {
+        QMutex mutex;
+        bool cancelled = false;
+        quint64 nextId = 0;
+        QHash<quint64, std::function<void()>> callbacks;
+    };
+    std::shared_ptr<State> m_state;
+};
 
 class ZmqClient : public QObject
 {
     Q_OBJECT
 
 public:
+    // 请求通道：每个通道有独立的 DEALER socket 与发送队列，后端为其分配独立的 worker，
+    // 批量导入等耗时请求走 Bulk 通道，不会阻塞界面发起的交互请求
+    enum Lane {
+        Interactive,
+        Bulk,
+        LaneCount
+    };
+
     explicit ZmqClient(QObject *parent = nullptr);
     ~ZmqClient();
     
-    // 连接到服务器
-    bool connectToServer(const QString& reqEndpoint, const QString& subEndpoint);
+    // 连接到服务器（bulkEndpoint 为空时 Bulk 通道连接 reqEndpoint，仍使用独立的 socket 与队列）；已连接时先断开再重连
+    bool connectToServer(const QString& reqEndpoint, const QString& subEndpoint,
+                         const QString& bulkEndpoint = QString());
     void disconnect();
     
     bool isConnected() const { return m_connected; }
     
-    // 同步请求（REQ-REP模式）
+    // 当前协商的消息编码（协商完成前为 JSON）
+    WireCodec::Encoding encoding() const { return m_encoding; }
+    
+    // 大消息压缩：连接前设置，连接时与后端协商算法（后端不支持时退回 zlib 或不压缩）
+    // 超过 thresholdBytes 的请求按协商的算法压缩，后端对超过其阈值的响应同样压缩
+    void setCompression(Compression::Algorithm algorithm, int level, int thresholdBytes);
+    Compression::Algorithm compression() const { return m_compression; }
+    
+    // 动作所属通道，连接前设置；未设置的动作走 Interactive 通道
+    void setLane(const QString& action, Lane lane);
+    Lane laneFor(const QString& action) const { return m_lanes.value(action, Interactive); }
+    
+    // 按动作统计的各阶段耗时（p50 / p99 / max）
+    LatencyStats* latencyStats() { return &m_latencyStats; }
+    
+    // 响应缓存（按动作配置 TTL，写操作的响应或后端 cache.invalidate 通知到达时失效；批量结果不缓存）
+    ResponseCache* responseCache() { return &m_cache; }
+    
+    // 流量录制：请求、响应与通知的原始字节写入二进制日志，可用 traffic_replay 重放
+    TrafficRecorder* trafficRecorder() { return &m_trafficRecorder; }
+    
+    // 同步请求（阻塞等待，内部复用异步通道）
     QJsonObject request(const QString& action, const QJsonObject& params, int timeout = 30000);
     
-    // 订阅主题
-    void subscribe(const QString& topic = "");
+    // 异步请求（DEALER模式，可同时有多个请求在途）
+    // 返回的 QFuture 总会得到一个响应对象，超时/断开/取消时 status 为 "error"
+    QFuture<QJsonObject> requestAsync(const QString& action, const QJsonObject& params, int timeout = 30000,
+                                      const ZmqCancelToken& token = ZmqCancelToken());
+    
+    // 流式请求：每个分块到达后在 context 所在线程调用 onChunk，
+    // future 在收到结束标记后完成；timeout 为相邻分块之间的最长间隔
+    QFuture<QJsonObject> requestStream(const QString& action, const QJsonObject& params,
+                                       QObject* context, ZmqChunkHandler onChunk, int timeout = 30000,
+                                       const ZmqCancelToken& token = ZmqCancelToken());
+    
+    // 批量结果请求：后端把结果写成列式文件放在 bulk 目录下，响应 data.bulk 只带句柄
+    // （path / rows / size / columns），用 ColumnarFile 映射读取；未设置目录时等同 requestAsync
+    void setBulkDirectory(const QString& path);
+    QFuture<QJsonObject> requestBulk(const QString& action, const QJsonObject& params, int timeout = 30000,
+                                     const ZmqCancelToken& token = ZmqCancelToken());
+    
+    // 批量请求：多个动作打包为一次往返，结果按提交顺序返回，每项带独立 status
+    QFuture<QJsonArray> requestBatch(const QList<QPair<QString, QJsonObject>>& requests, int timeout = 30000,
+                                     const ZmqCancelToken& token = ZmqCancelToken());
+    
+    // 通知主题：全局通知（缓存失效、系统消息）与单个任务的通知（进度等）
+    static QString globalTopic() { return QStringLiteral("global"); }
+    static QString taskTopic(const QString& taskId) { return QStringLiteral("task:") + taskId; }
+    
+    // 订阅/取消订阅主题（任意线程可调用，按次数计数，最后一次取消才真正退订）
+    // 连接前的订阅在连接时生效；后端 XPUB 据此只发送有订阅者的主题
+    void subscribe(const QString& topic);
+    void unsubscribe(const QString& topic);
     
 signals:
     // 收到通知信号
-    void notificationReceived(const QString& type, const QJsonObject& data);
+    void notificationReceived(const QString& type, const QJsonObject& data, const QString& topic);
+    
+    // 缓存失效（写操作的响应或 cache.invalidate 通知，任意线程发出）；actions 为空表示全部
+    void cacheInvalidated(const QStringList& actions);
     
     // 连接状态变化
     void connected();
@@ -44,48 +157,156 @@ signals:
     void errorOccurred(const QString& error);
 
 private slots:
-    void onNotificationMessage(const QString& message);
+    void onNotificationMessage(const QString& topic, ZmqMessagePtr message);
 
 private:
     QString generateMessageId();
     QJsonObject buildRequest(const QString& action, const QJsonObject& params);
-    QJsonObject parseResponse(const std::string& response);
+    QByteArray encodeRequest(QJsonObject& request, const QString& action);
+    QFuture<QJsonObject> submitRequest(ZmqRequestThread* thread, const QJsonObject& request,
+                                       const QByteArray& payload, int timeout, const ZmqCancelToken& token,
+                                       QObject* context = nullptr, ZmqChunkHandler onChunk = {});
+    void negotiateEncoding();
+    void applyInvalidation(const QJsonObject& data);
+    void logCacheStats();
     
 private:
     std::unique_ptr<zmq::context_t> m_context;
-    std::unique_ptr<zmq::socket_t> m_reqSocket;    // REQ socket
     
-    ZmqReceiveThread* m_receiveThread;
+    ZmqRequestThread* m_requestThreads[LaneCount]; // 每个通道一个 DEALER I/O 线程
+    ZmqReceiveThread* m_receiveThread;             // SUB I/O 线程
     
     QString m_reqEndpoint;
     QString m_subEndpoint;
+    QString m_bulkEndpoint;
+    QHash<QString, Lane> m_lanes;
     bool m_connected;
+    std::atomic<WireCodec::Encoding> m_encoding;
+    ResponseCache m_cache;
+    
+    Compression::Algorithm m_preferredCompression;
+    std::atomic<Compression::Algorithm> m_compression;  // 协商结果，完成前不压缩
+    int m_compressionLevel;
+    int m_compressionThreshold;
+    CompressionStats m_compressionStats;
+    LatencyStats m_latencyStats;
+    TrafficRecorder m_trafficRecorder;
+    
+    QString m_bulkDirectory;
+    
+    QMutex m_topicMutex;                           // 保护 m_topics 与接收线程指针
+    QHash<QString, int> m_topics;                  // 主题 -> 订阅次数
+};
+
+// ZeroMQ 请求线程（持有 DEALER socket，按 msg_id 匹配响应）
+class ZmqRequestThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    ZmqRequestThread(zmq::context_t* context, const QString& endpoint, int lane,
+                     CompressionStats* compressionStats, LatencyStats* latencyStats,
+                     TrafficRecorder* recorder, QObject *parent = nullptr);
+    ~ZmqRequestThread();
+    
+    // 提交请求（任意线程可调用），返回的 future 在收到响应或超时后完成
+    // 提供 onChunk 时按流式响应处理
+    QFuture<QJsonObject> submit(const QString& msgId, const QString& action,
+                                const QByteArray& payload, int timeout,
+                                QObject* context = nullptr, ZmqChunkHandler onChunk = {},
+                                const QString& traceId = QString());
+    
+    // 取消在途请求（任意线程可调用）：请求以取消错误完成，并向后端发送 cancel 控制消息
+    void cancel(const QString& msgId);
+    // 确认流式请求的第 seq 个分块已消费（任意线程可调用），后端据此发送后续分块
+    void ackChunk(const QString& msgId, qint64 seq);
+    void stop();
+    
+    // 流式请求允许的已发送未确认分块数，慢消费者只暂停自己的流，I/O 线程始终读取 socket
+    static constexpr int kStreamWindow = 8;
+
+signals:
+    void errorOccurred(const QString& error);
+
+protected:
+    void run() override;
+
+private:
+    struct PendingRequest {
+        QString action;
+        int timeout = 0;
+        QDeadlineTimer deadline;
+        std::shared_ptr<QPromise<QJsonObject>> promise;
+        QPointer<QObject> context;                 // 分块回调所在对象
+        ZmqChunkHandler onChunk;
+        QElapsedTimer timer;                       // 提交时启动
+        qint64 sentNsecs = -1;                     // 写入 socket 的时刻
+        QString traceId;                           // 非空时记录追踪区间
+        qint64 submitUs = 0;                       // 提交时刻（Tracing::nowUs）
+    };
+    
+    void handleReply(zmq::socket_t& dealer);
+    void deliverChunk(const QString& msgId, const QJsonObject& response);
+    bool forwardRequests(zmq::socket_t& control, zmq::socket_t& dealer);
+    void cancelRequest(zmq::socket_t& dealer, const QString& msgId);
+    void sendAck(zmq::socket_t& dealer, const QString& msgId, qint64 seq);
+    void finishRequest(const QString& msgId, const QJsonObject& response);
+    void expireRequests();
+    void failAllPending(const QString& message);
+    int nextTimeout();
+    QString pendingAction(const QString& msgId);
+    void markSent(const QString& msgId);
+    void recordLatency(const QString& msgId, const QJsonObject& response, qint64 parseNsecs);
+    void recordTrace(const QString& msgId, QJsonObject& response, qint64 parseNsecs);
+
+private:
+    zmq::context_t* m_context;
+    QString m_endpoint;
+    int m_lane;
+    CompressionStats* m_compressionStats;
+    LatencyStats* m_latencyStats;
+    TrafficRecorder* m_recorder;
+    std::string m_controlEndpoint;                 // inproc 控制通道：[命令 R/C/A][msg_id][请求正文/分块序号]，空帧为停止
+    std::unique_ptr<zmq::socket_t> m_controlSocket; // PUSH 端，受 m_submitMutex 保护
+    QMutex m_submitMutex;
+    QMutex m_pendingMutex;
+    QHash<QString, PendingRequest> m_pending;
+    std::atomic<bool> m_running;
 };
 
-// ZeroMQ 接收线程
+// ZeroMQ 接收线程（SUB socket 与 inproc 控制通道一起 poll，无消息时不唤醒）
 class ZmqReceiveThread : public QThread
 {
     Q_OBJECT
 
 public:
-    explicit ZmqReceiveThread(const QString& endpoint, QObject *parent = nullptr);
+    ZmqReceiveThread(zmq::context_t* context, const QString& endpoint, TrafficRecorder* recorder,
+                     QObject *parent = nullptr);
     ~ZmqReceiveThread();
     
+    // 以下方法可在任意线程调用，命令经控制通道交给接收线程执行
     void stop();
     void subscribe(const QString& topic);
+    void unsubscribe(const QString& topic);
 
 signals:
-    void messageReceived(const QString& message);
+    void messageReceived(const QString& topic, ZmqMessagePtr message);
 
 protected:
     void run() override;
 
 private:
+    void sendCommand(char command, const QString& topic);
+    bool handleCommands(zmq::socket_t& control, zmq::socket_t& sub, QSet<QString>& topics);
+
+private:
+    zmq::context_t* m_context;
     QString m_endpoint;
-    std::unique_ptr<zmq::context_t> m_context;
-    std::unique_ptr<zmq::socket_t> m_subSocket;
-    bool m_running;
-    QStringList m_topics;
+    TrafficRecorder* m_recorder;
+    std::string m_controlEndpoint;                 // inproc 控制通道
+    std::unique_ptr<zmq::socket_t> m_controlSocket; // PUSH 端，受 m_controlMutex 保护
+    QMutex m_controlMutex;
+    std::atomic<bool> m_running;
 };
 
 #endif // ZMQCLIENT_H
@@ -5,7 +5,13 @@
 #include "auth/LoginDialog.h"
 #include "core/Application.h"
 #include "core/Logger.h"
+#include "core/Tracing.h"
 #include "ui/tasks/TasksView.h"
+#include "ui/diagnostics/NetworkDiagnosticsPanel.h"
+#include "ui/log/LogPanel.h"
+#include "import/CsvImporter.h"
+#include "import/XlsxReader.h"
+#include "network/ColumnarFile.h"
 #include <QMessageBox>
 #include <QToolButton>
 #include <QVBoxLayout>
@@ -19,6 +25,144 @@
 #include <QMdiSubWindow>
 #include <QUuid>
 #include <QJsonObject>
+#include <QJsonArray>
+#include <QPointer>
+#include <QDir>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+namespace {
+
+// 后端还没有写入流水的接口：导入只保存原始文件并在本地解析，结果作为预览显示，不写入任务数据
+const char* const kImportPreviewTip = "保存原始文件并解析预览（解析结果暂不写入任务数据）";
+
+struct ImportOutcome {
+    bool ok = false;
+    QString message;
+};
+
+QString describeColumns(const QStringList& names, const QVector<ImportColumn::Type>& types)
+{
+    QStringList columns;
+    for (qsizetype i = 0; i < names.size() && i < types.size(); ++i) {
+        columns << QString("%1:%2").arg(names[i], ImportColumn::typeName(types[i]));
+    }
+    return columns.join(", ");
+}
+
+// 后台线程：文件不在 original_files/ 下时先复制进去（保留原始文件），再并行解析为列批次
+// 批次只用于进度与解析预览（行数、列类型），解析后即丢弃
+void importStatement(QPromise<ImportOutcome>& promise, const QString& source, const QString& originalDir)
+{
+    const QFileInfo sourceInfo(source);
+    QString target = source;
+    if (sourceInfo.absolutePath() != QDir(originalDir).absolutePath()) {
+        target = QDir(originalDir).filePath(sourceInfo.fileName());
+        if (QFile::exists(target)) {
+            target = QDir(originalDir).filePath(QString("%1-%2.%3").arg(sourceInfo.completeBaseName(),
+                QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"), sourceInfo.suffix()));
+        }
+        if (!QFile::copy(source, target)) {
+            promise.addResult(ImportOutcome{false, QString("无法复制到 %1").arg(target)});
+            return;
+        }
+    }
+
+    // 进度按已读取的字节数估算（XLSX 为已解压的压缩数据量）
+    const qint64 total = qMax<qint64>(QFileInfo(target).size(), 1);
+    promise.setProgressRange(0, 100);
+    const ImportBatchHandler onBatch = [&promise, total](const ImportBatch& batch) {
+        promise.setProgressValue(int(qMin<qint64>(batch.sourceEnd * 100 / total, 100)));
+        return !promise.isCanceled();
+    };
+
+    if (QFileInfo(target).suffix().compare("xlsx", Qt::CaseInsensitive) == 0) {
+        XlsxReader reader;
+        if (!reader.import(target, onBatch)) {
+            promise.addResult(ImportOutcome{false, reader.errorString()});
+            return;
+        }
+        const XlsxReader::Stats& stats = reader.stats();
+        QStringList sheets;
+        for (const XlsxReader::Sheet& sheet : reader.sheets()) {
+            sheets << QString("%1 %2 行 [%3]").arg(sheet.name).arg(sheet.rows)
+                          .arg(describeColumns(sheet.columnNames, sheet.columnTypes));
+        }
+        promise.addResult(ImportOutcome{true, QString("%1（%2 行，%3 个工作表，%4 行/秒）%5")
+            .arg(QFileInfo(target).fileName())
+            .arg(stats.rows)
+            .arg(sheets.size())
+            .arg(stats.rows / (qMax<qint64>(stats.elapsedMs, 1) / 1000.0), 0, 'f', 0)
+            .arg(sheets.join("; "))});
+        return;
+    }
+
+    CsvImporter importer;
+    if (!importer.import(target, onBatch)) {
+        promise.addResult(ImportOutcome{false, importer.errorString()});
+        return;
+    }
+    const CsvImporter::Stats& stats = importer.stats();
+    promise.addResult(ImportOutcome{true, QString("%1（%2 行，%3，%4 MB/s）列: %5")
+        .arg(QFileInfo(target).fileName())
+        .arg(stats.rows)
+        .arg(CsvImporter::encodingName(stats.encoding))
+        .arg(stats.bytes / 1048576.0 / (qMax<qint64>(stats.elapsedMs, 1) / 1000.0), 0, 'f', 0)
+        .arg(describeColumns(importer.columnNames(), importer.columnTypes()))});
+}
+
+struct StoreOutcome {
+    TransactionStorePtr store;
+    QString message;
+};
+
+// 后台线程：data.query 的结果（批量通道的列式文件，或按行的 JSON 分块）转换为列式存储
+StoreOutcome buildTransactionStore(const QJsonObject& response)
+{
+    if (response["status"].toString() != "success") {
+        return StoreOutcome{nullptr, response["message"].toString()};
+    }
+    const QJsonObject data = response["data"].toObject();
+    const QJsonObject bulk = data["bulk"].toObject();
+    const QJsonArray chunks = data["chunks"].toArray();
+
+    // 请求不限行数，结果被截断说明后端施加了上限；不完整的明细不能用于分析
+    const QJsonObject summary = !bulk.isEmpty() ? data : chunks.isEmpty() ? QJsonObject() : chunks.last().toObject();
+    if (summary["truncated"].toBool()) {
+        if (!bulk.isEmpty()) {
+            QFile::remove(bulk["path"].toString());
+        }
+        return StoreOutcome{nullptr, QString("Result truncated by the backend (%1 rows in total)")
+            .arg(summary["total"].toInteger())};
+    }
+
+    auto store = std::make_shared<TransactionStore>();
+    bool ok = false;
+    if (!bulk.isEmpty()) {
+        ColumnarFile file;
+        file.setAutoRemove(true);
+        if (!file.open(bulk["path"].toString())) {
+            return StoreOutcome{nullptr, file.errorString()};
+        }
+        ok = store->loadColumnar(file);
+    } else {
+        QJsonArray rows;
+        for (const QJsonValue& chunk : chunks) {
+            for (const QJsonValue& row : chunk.toObject()["rows"].toArray()) {
+                rows.append(row);
+            }
+        }
+        ok = store->loadRows(rows);
+    }
+    if (!ok) {
+        return StoreOutcome{nullptr, store->errorString()};
+    }
+    return StoreOutcome{store, QString()};
+}
+
+} // namespace
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -32,9 +176,11 @@ MainWindow::MainWindow(QWidget *parent)
     , m_rightDock(nullptr)
     , m_newTaskDock(nullptr)
     , m_taskTree(nullptr)
-    , m_logList(nullptr)
+    , m_logPanel(nullptr)
     , m_leftToggleBtn(nullptr)
     , m_rightToggleBtn(nullptr)
+    , m_diagnosticsDock(nullptr)
+    , m_diagnosticsPanel(nullptr)
     , m_zmqClient(nullptr)
     , m_authManager(nullptr)
     , m_tasksView(nullptr)
@@ -51,6 +197,10 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    if (Tracing::isEnabled()) {
+        Tracing::exportChromeTrace(QString("%1/traces/trace-%2.json")
+            .arg(Application::instance()->getStoragePath(), QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss")));
+    }
 }
 
 
@@ -65,8 +215,10 @@ void MainWindow::setupUi()
     setupRibbonMinimal();
     setupLeftPanel();
     setupRightPanel();
+    setupDiagnosticsPanel();
     if (m_leftDock) m_leftDock->hide();
     if (m_rightDock) m_rightDock->hide();
+    if (m_diagnosticsDock) m_diagnosticsDock->hide();
     setupCentralWidget();
     setupStatusBar();
 }
@@ -158,15 +310,26 @@ void MainWindow::setupRibbon()
     if (viewGroup) {
         QToolButton* btnShowLeftPanel = viewGroup->addLargeButton("任务面板", QIcon());
         QToolButton* btnShowRightPanel = viewGroup->addLargeButton("日志面板", QIcon());
+        QToolButton* btnShowDiagnostics = viewGroup->addLargeButton("网络诊断", QIcon());
+        
+        if (btnShowDiagnostics) {
+            connect(btnShowDiagnostics, &QToolButton::clicked, this, [this]() {
+                if (m_diagnosticsDock) {
+                    m_diagnosticsDock->setVisible(!m_diagnosticsDock->isVisible());
+                    if (m_diagnosticsDock->isVisible()) {
+                        m_diagnosticsDock->raise();
+                    }
+                }
+            });
+        }
         
         if (btnShowLeftPanel) {
             connect(btnShowLeftPanel, &QToolButton::clicked, this, [this]() {
                 if (m_leftDock) {
                     m_leftDock->setVisible(!m_leftDock->isVisible());
-                    if (m_leftDock->isVisible() && m_logList) {
-                        m_logList->addItem("▶ " + QDateTime::currentDateTime().toString("hh:mm:ss") + 
-                                          " - 左侧面板已显示");
-                        m_logList->scrollToBottom();
+                    if (m_leftDock->isVisible() && m_logPanel) {
+                        m_logPanel->append("▶ " + QDateTime::currentDateTime().toString("hh:mm:ss") + 
+                                           " - 左侧面板已显示");
                     }
                 }
             });
@@ -176,10 +339,9 @@ void MainWindow::setupRibbon()
             connect(btnShowRightPanel, &QToolButton::clicked, this, [this]() {
                 if (m_rightDock) {
                     m_rightDock->setVisible(!m_rightDock->isVisible());
-                    if (m_rightDock->isVisible() && m_logList) {
-                        m_logList->addItem("▶ " + QDateTime::currentDateTime().toString("hh:mm:ss") + 
-                                          " - 右侧面板已显示");
-                        m_logList->scrollToBottom();
+                    if (m_rightDock->isVisible() && m_logPanel) {
+                        m_logPanel->append("▶ " + QDateTime::currentDateTime().toString("hh:mm:ss") + 
+                                           " - 右侧面板已显示");
                     }
                 }
             });
@@ -396,38 +558,26 @@ void MainWindow::setupRightPanel()
     
     rightLayout->addWidget(rightToolBar);
     
-    // 创建日志列表
-    m_logList = new QListWidget(rightWidget);
-    m_logList->setStyleSheet(R"(
-        QListWidget {
-            border: 1px solid #d0d0d0;
-            background: white;
-            font-size: 9pt;
-            font-family: 'Consolas', 'Courier New', monospace;
-            border-radius: 3px;
-        }
-        QListWidget::item {
-            padding: 5px;
-            border-bottom: 1px solid #f0f0f0;
-        }
-        QListWidget::item:selected {
-            background: #0078d4;
-            color: white;
-        }
-    )");
+    // 创建日志面板（环形缓冲区，超过容量后丢弃最旧的条目）
+    const int logCapacity = Application::instance()->getConfigValue("ui/log_panel_capacity", "1000000").toInt();
+    m_logPanel = new LogPanel(logCapacity, rightWidget);
+    
+    // 应用日志按刷新周期批量进入面板
+    connect(Logger::instance(), &Logger::logBatchReady, m_logPanel, &LogPanel::appendBatch);
+    Logger::instance()->enableBatchDelivery();
     
     // 添加示例日志
-    m_logList->addItem("✅ 系统启动成功");
-    m_logList->addItem("🔌 等待连接后端服务...");
-    m_logList->addItem("ℹ️ 就绪，等待操作...");
+    m_logPanel->append("✅ 系统启动成功");
+    m_logPanel->append("🔌 等待连接后端服务...");
+    m_logPanel->append("ℹ️ 就绪，等待操作...");
     
     // 连接清空按钮
     connect(clearBtn, &QToolButton::clicked, this, [this]() {
-        m_logList->clear();
-        m_logList->addItem("🗑 " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 日志已清空");
+        m_logPanel->clear();
+        m_logPanel->append("🗑 " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 日志已清空");
     });
     
-    rightLayout->addWidget(m_logList);
+    rightLayout->addWidget(m_logPanel);
     
     rightWidget->setLayout(rightLayout);
     m_rightDock->setWidget(rightWidget);
@@ -442,6 +592,22 @@ void MainWindow::setupRightPanel()
     });
 }
 
+void MainWindow::setupDiagnosticsPanel()
+{
+    // 与日志面板叠放在同一停靠区，以标签页切换
+    m_diagnosticsDock = new QDockWidget("网络诊断", this);
+    m_diagnosticsDock->setAllowedAreas(Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea | Qt::BottomDockWidgetArea);
+    m_diagnosticsDock->setFeatures(QDockWidget::DockWidgetClosable | 
+                                   QDockWidget::DockWidgetMovable | 
+                                   QDockWidget::DockWidgetFloatable);
+    m_diagnosticsDock->setMinimumWidth(250);
+    
+    m_diagnosticsPanel = new NetworkDiagnosticsPanel(m_diagnosticsDock);
+    m_diagnosticsDock->setWidget(m_diagnosticsPanel);
+    addDockWidget(Qt::RightDockWidgetArea, m_diagnosticsDock);
+    tabifyDockWidget(m_rightDock, m_diagnosticsDock);
+}
+
 void MainWindow::setupStatusBar()
 {
     m_statusBar = statusBar();
@@ -472,6 +638,15 @@ void MainWindow::setupConnections()
             this, &MainWindow::onZmqError);
     connect(m_zmqClient, &ZmqClient::notificationReceived,
             this, &MainWindow::onNotificationReceived);
+    connect(m_zmqClient, &ZmqClient::cacheInvalidated,
+            this, &MainWindow::dropTransactionStores);
+    
+    // 全局通知始终订阅（只订阅一次，重连后由客户端自动恢复订阅）；任务通知在打开任务工作区时订阅
+    m_zmqClient->subscribe(ZmqClient::globalTopic());
+    
+    if (m_diagnosticsPanel) {
+        m_diagnosticsPanel->setClient(m_zmqClient);
+    }
     
     // 连接认证信号
     connect(m_authManager, &AuthManager::loginSuccess,
@@ -487,18 +662,48 @@ bool MainWindow::connectToBackend()
     QString host = app->getConfigValue("backend/host", "localhost");
     int reqPort = app->getConfigValue("backend/req_port", "5555").toInt();
     int pubPort = app->getConfigValue("backend/pub_port", "5556").toInt();
+    int bulkPort = app->getConfigValue("backend/bulk_port", "5557").toInt();
     
     QString reqEndpoint = QString("tcp://%1:%2").arg(host).arg(reqPort);
     QString subEndpoint = QString("tcp://%1:%2").arg(host).arg(pubPort);
+    QString bulkEndpoint = QString("tcp://%1:%2").arg(host).arg(bulkPort);
     
     Logger::instance()->info("Connecting to backend: " + reqEndpoint);
     
-    bool success = m_zmqClient->connectToServer(reqEndpoint, subEndpoint);
+    // 只读请求缓存：TTL 兜底，写操作的响应或后端 cache.invalidate 通知到达时立即失效
+    // data.query 只缓存按行返回的结果（批量通道的列式文件不缓存，由 m_retainedStores 复用）
+    ResponseCache* cache = m_zmqClient->responseCache();
+    cache->setMaxBytes(app->getConfigValue("cache/max_mb", "32").toLongLong() * 1024 * 1024);
+    cache->setTtl("task.list", app->getConfigValue("cache/ttl_task_list_ms", "60000").toInt());
+    cache->setTtl("data.query", app->getConfigValue("cache/ttl_data_query_ms", "300000").toInt());
+    
+    // 大消息压缩：算法 zstd / lz4 / zlib / none，超过阈值（字节）的消息才压缩
+    Compression::Algorithm compression = Compression::algorithmFromName(
+        app->getConfigValue("network/compression", "zstd"), Compression::Zlib);
+    m_zmqClient->setCompression(compression,
+                                app->getConfigValue("network/compression_level", "3").toInt(),
+                                app->getConfigValue("network/compression_threshold", "4096").toInt());
+    
+    // 导入、查询等耗时动作走 Bulk 通道，由后端独立的 worker 处理
+    const QStringList bulkActions = app->getConfigValue("network/bulk_actions", "data.import,data.query,data.export,report.generate")
+                                        .split(',', Qt::SkipEmptyParts);
+    for (const QString& action : bulkActions) {
+        m_zmqClient->setLane(action.trimmed(), ZmqClient::Bulk);
+    }
     
-    if (success) {
-        m_zmqClient->subscribe("");  // 订阅所有消息
+    // 同机批量结果通过存储目录下的列式文件传递
+    m_zmqClient->setBulkDirectory(app->getStoragePath() + "/bulk");
+    
+    // 流量录制（性能回归用）：每次运行写一个日志文件，用 traffic_replay 重放
+    // 端到端追踪：退出时导出到存储目录 traces/，用 chrome://tracing 或 Perfetto 打开
+    Tracing::setEnabled(app->getConfigValue("debug/tracing", "false") == "true");
+    
+    if (app->getConfigValue("debug/record_traffic", "false") == "true") {
+        m_zmqClient->trafficRecorder()->start(QString("%1/traffic/session-%2.fatrc")
+            .arg(app->getStoragePath(), QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss")));
     }
-    return success;
+    
+    return m_zmqClient->connectToServer(reqEndpoint, subEndpoint, bulkEndpoint);
 }
 
 void MainWindow::updateStatusBar(const QString& message)
@@ -542,10 +747,9 @@ void MainWindow::onLoginSuccess(const QString& username)
     connectToBackend();
     
     // 添加日志
-    if (m_logList) {
-        m_logList->addItem("✅ " + QDateTime::currentDateTime().toString("hh:mm:ss") + 
+    if (m_logPanel) {
+        m_logPanel->append("✅ " + QDateTime::currentDateTime().toString("hh:mm:ss") + 
                           " - 用户 " + username + " 登录成功");
-        m_logList->scrollToBottom();
     }
     
     updateStatusBar("欢迎，" + username);
@@ -579,10 +783,9 @@ void MainWindow::onLogout()
         m_authManager->logout();
         
         // 添加日志
-        if (m_logList) {
-            m_logList->addItem("🚪 " + QDateTime::currentDateTime().toString("hh:mm:ss") + 
+        if (m_logPanel) {
+            m_logPanel->append("🚪 " + QDateTime::currentDateTime().toString("hh:mm:ss") + 
                               " - 用户 " + username + " 退出登录");
-            m_logList->scrollToBottom();
         }
         
         // 重新显示登录对话框
@@ -615,10 +818,99 @@ void MainWindow::updateUserInfo()
     }
 }
 
+void MainWindow::subscribeTaskNotifications(const QString& taskId, QObject* workspace)
+{
+    // 工作区打开期间接收该任务的通知，窗口关闭（销毁）时退订
+    if (!m_zmqClient) return;
+    const QString topic = ZmqClient::taskTopic(taskId);
+    m_zmqClient->subscribe(topic);
+    connect(workspace, &QObject::destroyed, m_zmqClient, [client = m_zmqClient, topic]() {
+        client->unsubscribe(topic);
+    });
+}
+
+void MainWindow::loadTransactionStore(const QString& taskId, const QList<QMdiSubWindow*>& workspace)
+{
+    // 每个任务只加载一次：已加载（仍有子窗口持有）时直接挂到子窗口上，加载中时不重复请求
+    if (TransactionStorePtr store = transactionStore(taskId)) {
+        for (QMdiSubWindow* window : workspace) {
+            window->setProperty("transactionStore", QVariant::fromValue(store));
+        }
+        retainTransactionStore(taskId, store);
+        return;
+    }
+    if (!m_zmqClient || m_loadingStores.contains(taskId)) return;
+    m_loadingStores.insert(taskId);
+
+    QList<QPointer<QMdiSubWindow>> windows;
+    for (QMdiSubWindow* window : workspace) windows.append(window);
+
+    TraceSpan span("MainWindow::loadTransactionStore", "ui", Tracing::isEnabled() ? Tracing::newTraceId() : QString());
+    updateStatusBar("加载交易数据...");
+    // 列式文件的映射读取与字典编码在线程池中进行，完成后回到界面线程挂到子窗口上
+    m_zmqClient->requestBulk("data.query", QJsonObject{{"task_id", taskId}, {"limit", 0}}, 120000)
+        .then(QtFuture::Launch::Async, buildTransactionStore)
+        .then(this, [this, taskId, windows, traceId = span.traceId()](const StoreOutcome& outcome) {
+            TraceSpan span("MainWindow::onTransactionStoreLoaded", "ui", traceId);
+            m_loadingStores.remove(taskId);
+            const QString time = QDateTime::currentDateTime().toString("hh:mm:ss");
+            if (!outcome.store) {
+                if (m_logPanel) m_logPanel->append("❌ " + time + " - 加载任务 " + taskId + " 交易数据失败: " + outcome.message, Logger::ERROR);
+                updateStatusBar("加载交易数据失败");
+                return;
+            }
+            bool attached = false;
+            for (const QPointer<QMdiSubWindow>& window : windows) {
+                if (window) {
+                    window->setProperty("transactionStore", QVariant::fromValue(outcome.store));
+                    attached = true;
+                }
+            }
+            if (!attached) return;  // 加载期间工作区已关闭
+            m_transactionStores.insert(taskId, outcome.store);
+            retainTransactionStore(taskId, outcome.store);
+            const TransactionStore& store = *outcome.store;
+            if (m_logPanel) {
+                m_logPanel->append(QString("📊 %1 - 任务 %2 交易数据已加载: %3 笔，%4 个账户，%5 MB")
+                    .arg(time, taskId).arg(store.rowCount()).arg(store.accounts().size() - 1)
+                    .arg(store.memoryBytes() / 1048576.0, 0, 'f', 1));
+            }
+            updateStatusBar("就绪");
+        });
+}
+
+TransactionStorePtr MainWindow::transactionStore(const QString& taskId) const
+{
+    return m_transactionStores.value(taskId).lock();
+}
+
+void MainWindow::retainTransactionStore(const QString& taskId, const TransactionStorePtr& store)
+{
+    // 重新打开最近的任务时直接复用，不再请求后端；超出上限时释放最久未用的（仍打开的工作区不受影响）
+    m_retainedStores.removeIf([&taskId](const QPair<QString, TransactionStorePtr>& entry) {
+        return entry.first == taskId;
+    });
+    m_retainedStores.append(qMakePair(taskId, store));
+    const int limit = Application::instance()->getConfigValue("cache/retained_task_stores", "2").toInt();
+    while (m_retainedStores.size() > qMax(0, limit)) {
+        m_retainedStores.removeFirst();
+    }
+}
+
+void MainWindow::dropTransactionStores(const QStringList& invalidatedActions)
+{
+    // 交易数据被修改：下次打开任务时重新加载，已打开的工作区继续使用手中的存储
+    if (!invalidatedActions.isEmpty() && !invalidatedActions.contains("data.query")) {
+        return;
+    }
+    m_retainedStores.clear();
+    m_transactionStores.clear();
+}
+
 void MainWindow::openTaskManagerView()
 {
     Logger::instance()->info("Opening TasksView...");
-    if (m_logList) { m_logList->addItem("📂 " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 打开任务管理视图"); m_logList->scrollToBottom(); }
+    if (m_logPanel) { m_logPanel->append("📂 " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 打开任务管理视图"); }
     if (m_leftDock) m_leftDock->hide();
     if (m_rightDock) m_rightDock->hide();
     // 如果任务视图未创建，则创建
@@ -670,17 +962,25 @@ void MainWindow::openTaskManagerView()
                 connect(okBtn, &QPushButton::clicked, this, [this, nameEdit, commissionerEdit, summaryEdit, idEdit, timeEdit]() {
                     QString name = nameEdit->text().trimmed();
                     if (name.isEmpty()) { QMessageBox::warning(this, "提示", "请输入任务名称"); return; }
-                    // 请求后端创建任务
-                    QJsonObject params; params["task_name"] = name;
-                    QJsonObject resp = m_zmqClient ? m_zmqClient->request("task.create", params) : QJsonObject();
-                    QString taskId = resp.value("data").toObject().value("task_id").toString();
-                    if (taskId.isEmpty()) taskId = idEdit->text();
-                    TaskInfo info; info.id = taskId; info.name = name; info.createdAt = QDateTime::currentDateTime();
+                    // 一次点击为一条追踪：区间内发出的请求带上同一 trace_id
+                    TraceSpan span("MainWindow::createTask", "ui", Tracing::isEnabled() ? Tracing::newTraceId() : QString());
+                    // 表单内容先取出，响应异步到达时表单可能已被复用
+                    TaskInfo info; info.id = idEdit->text(); info.name = name; info.createdAt = QDateTime::currentDateTime();
                     info.summary = summaryEdit->text().trimmed(); info.commissioner = commissionerEdit->text().trimmed();
-                    m_tasks.prepend(info);
-                    if (m_tasksView) m_tasksView->addTaskFront(info);
-                    // 已创建任务，仍停留在任务视图，待点击进入
-                    if (m_logList) { m_logList->addItem("🆕 " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 新建任务: " + name + " (" + taskId + ")"); m_logList->scrollToBottom(); }
+                    auto onCreated = [this, info, traceId = span.traceId()](const QJsonObject& resp) {
+                        TraceSpan span("MainWindow::onTaskCreated", "ui", traceId);
+                        TaskInfo created = info;
+                        QString taskId = resp.value("data").toObject().value("task_id").toString();
+                        if (!taskId.isEmpty()) created.id = taskId;
+                        m_tasks.prepend(created);
+                        if (m_tasksView) m_tasksView->addTaskFront(created);
+                        // 已创建任务，仍停留在任务视图，待点击进入
+                        if (m_logPanel) { m_logPanel->append("🆕 " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 新建任务: " + created.name + " (" + created.id + ")"); }
+                    };
+                    // 请求后端创建任务（异步，不阻塞界面）
+                    QJsonObject params; params["task_name"] = name;
+                    if (m_zmqClient) m_zmqClient->requestAsync("task.create", params).then(this, onCreated);
+                    else onCreated(QJsonObject());
                     m_newTaskDock->hide();
                 });
             }
@@ -719,6 +1019,7 @@ void MainWindow::openTaskManagerView()
             dtitle->setStyleSheet("QLabel { font-weight: bold; font-size: 11pt; color: #0078d4; }");
             QHBoxLayout* dactions = new QHBoxLayout();
             QToolButton* btnImportFile = new QToolButton(data); btnImportFile->setText("导入文件");
+            btnImportFile->setToolTip(kImportPreviewTip);
             QToolButton* btnCleanData = new QToolButton(data); btnCleanData->setText("数据清洗");
             QToolButton* btnQueryData = new QToolButton(data); btnQueryData->setText("查询数据");
             dactions->addWidget(btnImportFile);
@@ -731,6 +1032,7 @@ void MainWindow::openTaskManagerView()
             dv->addLayout(dactions);
             data->setLayout(dv);
             QMdiSubWindow* dataWin = ensureSubWindow(QString("数据管理 - 任务 %1").arg(taskId), data);
+            if (dataWin->widget() == data) subscribeTaskNotifications(taskId, dataWin);
             // 可视分析
             QWidget* visual = new QWidget;
             QVBoxLayout* vv = new QVBoxLayout(visual);
@@ -745,9 +1047,10 @@ void MainWindow::openTaskManagerView()
             rv->addWidget(rtitle);
             report->setLayout(rv);
             QMdiSubWindow* reportWin = ensureSubWindow(QString("报告生成 - 任务 %1").arg(taskId), report);
+            loadTransactionStore(taskId, {dataWin, visualWin, reportWin});
             // 默认激活数据管理
             m_mdiArea->setActiveSubWindow(dataWin);
-            if (m_logList) { m_logList->addItem("🔍 " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 进入任务 " + taskId); m_logList->scrollToBottom(); }
+            if (m_logPanel) { m_logPanel->append("🔍 " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 进入任务 " + taskId); }
         });
         // 采集也进入任务工作区
         connect(m_tasksView, &TasksView::collectRequested, this, [this](const QString& taskId) {
@@ -780,6 +1083,7 @@ void MainWindow::openTaskManagerView()
             dtitle->setStyleSheet("QLabel { font-weight: bold; font-size: 11pt; color: #0078d4; }");
             QHBoxLayout* dactions = new QHBoxLayout();
             QToolButton* btnImportFile = new QToolButton(data); btnImportFile->setText("导入文件");
+            btnImportFile->setToolTip(kImportPreviewTip);
             QToolButton* btnCleanData = new QToolButton(data); btnCleanData->setText("数据清洗");
             QToolButton* btnQueryData = new QToolButton(data); btnQueryData->setText("查询数据");
             dactions->addWidget(btnImportFile);
@@ -792,6 +1096,7 @@ void MainWindow::openTaskManagerView()
             dv->addLayout(dactions);
             data->setLayout(dv);
             QMdiSubWindow* dataWin = ensureSubWindow(QString("数据管理 - 任务 %1").arg(taskId), data);
+            if (dataWin->widget() == data) subscribeTaskNotifications(taskId, dataWin);
             // 可视分析
             QWidget* visual = new QWidget;
             QVBoxLayout* vv = new QVBoxLayout(visual);
@@ -808,7 +1113,7 @@ void MainWindow::openTaskManagerView()
             QMdiSubWindow* reportWin = ensureSubWindow(QString("报告生成 - 任务 %1").arg(taskId), report);
             // 默认激活数据管理
             m_mdiArea->setActiveSubWindow(dataWin);
-            if (m_logList) { m_logList->addItem("📥 " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 采集任务 " + taskId); m_logList->scrollToBottom(); }
+            if (m_logPanel) { m_logPanel->append("📥 " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 采集任务 " + taskId); }
         });
     }
     // 刷新任务列表（可能为空，仅显示新建卡片）
@@ -875,7 +1180,10 @@ void MainWindow::showAdvancedTabsIfNeeded()
             QToolButton* btnImportFile = importGroup->addLargeButton("导入文件", QIcon());
             QToolButton* btnImportDB   = importGroup->addLargeButton("导入数据库", QIcon());
             QToolButton* btnImportAPI  = importGroup->addLargeButton("API接口", QIcon());
-            if (btnImportFile) connect(btnImportFile, &QToolButton::clicked, this, &MainWindow::onImportData);
+            if (btnImportFile) {
+                btnImportFile->setToolTip(kImportPreviewTip);
+                connect(btnImportFile, &QToolButton::clicked, this, &MainWindow::onImportData);
+            }
         }
         RibbonGroup* processGroup = dataTab->addGroup("数据处理");
         if (processGroup) {
@@ -954,13 +1262,23 @@ void MainWindow::showAdvancedTabsIfNeeded()
         if (viewGroup) {
             QToolButton* btnShowLeftPanel = viewGroup->addLargeButton("任务面板", QIcon());
             QToolButton* btnShowRightPanel = viewGroup->addLargeButton("日志面板", QIcon());
+            QToolButton* btnShowDiagnostics = viewGroup->addLargeButton("网络诊断", QIcon());
+            if (btnShowDiagnostics) {
+                connect(btnShowDiagnostics, &QToolButton::clicked, this, [this]() {
+                    if (m_diagnosticsDock) {
+                        m_diagnosticsDock->setVisible(!m_diagnosticsDock->isVisible());
+                        if (m_diagnosticsDock->isVisible()) {
+                            m_diagnosticsDock->raise();
+                        }
+                    }
+                });
+            }
             if (btnShowLeftPanel) {
                 connect(btnShowLeftPanel, &QToolButton::clicked, this, [this]() {
                     if (m_leftDock) {
                         m_leftDock->setVisible(!m_leftDock->isVisible());
-                        if (m_leftDock->isVisible() && m_logList) {
-                            m_logList->addItem("▶ " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 左侧面板已显示");
-                            m_logList->scrollToBottom();
+                        if (m_leftDock->isVisible() && m_logPanel) {
+                            m_logPanel->append("▶ " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 左侧面板已显示");
                         }
                     }
                 });
@@ -969,9 +1287,8 @@ void MainWindow::showAdvancedTabsIfNeeded()
                 connect(btnShowRightPanel, &QToolButton::clicked, this, [this]() {
                     if (m_rightDock) {
                         m_rightDock->setVisible(!m_rightDock->isVisible());
-                        if (m_rightDock->isVisible() && m_logList) {
-                            m_logList->addItem("▶ " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 右侧面板已显示");
-                            m_logList->scrollToBottom();
+                        if (m_rightDock->isVisible() && m_logPanel) {
+                            m_logPanel->append("▶ " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 右侧面板已显示");
                         }
                     }
                 });
@@ -1048,10 +1365,33 @@ void MainWindow::onOpenTask()
 void MainWindow::onImportData()
 {
     Logger::instance()->info("Importing data...");
-    updateStatusBar("导入数据...");
     
-    // TODO: 显示数据导入对话框
-    QMessageBox::information(this, "提示", "数据导入功能开发中...");
+    const QString originalDir = Application::instance()->getStoragePath() + "/original_files";
+    const QString path = QFileDialog::getOpenFileName(this, "导入流水文件（解析预览）", originalDir,
+                                                      "流水文件 (*.csv *.txt *.xlsx);;所有文件 (*)");
+    if (path.isEmpty()) {
+        return;
+    }
+    updateStatusBar("解析流水...");
+    
+    // 解析在后台线程进行（内部再分到所有核心），进度按已解析的文件偏移显示在状态栏
+    auto* watcher = new QFutureWatcher<ImportOutcome>(this);
+    connect(watcher, &QFutureWatcherBase::progressValueChanged, this, [this](int percent) {
+        updateStatusBar(QString("解析流水... %1%").arg(percent));
+    });
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+        const ImportOutcome outcome = watcher->future().resultCount() > 0 ? watcher->result() : ImportOutcome();
+        const QString time = QDateTime::currentDateTime().toString("hh:mm:ss");
+        if (outcome.ok) {
+            m_logPanel->append("📥 " + time + " - 已保存原始文件，解析预览（未写入任务数据）: " + outcome.message);
+            updateStatusBar("解析预览完成");
+        } else {
+            m_logPanel->append("❌ " + time + " - 导入失败: " + outcome.message, Logger::ERROR);
+            updateStatusBar("导入失败");
+        }
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(importStatement, path, originalDir));
 }
 
 
@@ -1084,10 +1424,12 @@ void MainWindow::onAnalyzeData()
     QJsonObject params;
     params["test"] = "hello";
     
-    QJsonObject response = m_zmqClient->request("test.ping", params);
-    
-    QString message = QString("服务器响应: %1").arg(response["status"].toString());
-    QMessageBox::information(this, "测试", message);
+    TraceSpan span("MainWindow::onAnalyzeData", "ui", Tracing::isEnabled() ? Tracing::newTraceId() : QString());
+    m_zmqClient->requestAsync("test.ping", params).then(this, [this, traceId = span.traceId()](const QJsonObject& response) {
+        TraceSpan span("MainWindow::onPingReply", "ui", traceId);
+        QString message = QString("服务器响应: %1").arg(response["status"].toString());
+        QMessageBox::information(this, "测试", message);
+    });
 }
 
 
@@ -1138,9 +1480,8 @@ void MainWindow::onZmqConnected()
     updateStatusBar("已连接到后端服务");
     
     // 添加日志
-    if (m_logList) {
-        m_logList->addItem("✅ " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 后端连接成功");
-        m_logList->scrollToBottom();
+    if (m_logPanel) {
+        m_logPanel->append("✅ " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 后端连接成功");
     }
 }
 
@@ -1152,9 +1493,9 @@ void MainWindow::onZmqDisconnected()
     updateStatusBar("与后端服务断开连接");
     
     // 添加日志
-    if (m_logList) {
-        m_logList->addItem("❌ " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 后端连接断开");
-        m_logList->scrollToBottom();
+    if (m_logPanel) {
+        m_logPanel->append("❌ " + QDateTime::currentDateTime().toString("hh:mm:ss") + " - 后端连接断开",
+                           Logger::WARNING);
     }
 }
 
@@ -1166,7 +1507,7 @@ void MainWindow::onZmqError(const QString& error)
 
 void MainWindow::onNotificationReceived(const QString& type, const QJsonObject& data)
 {
-    Logger::instance()->debug("Received notification: " + type);
+    LOG_DEBUG("Received notification: %1", type);
     
     if (type == "progress") {
         int current = data["current"].toInt();
@@ -1176,13 +1517,12 @@ void MainWindow::onNotificationReceived(const QString& type, const QJsonObject&
         updateStatusBar(QString("%1 (%2/%3)").arg(message).arg(current).arg(total));
         
         // 添加日志
-        if (m_logList) {
-            m_logList->addItem(QString("📈 %1 - %2 [%3/%4]")
+        if (m_logPanel) {
+            m_logPanel->append(QString("📈 %1 - %2 [%3/%4]")
                 .arg(QDateTime::currentDateTime().toString("hh:mm:ss"))
                 .arg(message)
                 .arg(current)
                 .arg(total));
-            m_logList->scrollToBottom();
         }
     }
 }
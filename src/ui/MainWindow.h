@@ -7,15 +7,19 @@
 #include <QMdiArea>
 #include <QDockWidget>
 #include <QTreeWidget>
-#include <QListWidget>
 #include <QToolButton>
 #include <QVector>
+#include <QSet>
+#include <QHash>
 #include "ui/tasks/TasksView.h"
+#include "data/TransactionStore.h"
 
 class RibbonBar;
 class ZmqClient;
 class AuthManager;
 class TasksView;
+class NetworkDiagnosticsPanel;
+class LogPanel;
 
 class MainWindow : public QMainWindow
 {
@@ -59,9 +63,16 @@ private:
     void setupConnections();
     void setupLeftPanel();     // 左侧面板
     void setupRightPanel();    // 右侧面板
+    void setupDiagnosticsPanel();  // 网络诊断面板（与日志面板叠放）
 
     void openTaskManagerView();
     void showAdvancedTabsIfNeeded();
+    void subscribeTaskNotifications(const QString& taskId, QObject* workspace);
+    // 任务交易数据加载到客户端列式存储，挂到工作区各子窗口上只读共享
+    void loadTransactionStore(const QString& taskId, const QList<QMdiSubWindow*>& workspace);
+    TransactionStorePtr transactionStore(const QString& taskId) const;
+    void retainTransactionStore(const QString& taskId, const TransactionStorePtr& store);
+    void dropTransactionStores(const QStringList& invalidatedActions);
     
     bool connectToBackend();
     void updateStatusBar(const QString& message);
@@ -80,13 +91,18 @@ private:
     QDockWidget* m_rightDock;     // 右侧停靠窗口
     QDockWidget* m_newTaskDock;   // 新建任务滑出面板
     QTreeWidget* m_taskTree;      // 导航树
-    QListWidget* m_logList;       // 日志列表
+    LogPanel* m_logPanel;         // 日志面板
     QToolButton* m_leftToggleBtn; // 左侧面板切换按钮
     QToolButton* m_rightToggleBtn;// 右侧面板切换按钮
+    QDockWidget* m_diagnosticsDock;            // 网络诊断停靠窗口
+    NetworkDiagnosticsPanel* m_diagnosticsPanel;
     
     // 任务视图
     TasksView* m_tasksView;
     QVector<TaskInfo> m_tasks;
+    QHash<QString, std::weak_ptr<const TransactionStore>> m_transactionStores;  // 由工作区子窗口持有
+    QSet<QString> m_loadingStores;
+    QList<QPair<QString, TransactionStorePtr>> m_retainedStores;  // 最近加载的存储（末尾最新），工作区关闭后仍保留
     
     // 网络和认证
     ZmqClient* m_zmqClient;
@@ -0,0 +1,145 @@
+#include "ui/diagnostics/NetworkDiagnosticsPanel.h"
+#include "network/ZmqClient.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QToolButton>
+#include <algorithm>
+
+namespace {
+
+// 表格中显示的阶段（按请求经过的顺序）
+const LatencyStats::Stage kStages[] = {
+    LatencyStats::Serialize,
+    LatencyStats::Send,
+    LatencyStats::Network,
+    LatencyStats::Handler,
+    LatencyStats::Parse,
+    LatencyStats::Wait
+};
+
+} // namespace
+
+NetworkDiagnosticsPanel::NetworkDiagnosticsPanel(QWidget* parent)
+    : QWidget(parent)
+    , m_client(nullptr)
+    , m_cacheLabel(new QLabel(this))
+    , m_table(new QTableWidget(this))
+    , m_refreshTimer(new QTimer(this))
+{
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(5, 5, 5, 5);
+    mainLayout->setSpacing(5);
+    
+    // 顶部：缓存命中率 + 重置按钮
+    QWidget* toolBar = new QWidget(this);
+    QHBoxLayout* toolLayout = new QHBoxLayout(toolBar);
+    toolLayout->setContentsMargins(0, 0, 0, 0);
+    
+    m_cacheLabel->setStyleSheet("QLabel { color: #555; font-size: 9pt; }");
+    
+    QToolButton* resetBtn = new QToolButton(toolBar);
+    resetBtn->setText("↺");
+    resetBtn->setToolTip("重置统计");
+    resetBtn->setFixedSize(24, 24);
+    connect(resetBtn, &QToolButton::clicked, this, [this]() {
+        if (m_client) {
+            m_client->latencyStats()->reset();
+            refresh();
+        }
+    });
+    
+    toolLayout->addWidget(m_cacheLabel);
+    toolLayout->addStretch();
+    toolLayout->addWidget(resetBtn);
+    mainLayout->addWidget(toolBar);
+    
+    // 每行一个动作，每个阶段一列，单元格为 p50 / p99 / max（毫秒）
+    QStringList headers{"动作", "次数"};
+    for (LatencyStats::Stage stage : kStages) {
+        headers << LatencyStats::stageName(stage);
+    }
+    m_table->setColumnCount(headers.size());
+    m_table->setHorizontalHeaderLabels(headers);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_table->verticalHeader()->hide();
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setToolTip("各阶段耗时：p50 / p99 / max（毫秒）");
+    m_table->setStyleSheet(R"(
+        QTableWidget {
+            border: 1px solid #d0d0d0;
+            background: white;
+            font-size: 9pt;
+            font-family: 'Consolas', 'Courier New', monospace;
+        }
+    )");
+    mainLayout->addWidget(m_table);
+    
+    m_refreshTimer->setInterval(1000);
+    connect(m_refreshTimer, &QTimer::timeout, this, &NetworkDiagnosticsPanel::refresh);
+}
+
+void NetworkDiagnosticsPanel::setClient(ZmqClient* client)
+{
+    m_client = client;
+    refresh();
+}
+
+void NetworkDiagnosticsPanel::refresh()
+{
+    if (!m_client) {
+        return;
+    }
+    
+    ResponseCache::Stats cache = m_client->responseCache()->stats();
+    m_cacheLabel->setText(QString("缓存命中率 %1%（%2 / %3），%4 条，%5 KB")
+                              .arg(cache.hitRate() * 100.0, 0, 'f', 1)
+                              .arg(cache.hits)
+                              .arg(cache.hits + cache.misses)
+                              .arg(cache.entries)
+                              .arg(cache.bytes / 1024));
+    
+    // 按次数降序，常用动作在前
+    QList<LatencyStats::Summary> summaries = m_client->latencyStats()->snapshot();
+    std::sort(summaries.begin(), summaries.end(), [](const auto& a, const auto& b) {
+        return a.count > b.count;
+    });
+    
+    m_table->setRowCount(int(summaries.size()));
+    for (int row = 0; row < summaries.size(); ++row) {
+        const LatencyStats::Summary& summary = summaries.at(row);
+        m_table->setItem(row, 0, new QTableWidgetItem(summary.action));
+        m_table->setItem(row, 1, new QTableWidgetItem(QString::number(summary.count)));
+        
+        int column = 2;
+        for (LatencyStats::Stage stage : kStages) {
+            m_table->setItem(row, column++, new QTableWidgetItem(
+                formatStage(summary.p50[stage], summary.p99[stage], summary.max[stage])));
+        }
+    }
+}
+
+void NetworkDiagnosticsPanel::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_refreshTimer->start();
+}
+
+void NetworkDiagnosticsPanel::hideEvent(QHideEvent* event)
+{
+    QWidget::hideEvent(event);
+    m_refreshTimer->stop();
+}
+
+QString NetworkDiagnosticsPanel::formatStage(qint64 p50, qint64 p99, qint64 max)
+{
+    if (max == 0) {
+        return "-";
+    }
+    return QString("%1 / %2 / %3")
+        .arg(p50 / 1e6, 0, 'f', 2)
+        .arg(p99 / 1e6, 0, 'f', 2)
+        .arg(max / 1e6, 0, 'f', 2);
+}
@@ -0,0 +1,38 @@
+#ifndef NETWORKDIAGNOSTICSPANEL_H
+#define NETWORKDIAGNOSTICSPANEL_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QTableWidget>
+#include <QTimer>
+
+class ZmqClient;
+
+// 网络诊断面板：按动作显示各阶段耗时（p50 / p99 / max）与响应缓存命中率
+// 面板可见时每秒刷新一次
+class NetworkDiagnosticsPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit NetworkDiagnosticsPanel(QWidget* parent = nullptr);
+
+    void setClient(ZmqClient* client);
+
+public slots:
+    void refresh();
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    static QString formatStage(qint64 p50, qint64 p99, qint64 max);
+
+private:
+    ZmqClient* m_client;
+    QLabel* m_cacheLabel;
+    QTableWidget* m_table;
+    QTimer* m_refreshTimer;
+};
+
+#endif // NETWORKDIAGNOSTICSPANEL_H
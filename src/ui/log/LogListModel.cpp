@@ -0,0 +1,203 @@
+#include "ui/log/LogListModel.h"
+#include "core/Logger.h"
+#include <QColor>
+
+namespace {
+
+// 合并更新的间隔（约一帧）
+constexpr int kFlushIntervalMs = 16;
+
+} // namespace
+
+LogListModel::LogListModel(int capacity, QObject* parent)
+    : QAbstractListModel(parent)
+    , m_capacity(qMax(capacity, 1))
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(kFlushIntervalMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &LogListModel::flushPending);
+}
+
+void LogListModel::append(const QString& text, int level)
+{
+    m_pending.append(Entry{text, level});
+
+    // 一帧内追加超过容量时立即写入，待追加队列不超过一个缓冲区
+    if (m_pending.size() >= m_capacity) {
+        flushPending();
+        return;
+    }
+
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void LogListModel::clear()
+{
+    m_flushTimer.stop();
+
+    beginResetModel();
+    m_pending.clear();
+    m_entries.clear();
+    m_firstSeq = 0;
+    m_nextSeq = 0;
+    m_visible.clear();
+    m_visibleOffset = 0;
+    endResetModel();
+}
+
+void LogListModel::flushPending()
+{
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    QVector<Entry> batch;
+    batch.swap(m_pending);
+    const quint64 batchSize = quint64(batch.size());
+
+    // 1. 淘汰最旧的条目，为新条目腾出空间
+    const quint64 stored = m_nextSeq - m_firstSeq;
+    if (stored + batchSize > quint64(m_capacity)) {
+        const quint64 newFirst = m_firstSeq + (stored + batchSize - quint64(m_capacity));
+
+        if (isFiltering()) {
+            qsizetype removed = 0;
+            while (m_visibleOffset + removed < m_visible.size() && m_visible[m_visibleOffset + removed] < newFirst) {
+                ++removed;
+            }
+            if (removed > 0) {
+                beginRemoveRows(QModelIndex(), 0, int(removed - 1));
+                m_visibleOffset += removed;
+                endRemoveRows();
+            }
+            // 已淘汰的序号累积过半时压缩
+            if (m_visibleOffset > m_visible.size() / 2) {
+                m_visible.remove(0, m_visibleOffset);
+                m_visibleOffset = 0;
+            }
+            m_firstSeq = newFirst;
+        } else {
+            beginRemoveRows(QModelIndex(), 0, int(newFirst - m_firstSeq - 1));
+            m_firstSeq = newFirst;
+            endRemoveRows();
+        }
+    }
+
+    // 2. 写入环形缓冲区；过滤时只对新条目做匹配
+    const int firstRow = rowCount();
+    QVector<quint64> matched;
+    for (Entry& entry : batch) {
+        const quint64 seq = m_nextSeq;
+        if (isFiltering() && matches(entry)) {
+            matched.append(seq);
+        }
+        if (m_entries.size() < m_capacity) {
+            m_entries.append(std::move(entry));
+        } else {
+            m_entries[qsizetype(seq % quint64(m_capacity))] = std::move(entry);
+        }
+        ++m_nextSeq;
+    }
+
+    if (isFiltering()) {
+        if (!matched.isEmpty()) {
+            beginInsertRows(QModelIndex(), firstRow, firstRow + int(matched.size()) - 1);
+            m_visible.append(matched);
+            endInsertRows();
+        }
+    } else {
+        beginInsertRows(QModelIndex(), firstRow, firstRow + int(batchSize) - 1);
+        endInsertRows();
+    }
+}
+
+void LogListModel::setFilter(const QString& text, int minLevel)
+{
+    if (text == m_filterText && minLevel == m_minLevel) {
+        return;
+    }
+    flushPending();
+
+    // 新条件是旧条件的子集（文本变长且包含原文本、级别提高）时只需在已匹配的条目中筛选
+    const bool narrowing = isFiltering()
+                           && text.contains(m_filterText, Qt::CaseInsensitive)
+                           && minLevel >= m_minLevel;
+
+    beginResetModel();
+    m_filterText = text;
+    m_matcher = QStringMatcher(text, Qt::CaseInsensitive);
+    m_minLevel = minLevel;
+    rebuildVisible(narrowing);
+    endResetModel();
+}
+
+void LogListModel::rebuildVisible(bool narrowing)
+{
+    if (!isFiltering()) {
+        m_visible.clear();
+        m_visibleOffset = 0;
+        return;
+    }
+
+    QVector<quint64> visible;
+    if (narrowing) {
+        for (qsizetype i = m_visibleOffset; i < m_visible.size(); ++i) {
+            if (matches(entryAt(m_visible[i]))) {
+                visible.append(m_visible[i]);
+            }
+        }
+    } else {
+        for (quint64 seq = m_firstSeq; seq < m_nextSeq; ++seq) {
+            if (matches(entryAt(seq))) {
+                visible.append(seq);
+            }
+        }
+    }
+    m_visible.swap(visible);
+    m_visibleOffset = 0;
+}
+
+bool LogListModel::matches(const Entry& entry) const
+{
+    if (entry.level < m_minLevel) {
+        return false;
+    }
+    return m_filterText.isEmpty() || m_matcher.indexIn(entry.text) >= 0;
+}
+
+int LogListModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return isFiltering() ? int(m_visible.size() - m_visibleOffset) : int(m_nextSeq - m_firstSeq);
+}
+
+QVariant LogListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    const quint64 seq = isFiltering() ? m_visible[m_visibleOffset + index.row()] : m_firstSeq + quint64(index.row());
+    const Entry& entry = entryAt(seq);
+
+    switch (role) {
+        case Qt::DisplayRole:
+            return entry.text;
+        case Qt::ForegroundRole:
+            if (entry.level >= Logger::ERROR) {
+                return QColor("#c42b1c");
+            }
+            if (entry.level == Logger::WARNING) {
+                return QColor("#b35c00");
+            }
+            return QVariant();
+        case LevelRole:
+            return entry.level;
+        default:
+            return QVariant();
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef LOGLISTMODEL_H
+#define LOGLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QStringMatcher>
+#include <QTimer>
+#include <QVector>
+
+// 日志面板模型：固定容量的环形缓冲区，写满后丢弃最旧的条目
+// 同一帧（16ms）内的追加合并为一次 rowsInserted / rowsRemoved；
+// 过滤只维护匹配条目的序号，新增条目只对自身做匹配，收窄过滤条件时只在已匹配的条目中筛选
+class LogListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        LevelRole = Qt::UserRole + 1
+    };
+
+    explicit LogListModel(int capacity, QObject* parent = nullptr);
+
+    void append(const QString& text, int level);
+    void clear();
+
+    // 文本为不区分大小写的子串匹配，minLevel 为 Logger::LogLevel
+    void setFilter(const QString& text, int minLevel);
+    bool isFiltering() const { return !m_filterText.isEmpty() || m_minLevel > 0; }
+
+    int capacity() const { return m_capacity; }
+    qint64 storedCount() const { return qint64(m_nextSeq - m_firstSeq); }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+private slots:
+    void flushPending();
+
+private:
+    struct Entry {
+        QString text;
+        int level = 0;
+    };
+
+    const Entry& entryAt(quint64 seq) const { return m_entries[qsizetype(seq % quint64(m_capacity))]; }
+    bool matches(const Entry& entry) const;
+    void rebuildVisible(bool narrowing);
+
+private:
+    int m_capacity;
+    QVector<Entry> m_entries;       // 未写满时按序号追加，写满后按序号取模覆盖
+    quint64 m_firstSeq = 0;         // 最旧条目的序号
+    quint64 m_nextSeq = 0;
+
+    QVector<Entry> m_pending;
+    QTimer m_flushTimer;
+
+    QString m_filterText;
+    QStringMatcher m_matcher;
+    int m_minLevel = 0;
+    QVector<quint64> m_visible;     // 过滤时匹配条目的序号，[m_visibleOffset, size) 有效
+    qsizetype m_visibleOffset = 0;
+};
+
+#endif // LOGLISTMODEL_H
@@ -0,0 +1,113 @@
+#include "ui/log/LogPanel.h"
+#include "ui/log/LogListModel.h"
+#include <QHBoxLayout>
+#include <QScrollBar>
+#include <QVBoxLayout>
+
+namespace {
+
+// 输入过滤文本后等待的时间，连续输入只重新过滤一次
+constexpr int kFilterDebounceMs = 150;
+
+} // namespace
+
+LogPanel::LogPanel(int capacity, QWidget* parent)
+    : QWidget(parent)
+    , m_model(new LogListModel(capacity, this))
+    , m_filterEdit(new QLineEdit(this))
+    , m_levelCombo(new QComboBox(this))
+    , m_view(new QListView(this))
+    , m_filterTimer(new QTimer(this))
+    , m_followTail(true)
+{
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(0, 0, 0, 0);
+    mainLayout->setSpacing(5);
+
+    // 过滤栏
+    QWidget* filterBar = new QWidget(this);
+    QHBoxLayout* filterLayout = new QHBoxLayout(filterBar);
+    filterLayout->setContentsMargins(0, 0, 0, 0);
+    filterLayout->setSpacing(5);
+
+    m_filterEdit->setPlaceholderText("过滤日志...");
+    m_filterEdit->setClearButtonEnabled(true);
+    m_levelCombo->addItem("全部", int(Logger::DEBUG));
+    m_levelCombo->addItem("信息", int(Logger::INFO));
+    m_levelCombo->addItem("警告", int(Logger::WARNING));
+    m_levelCombo->addItem("错误", int(Logger::ERROR));
+
+    filterLayout->addWidget(m_filterEdit, 1);
+    filterLayout->addWidget(m_levelCombo);
+    mainLayout->addWidget(filterBar);
+
+    // 所有行等高，视图不必逐行测量，百万行时滚动与插入仍为常数开销
+    m_view->setModel(m_model);
+    m_view->setUniformItemSizes(true);
+    m_view->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_view->setStyleSheet(R"(
+        QListView {
+            border: 1px solid #d0d0d0;
+            background: white;
+            font-size: 9pt;
+            font-family: 'Consolas', 'Courier New', monospace;
+            border-radius: 3px;
+        }
+        QListView::item {
+            padding: 5px;
+            border-bottom: 1px solid #f0f0f0;
+        }
+        QListView::item:selected {
+            background: #0078d4;
+            color: white;
+        }
+    )");
+    mainLayout->addWidget(m_view);
+
+    // 停在底部时跟随新日志：范围变化（新增行）后若之前在底部则滚到底部
+    QScrollBar* scrollBar = m_view->verticalScrollBar();
+    connect(scrollBar, &QScrollBar::valueChanged, this, [this, scrollBar](int value) {
+        m_followTail = value == scrollBar->maximum();
+    });
+    connect(scrollBar, &QScrollBar::rangeChanged, this, [this, scrollBar](int, int max) {
+        if (m_followTail) {
+            scrollBar->setValue(max);
+        }
+    });
+
+    m_filterTimer->setSingleShot(true);
+    m_filterTimer->setInterval(kFilterDebounceMs);
+    connect(m_filterTimer, &QTimer::timeout, this, &LogPanel::applyFilter);
+    connect(m_filterEdit, &QLineEdit::textChanged, m_filterTimer, qOverload<>(&QTimer::start));
+    connect(m_levelCombo, &QComboBox::currentIndexChanged, this, &LogPanel::applyFilter);
+}
+
+void LogPanel::append(const QString& text, int level)
+{
+    m_model->append(text, level);
+}
+
+void LogPanel::appendBatch(const QVector<Logger::LogLine>& lines, int dropped)
+{
+    for (const Logger::LogLine& line : lines) {
+        m_model->append(line.text, line.level);
+    }
+    if (dropped > 0) {
+        m_model->append(QString("⚠ 日志过多，界面已省略 %1 条（完整内容见日志文件）").arg(dropped), Logger::WARNING);
+    }
+}
+
+void LogPanel::clear()
+{
+    m_model->clear();
+    m_followTail = true;
+}
+
+void LogPanel::applyFilter()
+{
+    m_filterTimer->stop();
+    m_model->setFilter(m_filterEdit->text(), m_levelCombo->currentData().toInt());
+    m_followTail = true;
+    m_view->scrollToBottom();
+}
@@ -0,0 +1,42 @@
+#ifndef LOGPANEL_H
+#define LOGPANEL_H
+
+#include <QWidget>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QListView>
+#include <QTimer>
+#include "core/Logger.h"
+
+class LogListModel;
+
+// 日志面板：过滤栏（文本 + 最低级别）+ 虚拟化列表
+// 列表停在底部时随新日志自动滚动，用户向上翻看时保持位置
+class LogPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit LogPanel(int capacity, QWidget* parent = nullptr);
+
+    void append(const QString& text, int level = Logger::INFO);
+    void clear();
+
+    LogListModel* model() const { return m_model; }
+
+public slots:
+    // 接收 Logger::logBatchReady；被丢弃的记录汇总为一行
+    void appendBatch(const QVector<Logger::LogLine>& lines, int dropped);
+
+private slots:
+    void applyFilter();
+
+private:
+    LogListModel* m_model;
+    QLineEdit* m_filterEdit;
+    QComboBox* m_levelCombo;
+    QListView* m_view;
+    QTimer* m_filterTimer;
+    bool m_followTail;
+};
+
+#endif // LOGPANEL_H